@@ -25,6 +25,8 @@
 #include "../bnVirusBackground.h"
 #include "../bnFadeInState.h"
 #include "../bnRandom.h"
+#include "../bnFrameArena.h"
+#include "../bnBattlePreloader.h"
 
 // Combos are counted if more than one enemy is hit within x frames
 // The game is clocked to display 60 frames per second
@@ -166,12 +168,19 @@ BattleSceneBase::BattleSceneBase(ActivityController& controller, BattleSceneBase
   setView(sf::Vector2u(480, 320));
 
   // add the camera to our event bus
-  channel.Register(&camera);
+  cameraSubscription = channel.Subscribe(&camera);
+
+  cacheStatsAtStart = BattlePreloader::CacheStats();
 }
 
 BattleSceneBase::~BattleSceneBase() {
-  // drop the camera from our event bus
-  channel.Drop(&camera);
+  ResourceCacheStats cacheStats = BattlePreloader::CacheStats();
+  Logger::Logf(
+    LogLevel::info,
+    "Battle resource cache: %u hits, %u misses",
+    (unsigned)(cacheStats.hits - cacheStatsAtStart.hits),
+    (unsigned)(cacheStats.misses - cacheStatsAtStart.misses)
+  );
 
   for (auto&& elem : states) {
     delete elem;
@@ -701,7 +710,7 @@ void BattleSceneBase::onUpdate(double elapsed) {
     Audio().Play(AudioType::CUSTOM_BAR_FULL);
   }
 
-  std::vector<std::shared_ptr<Component>> componentsCopy = components;
+  FrameVector<std::shared_ptr<Component>> componentsCopy(components.begin(), components.end());
 
   // Update components
   for (std::shared_ptr<Component>& c : componentsCopy) {
@@ -838,55 +847,47 @@ void BattleSceneBase::onDraw(sf::RenderTexture& surface) {
 
   surface.draw(*background);
 
-  auto uis = std::vector<std::shared_ptr<UIComponent>>();
+  FrameVector<Battle::Tile*> allTiles;
+  allTiles.reserve(static_cast<size_t>(field->GetWidth() + 2) * (field->GetHeight() + 2));
+
+  for (int y = 0; y < field->GetHeight() + 2; y++) {
+    for (int x = 0; x < field->GetWidth() + 2; x++) {
+      allTiles.push_back(field->GetAt(x, y));
+    }
+  }
 
-  std::vector<Battle::Tile*> allTiles = field->FindTiles([](Battle::Tile* tile) { return true; });
   sf::Vector2f viewOffset = getController().CameraViewOffset(camera);
 
+  bool isCleared = (redTeamMob && redTeamMob->IsCleared()) || (blueTeamMob && blueTeamMob->IsCleared());
+  const sf::Color tileColor(tint, tint, tint, 255);
+
   for (Battle::Tile* tile : allTiles) {
     if (tile->IsEdgeTile()) continue;
 
     bool yellowBlock = false;
+    const sf::Shader* tileShader = nullptr;
 
-    bool isCleared = (redTeamMob && redTeamMob->IsCleared()) || (blueTeamMob && blueTeamMob->IsCleared());
     if (tile->IsHighlighted() && !isCleared) {
       if (!yellowShader) {
         yellowBlock = true;
       }
       else {
-        tile->SetShader(yellowShader);
+        tileShader = yellowShader;
       }
     }
-    else {
-      tile->RevokeShader();
-      tile->setColor(sf::Color::White);
-    }
 
-    sf::Vector2f flipOffset = PerspectiveOffset(tile->getPosition());
-    tile->PerspectiveFlip(perspectiveFlip);
-    tile->move(viewOffset + flipOffset);
-    tile->setColor(sf::Color(tint, tint, tint, 255));
-    surface.draw(*tile);
-    tile->setColor(sf::Color::White);
-
-    if (yellowBlock) {
-      sf::RectangleShape block;
-      block.setSize({40, 30});
-      block.setScale(2.f, 2.f);
-      block.setOrigin(20, 15);
-      block.setFillColor(sf::Color::Yellow);
-      block.setPosition(tile->getPosition());
-      surface.draw(block);
-    }
-
-    tile->move(-(viewOffset+flipOffset));
-    tile->PerspectiveFlip(false);
+    tileMesh.Submit(*tile, PerspectiveOffset(tile->getPosition()), tileColor, tileShader, perspectiveFlip, yellowBlock);
   }
 
-  std::vector<Entity*> allEntities;
+  sf::RenderStates tileStates;
+  tileStates.transform.translate(viewOffset);
+  tileMesh.Draw(surface, tileStates);
+
+  FrameVector<Entity*> allEntities;
+  FrameVector<Entity*> tileEntities;
 
   for (Battle::Tile* tile : allTiles) {
-    std::vector<Entity*> tileEntities;
+    tileEntities.clear();
     tile->FindEntities([&tileEntities, &allEntities](std::shared_ptr<Entity>& ent) {
       tileEntities.push_back(ent.get());
       allEntities.push_back(ent.get());
@@ -895,10 +896,12 @@ void BattleSceneBase::onDraw(sf::RenderTexture& surface) {
 
     std::sort(tileEntities.begin(), tileEntities.end(), [](Entity* A, Entity* B) { return A->GetLayer() > B->GetLayer(); });
 
+    // Entities apply their own uniforms while drawing so they are not batched
     for (Entity* node : tileEntities) {
       sf::Vector2f offset = viewOffset + sf::Vector2f(0, -node->GetElevation());
       sf::Vector2f flipOffset = PerspectiveOffset(node->getPosition());
-      node->move(offset+flipOffset);
+      sf::RenderStates entityStates;
+      entityStates.transform.translate(offset + flipOffset);
 
       sf::Vector2f ogScale = node->getScale();
 
@@ -907,29 +910,37 @@ void BattleSceneBase::onDraw(sf::RenderTexture& surface) {
       }
 
       node->ShiftShadow();
-      surface.draw(*node);
+      surface.draw(*node, entityStates);
 
       if (perspectiveFlip) {
         node->setScale(ogScale.x, ogScale.y);
       }
-
-      node->move(-(offset+flipOffset));
     }
   }
 
-  std::vector<Character*> allCharacters;
+  // particles are mirrored across the field the same way entities are
+  sf::RenderStates particleStates;
+  particleStates.transform.translate(viewOffset);
+
+  if (perspectiveFlip) {
+    particleStates.transform.translate(480.f, 0.f);
+    particleStates.transform.scale(-1.f, 1.f);
+  }
+
+  field->GetParticles().Draw(surface, particleStates);
+
+  FrameVector<Character*> allCharacters;
 
   // draw ui on top
   for (Entity* ent : allEntities) {
-    std::vector<std::shared_ptr<UIComponent>> uis = ent->GetComponentsDerivedFrom<UIComponent>();
     sf::Vector2f flipOffset = PerspectiveOffset(ent->getPosition());
-    for (std::shared_ptr<UIComponent>& ui : uis) {
+    ent->ForEachComponentDerivedFrom<UIComponent>([&](const std::shared_ptr<UIComponent>& ui) {
       if (ui->DrawOnUIPass()) {
         ui->move(viewOffset + flipOffset);
         surface.draw(*ui);
         ui->move(-(viewOffset + flipOffset));
       }
-    }
+    });
 
     // collect characters while drawing ui
     if (Character* character = dynamic_cast<Character*>(ent)) {
@@ -957,6 +968,16 @@ void BattleSceneBase::onDraw(sf::RenderTexture& surface) {
 
 void BattleSceneBase::onEnd()
 {
+  const EntityPool::Stats poolStats = field->GetPoolStats();
+  Logger::Logf(
+    LogLevel::debug,
+    "Entity pool: %u created, %u reused, %u released, %u idle",
+    (unsigned)poolStats.created,
+    (unsigned)poolStats.reused,
+    (unsigned)poolStats.released,
+    (unsigned)poolStats.available
+  );
+
   if (onEndCallback) {
     onEndCallback(battleResults);
   }
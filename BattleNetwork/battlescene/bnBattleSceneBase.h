@@ -28,6 +28,8 @@
 #include "../bnPlayerEmotionUI.h"
 #include "../bnBattleResults.h"
 #include "../bnEventBus.h"
+#include "../bnTileGridMesh.h"
+#include "../bnResourceCache.h"
 
 // Battle scene specific classes
 #include "bnBattleSceneState.h"
@@ -111,6 +113,7 @@ private:
   std::shared_ptr<PlayerSelectedCardsUI> cardUI{ nullptr }; /*!< Player's Card UI implementation */
   std::shared_ptr<PlayerEmotionUI> emotionUI{ nullptr }; /*!< Player's Emotion Window */
   Camera camera; /*!< Camera object - will shake screen */
+  TileGridMesh tileMesh; /*!< Baked geometry of the field's tiles */
   sf::Sprite mobEdgeSprite, mobBackdropSprite; /*!< name backdrop images*/
   PA& programAdvance; /*!< PA object loads PA database and returns matching PA card from input */
   std::shared_ptr<Field> field{ nullptr }; /*!< Supplied by mob info: the grid to battle on */
@@ -167,6 +170,8 @@ private:
 
   // event bus
   EventBus::Channel channel;
+  EventBus::Subscription cameraSubscription; /*!< Receives camera events on this scene's channel until the scene is destroyed */
+  ResourceCacheStats cacheStatsAtStart; /*!< Resource cache counters when the scene was created. Misses after this are stalls the preload did not cover */
 
   sf::Vector2f PerspectiveOffset(const sf::Vector2f& pos);
   sf::Vector2f PerspectiveOrigin(const sf::Vector2f& origin, const sf::FloatRect& size);
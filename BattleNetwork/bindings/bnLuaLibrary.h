@@ -3,12 +3,14 @@
 
 #include <sol/sol.hpp>
 
+struct ScriptPackage;
+
 class LuaLibrary
 {
-    sol::state& script;
+    ScriptPackage& script;
 
     public:
-    LuaLibrary( sol::state& script );
+    LuaLibrary( ScriptPackage& script );
 };
 
 #endif
\ No newline at end of file
@@ -19,6 +19,18 @@ void ScriptedArtifact::Init()
 
 ScriptedArtifact::~ScriptedArtifact() { }
 
+void ScriptedArtifact::OnPoolReset()
+{
+  // drop everything the previous script attached
+  update_func = on_spawn_func = delete_func = sol::object();
+  can_move_to_func = battle_start_func = battle_end_func = sol::object();
+  entries.clear();
+
+  SetLayer(0);
+  setScale(2.f, 2.f);
+  scriptedOffset = {};
+}
+
 void ScriptedArtifact::OnUpdate(double _elapsed)
 {
   if (update_func.valid()) 
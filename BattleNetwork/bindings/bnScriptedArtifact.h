@@ -23,6 +23,7 @@ public:
 	~ScriptedArtifact();
 
 	void Init() override;
+	void OnPoolReset() override;
 
 	/**
 	 * Centers the animation on the tile, offsets it by its internal offsets, then invokes the function assigned to onUpdate if present.
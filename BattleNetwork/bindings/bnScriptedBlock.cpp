@@ -1,6 +1,6 @@
 #include "bnScriptedBlock.h"
 
-ScriptedBlock::ScriptedBlock(sol::state& script):
+ScriptedBlock::ScriptedBlock(ScriptPackage& script):
   script(script)
 {
 }
@@ -2,11 +2,13 @@
 #include "../bnPlayerCustScene.h"
 #include "../bnPlayer.h"
 
+struct ScriptPackage;
+
 class ScriptedBlock : public PlayerCustScene::Piece {
-  sol::state& script;
+  ScriptPackage& script;
 
 public:
-  ScriptedBlock(sol::state& script);
+  ScriptedBlock(ScriptPackage& script);
   ~ScriptedBlock();
   void run(Player* player);
   std::function<void(Player*)> run_func;
@@ -8,17 +8,20 @@
 #include "../bnSolHelpers.h"
 #include "../bnCardPackageManager.h"
 class CardImpl;
+struct ScriptPackage;
 
 class ScriptedCard : public CardImpl {
-  sol::state& script;
+  ScriptPackage& script;
 
 public:
-  ScriptedCard(sol::state& script) : script(script) {
+  ScriptedCard(ScriptPackage& script) : script(script) {
 
   }
 
   std::shared_ptr<CardAction> BuildCardAction(std::shared_ptr<Character> user, const Battle::Card::Properties& props) override {
-    auto functionResult = CallLuaFunctionExpectingValue<WeakWrapper<ScriptedCardAction>>(script, "card_create_action", WeakWrapper(user), props);
+    ResourceHandle().Scripts().BindBattleTypes(script);
+
+    auto functionResult = CallLuaFunctionExpectingValue<WeakWrapper<ScriptedCardAction>>(script.environment, "card_create_action", WeakWrapper(user), props);
 
     if (functionResult.is_error()) {
       Logger::Log(LogLevel::critical, functionResult.error_cstr());
@@ -9,6 +9,7 @@
 #include "../bnGame.h"
 #include "../bnDefenseVirusBody.h"
 #include "../bnUIComponent.h"
+#include "../bnScriptResourceManager.h"
 
 ScriptedCharacter::ScriptedCharacter(Character::Rank rank) :
   AI<ScriptedCharacter>(this), 
@@ -28,12 +29,14 @@ void ScriptedCharacter::Init() {
   weakWrap = WeakWrapper(weak_from_base<ScriptedCharacter>());
 }
 
-void ScriptedCharacter::InitFromScript(sol::state& script) {
+void ScriptedCharacter::InitFromScript(ScriptPackage& script) {
   if (!HasInit()) {
     Init();
   }
 
-  auto initResult = CallLuaFunction(script, "package_init", weakWrap);
+  Scripts().BindBattleTypes(script);
+
+  auto initResult = CallLuaFunction(script.environment, "package_init", weakWrap);
 
   if (initResult.is_error()) {
     Logger::Log(LogLevel::critical, initResult.error_cstr());
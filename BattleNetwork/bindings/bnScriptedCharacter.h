@@ -12,6 +12,7 @@
 class AnimationComponent;
 class ScriptedCharacterState;
 class ScriptedIntroState;
+struct ScriptPackage;
 
 /**
  * @class ScriptedCharacter
@@ -34,7 +35,7 @@ public:
   ScriptedCharacter(Character::Rank rank);
   ~ScriptedCharacter();
   void Init();
-  void InitFromScript(sol::state& script);
+  void InitFromScript(ScriptPackage& script);
   void OnSpawn(Battle::Tile& start) override;
   void OnBattleStart() override;
   void OnBattleStop() override;
@@ -10,15 +10,15 @@
 //
 // class ScriptedMob::Spawner : public Mob::Spawner<ScriptedCharacter>
 //
-ScriptedMob::ScriptedSpawner::ScriptedSpawner(sol::state& script, const std::string& path, Character::Rank rank)
+ScriptedMob::ScriptedSpawner::ScriptedSpawner(ScriptPackage& script, const std::string& path, Character::Rank rank)
 { 
   scriptedSpawner = std::make_unique<Mob::Spawner<ScriptedCharacter>>(rank);
   std::function<std::shared_ptr<ScriptedCharacter>()> lambda = scriptedSpawner->constructor;
 
   scriptedSpawner->constructor = [lambda, path, scriptPtr=&script] () -> std::shared_ptr<ScriptedCharacter> {
     auto& script = *scriptPtr;
-    script["_modpath"] = path+"/";
-    script["_folderpath"] = path+"/";
+    script.environment["_modpath"] = path+"/";
+    script.environment["_folderpath"] = path+"/";
 
     auto character = lambda();
     character->InitFromScript(script);
@@ -108,7 +108,7 @@ void ScriptedMob::ScriptedSpawner::SetMob(Mob* mob)
 //
 // class ScriptedMob : public Mob
 // 
-ScriptedMob::ScriptedMob(sol::state& script) : 
+ScriptedMob::ScriptedMob(ScriptPackage& script) : 
   MobFactory(), 
   script(script)
 {
@@ -119,15 +119,17 @@ Mob* ScriptedMob::Build(std::shared_ptr<Field> field, const std::string& dataStr
   this->field = field;
   this->mob = new Mob(field);
 
+  Scripts().BindBattleTypes(script);
+
   Logger::Logf(LogLevel::debug, "Data passed to package_build -> %s", dataString.c_str());
 
-  auto dataResult = EvalLua(script, dataString);
+  auto dataResult = EvalLua(*script.state, script.environment, dataString);
 
   if (dataResult.is_error()) {
     Logger::Log(LogLevel::critical, dataResult.error_cstr());
   }
 
-  auto initResult = CallLuaFunction(script, "package_build", this, dataResult.ok());
+  auto initResult = CallLuaFunction(script.environment, "package_build", this, dataResult.ok());
 
   if (initResult.is_error()) {
     Logger::Log(LogLevel::critical, initResult.error_cstr());
@@ -158,7 +160,7 @@ ScriptedMob::ScriptedSpawner ScriptedMob::CreateSpawner(const std::string& names
     throw std::runtime_error("Character does not exist");
   }
 
-  auto obj = ScriptedMob::ScriptedSpawner(*package->state, package->path, rank);
+  auto obj = ScriptedMob::ScriptedSpawner(*package, package->path, rank);
   obj.SetMob(this->mob);
   return obj;
 }
@@ -10,10 +10,12 @@
 #include "../bnResourceHandle.h"
 #include "../bnPixelInState.h"
 
+struct ScriptPackage;
+
 class ScriptedMob : public MobFactory, public ResourceHandle
 {
 private:
-  sol::state& script;
+  ScriptPackage& script;
   Mob* mob{ nullptr }; //!< ptr for scripts to access
   std::shared_ptr<Field> field{ nullptr };
 
@@ -28,7 +30,7 @@ public:
 
   public:
     ScriptedSpawner() = default;
-    ScriptedSpawner(sol::state& script, const std::string& path, Character::Rank rank);
+    ScriptedSpawner(ScriptPackage& script, const std::string& path, Character::Rank rank);
 
     template<typename BuiltInCharacter>
     void UseBuiltInType(Character::Rank rank);
@@ -37,7 +39,7 @@ public:
     void SetMob(Mob* mob);
   };
 
-  ScriptedMob(sol::state& script);
+  ScriptedMob(ScriptPackage& script);
 
   /**
    * @brief Builds and returns the generated mob
@@ -4,8 +4,9 @@
 #include "bnScriptedPlayerForm.h"
 #include "../bnSolHelpers.h"
 #include "../bnCardAction.h"
+#include "../bnScriptResourceManager.h"
 
-ScriptedPlayer::ScriptedPlayer(sol::state& script) :
+ScriptedPlayer::ScriptedPlayer(ScriptPackage& script) :
   script(script),
   Player()
 {
@@ -16,7 +17,9 @@ ScriptedPlayer::ScriptedPlayer(sol::state& script) :
 void ScriptedPlayer::Init() {
   Player::Init();
 
-  stx::result_t<sol::object> initResult = CallLuaFunction(script, "player_init", WeakWrapper(weak_from_base<ScriptedPlayer>()));
+  Scripts().BindBattleTypes(script);
+
+  stx::result_t<sol::object> initResult = CallLuaFunction(script.environment, "player_init", WeakWrapper(weak_from_base<ScriptedPlayer>()));
 
   if (initResult.is_error()) {
     Logger::Log(LogLevel::critical, initResult.error_cstr());
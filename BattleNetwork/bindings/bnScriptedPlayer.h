@@ -21,9 +21,10 @@
  */
 
 class ScriptedPlayerFormMeta;
+struct ScriptPackage;
 
 class ScriptedPlayer : public Player, public dynamic_object {
-  sol::state& script;
+  ScriptPackage& script;
   float height{};
 
   std::shared_ptr<CardAction> GenerateCardAction(sol::object& function, const std::string& functionName);
@@ -32,7 +33,7 @@ public:
   friend class PlayerControlledState;
   friend class PlayerIdleState;
 
-  ScriptedPlayer(sol::state& script);
+  ScriptedPlayer(ScriptPackage& script);
   ~ScriptedPlayer();
 
   void Init() override;
@@ -17,6 +17,20 @@ void ScriptedSpell::Init() {
 ScriptedSpell::~ScriptedSpell() {
 }
 
+void ScriptedSpell::OnPoolReset(Team team) {
+  // drop everything the previous script attached
+  can_move_to_func = update_func = delete_func = collision_func = sol::object();
+  attack_func = on_spawn_func = battle_start_func = battle_end_func = sol::object();
+  entries.clear();
+
+  SetTeam(team);
+  SetLayer(1);
+  setScale(2.f, 2.f);
+  SetHeight(0);
+  SetHitboxProperties(Hit::DefaultProperties);
+  scriptedOffset = {};
+}
+
 bool ScriptedSpell::CanMoveTo(Battle::Tile * next)
 {
   if (can_move_to_func.valid()) 
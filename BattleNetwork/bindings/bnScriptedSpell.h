@@ -18,6 +18,7 @@ public:
   ~ScriptedSpell();
   
   void Init() override;
+  void OnPoolReset(Team _team);
   void OnUpdate(double _elapsed) override;
   void OnDelete() override;
   void OnCollision(const std::shared_ptr<Entity> other) override;
@@ -105,7 +105,9 @@ void DefineAnimationUserType(sol::state& state, sol::table& engine_namespace) {
       });
     }
   );
+}
 
+void DefineAnimationEnums(sol::state& state) {
   state.new_enum("Playback",
     "Once", Animator::Mode::NoEffect,
     "Loop", Animator::Mode::Loop,
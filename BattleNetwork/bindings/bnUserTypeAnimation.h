@@ -9,5 +9,6 @@
 using AnimationWrapper = WeakWrapperChild<void, Animation>;
 
 void DefineAnimationUserType(sol::state& state, sol::table& engine_namespace);
+void DefineAnimationEnums(sol::state& state);
 
 #endif
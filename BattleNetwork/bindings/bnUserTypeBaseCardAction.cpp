@@ -167,7 +167,9 @@ void DefineBaseCardActionUserType(sol::state& state, sol::table& battle_namespac
   state.set_function("make_sequence_lockout",
     [](){ return CardAction::LockoutProperties{ CardAction::LockoutType::sequence }; }
   );
+}
 
+void DefineBaseCardActionEnums(sol::state& state) {
   state.new_enum("LockType",
     "Animation", CardAction::LockoutType::animation,
     "Async", CardAction::LockoutType::async,
@@ -4,5 +4,6 @@
 #include <sol/sol.hpp>
 
 void DefineBaseCardActionUserType(sol::state& state, sol::table& battle_namespace);
+void DefineBaseCardActionEnums(sol::state& state);
 
 #endif
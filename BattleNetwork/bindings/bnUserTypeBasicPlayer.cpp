@@ -57,7 +57,7 @@ void DefineBasicPlayerUserType(sol::table& battle_namespace) {
     player.Unwrap()->SetAnimation(animation);
   };
   player_table["get_animation"] = [](WeakWrapper<Player>& player) -> AnimationWrapper {
-    auto& animation = player.Unwrap()->GetComponents<AnimationComponent>()[0]->GetAnimationObject();
+    auto& animation = player.Unwrap()->GetFirstComponent<AnimationComponent>()->GetAnimationObject();
     return AnimationWrapper(player.GetWeak(), animation);
   
   };
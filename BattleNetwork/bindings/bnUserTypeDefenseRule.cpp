@@ -64,7 +64,9 @@ void DefineDefenseRuleUserTypes(sol::state& state, sol::table& battle_namespace)
       judge.Unwrap().SignalDefenseWasPierced();
     }
   );
+}
 
+void DefineDefenseRuleEnums(sol::state& state) {
   state.new_enum("DefenseOrder",
     "Always", DefenseOrder::always,
     "CollisionOnly", DefenseOrder::collisionOnly
@@ -4,5 +4,6 @@
 #include <sol/sol.hpp>
 
 void DefineDefenseRuleUserTypes(sol::state& state, sol::table& battle_namespace);
+void DefineDefenseRuleEnums(sol::state& state);
 
 #endif
@@ -4,7 +4,9 @@
 void DefineEntityUserType(sol::state& state, sol::table& battle_namespace) {
   auto table = battle_namespace.new_usertype<WeakWrapper<Entity>>("Entity");
   DefineEntityFunctionsOn(table);
+}
 
+void DefineEntityEnums(sol::state& state) {
   state.new_enum("Shadow",
     "None", Entity::Shadow::none,
     "Small", Entity::Shadow::small,
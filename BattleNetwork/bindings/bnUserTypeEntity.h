@@ -11,6 +11,7 @@
 #include "../bnTile.h"
 
 void DefineEntityUserType(sol::state& state, sol::table& battle_namespace);
+void DefineEntityEnums(sol::state& state);
 
 template<typename E>
 void DefineEntityFunctionsOn(sol::basic_usertype<WeakWrapper<E>, sol::basic_reference<false> >& entity_table) {
@@ -5,6 +5,7 @@
 #include "../bnField.h"
 #include "../bnScriptResourceManager.h"
 #include "../bnHitboxSpell.h"
+#include "../bnTile.h"
 #include "bnScriptedCharacter.h"
 #include "bnScriptedPlayer.h"
 #include "bnScriptedSpell.h"
@@ -193,6 +194,16 @@ void DefineFieldUserType(sol::table& battle_namespace) {
         }
       );
     },
+    "emit_particles", [] (
+      WeakWrapper<Field>& field,
+      const ParticleEmitter& emitter,
+      Battle::Tile& tile,
+      float offsetX,
+      float offsetY,
+      size_t count
+    ) -> size_t {
+      return field.Unwrap()->GetParticles().Emit(emitter, tile.getPosition() + sf::Vector2f(offsetX, offsetY), count);
+    },
     "callback_on_delete", [] (
       WeakWrapper<Field>& field,
       Entity::ID_t target,
@@ -5,5 +5,6 @@
 #include <sol/sol.hpp>
 
 void DefineHitboxUserTypes(sol::state& state, sol::table& battle_namespace);
+void DefineHitboxEnums(sol::state& state);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifdef BN_MOD_SUPPORT
+#include "bnUserTypeParticleEmitter.h"
+
+#include "../bnParticleSystem.h"
+#include "../frame_time_t.h"
+#include "../bnScriptResourceManager.h"
+
+void DefineParticleEmitterUserType(sol::table& engine_namespace) {
+  engine_namespace.new_usertype<ParticleEmitter>("ParticleEmitter",
+    sol::factories(
+      [] (std::shared_ptr<sf::Texture> texture) {
+        ParticleEmitter emitter;
+        emitter.texture = texture;
+        return emitter;
+      },
+      [] (const ParticleEmitter& original) {
+        return original;
+      }
+    ),
+    sol::meta_function::index, []( sol::table table, const std::string key ) {
+      ScriptResourceManager::PrintInvalidAccessMessage( table, "ParticleEmitter", key );
+    },
+    sol::meta_function::new_index, []( sol::table table, const std::string key, sol::object obj ) {
+      ScriptResourceManager::PrintInvalidAssignMessage( table, "ParticleEmitter", key );
+    },
+    "set_texture", [] (ParticleEmitter& emitter, std::shared_ptr<sf::Texture> texture) {
+      emitter.texture = texture;
+    },
+    "set_frame", [] (ParticleEmitter& emitter, int x, int y, int width, int height) {
+      emitter.frame = sf::IntRect(x, y, width, height);
+    },
+    "set_additive", [] (ParticleEmitter& emitter, bool enable) {
+      emitter.blendMode = enable ? sf::BlendAdd : sf::BlendAlpha;
+    },
+    "set_spread", [] (ParticleEmitter& emitter, float x, float y) {
+      emitter.spread = sf::Vector2f(x, y);
+    },
+    "set_velocity", sol::overload(
+      [] (ParticleEmitter& emitter, float x, float y) {
+        emitter.minVelocity = emitter.maxVelocity = sf::Vector2f(x, y);
+      },
+      [] (ParticleEmitter& emitter, float minX, float minY, float maxX, float maxY) {
+        emitter.minVelocity = sf::Vector2f(minX, minY);
+        emitter.maxVelocity = sf::Vector2f(maxX, maxY);
+      }
+    ),
+    "set_acceleration", [] (ParticleEmitter& emitter, float x, float y) {
+      emitter.acceleration = sf::Vector2f(x, y);
+    },
+    "set_drag", [] (ParticleEmitter& emitter, float drag) {
+      emitter.drag = drag;
+    },
+    "set_lifetime", sol::overload(
+      [] (ParticleEmitter& emitter, const frame_time_t& lifetime) {
+        emitter.minLifetime = emitter.maxLifetime = static_cast<float>(lifetime.asSeconds().value);
+      },
+      [] (ParticleEmitter& emitter, const frame_time_t& min, const frame_time_t& max) {
+        emitter.minLifetime = static_cast<float>(min.asSeconds().value);
+        emitter.maxLifetime = static_cast<float>(max.asSeconds().value);
+      }
+    ),
+    "set_scale", [] (ParticleEmitter& emitter, float start, float end) {
+      emitter.startScale = start;
+      emitter.endScale = end;
+    },
+    "set_spin", [] (ParticleEmitter& emitter, float min, float max) {
+      emitter.minSpin = min;
+      emitter.maxSpin = max;
+    },
+    "set_color", sol::overload(
+      [] (ParticleEmitter& emitter, sf::Color color) {
+        emitter.startColor = emitter.endColor = color;
+      },
+      [] (ParticleEmitter& emitter, sf::Color start, sf::Color end) {
+        emitter.startColor = start;
+        emitter.endColor = end;
+      }
+    )
+  );
+}
+#endif
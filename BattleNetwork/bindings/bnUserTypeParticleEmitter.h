@@ -0,0 +1,8 @@
+#ifdef BN_MOD_SUPPORT
+#pragma once
+
+#include <sol/sol.hpp>
+
+void DefineParticleEmitterUserType(sol::table& engine_namespace);
+
+#endif
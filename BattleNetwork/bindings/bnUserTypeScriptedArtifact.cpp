@@ -4,6 +4,7 @@
 #include "bnWeakWrapper.h"
 #include "bnUserTypeEntity.h"
 #include "bnScriptedArtifact.h"
+#include "../bnField.h"
 
 void DefineScriptedArtifactUserType(sol::table& battle_namespace) {
   auto table = battle_namespace.new_usertype<WeakWrapper<ScriptedArtifact>>("Artifact",
@@ -63,6 +64,16 @@ void DefineScriptedArtifactUserType(sol::table& battle_namespace) {
   );
 
   DefineEntityFunctionsOn(table);
+
+  // Battle.Artifact.from_pool(field) recycles artifacts erased from this field
+  table["from_pool"] = [](WeakWrapper<Field>& field) -> WeakWrapper<ScriptedArtifact> {
+    auto artifact = field.Unwrap()->AcquirePooled<ScriptedArtifact>();
+    artifact->Init();
+
+    auto wrappedArtifact = WeakWrapper<ScriptedArtifact>(artifact);
+    wrappedArtifact.Own();
+    return wrappedArtifact;
+  };
   table["set_animation"] = [](WeakWrapper<ScriptedArtifact>& artifact, std::string animation) {
     artifact.Unwrap()->SetAnimation(animation);
   };
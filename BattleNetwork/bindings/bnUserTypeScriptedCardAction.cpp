@@ -43,9 +43,11 @@ void DefineScriptedCardActionUserType(const std::string& namespaceId, ScriptReso
       return WeakWrapper<ScriptedCardAction>();
     }
 
+    scriptManager->BindBattleTypes(*cardScriptPackage);
+
     auto wrappedCharacter = WeakWrapper(character);
     auto functionResult = CallLuaFunctionExpectingValue<WeakWrapper<ScriptedCardAction>>(
-      *cardScriptPackage->state,
+      cardScriptPackage->environment,
       "card_create_action", wrappedCharacter, props
     );
 
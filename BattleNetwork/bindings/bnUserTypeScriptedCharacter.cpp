@@ -60,7 +60,7 @@ void DefineScriptedCharacterUserType(ScriptResourceManager* scriptManager, const
 
       auto character = std::make_shared<ScriptedCharacter>(rank);
       character->SetTeam(team);
-      character->InitFromScript(*scriptPackage->state);
+      character->InitFromScript(*scriptPackage);
       character->CreateComponent<MobHealthUI>(character);
 
       auto wrappedCharacter = WeakWrapper(character);
@@ -69,7 +69,9 @@ void DefineScriptedComponentUserType(sol::state& state, sol::table& battle_names
       }
     )
   );
+}
 
+void DefineScriptedComponentEnums(sol::state& state) {
   state.new_enum("Lifetimes",
     "Local", Component::lifetimes::local,
     "Battlestep", Component::lifetimes::battlestep,
@@ -4,5 +4,6 @@
 #include <sol/sol.hpp>
 
 void DefineScriptedComponentUserType(sol::state& state, sol::table& battle_namespace);
+void DefineScriptedComponentEnums(sol::state& state);
 
 #endif
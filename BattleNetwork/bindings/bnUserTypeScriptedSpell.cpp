@@ -4,6 +4,7 @@
 #include "bnWeakWrapper.h"
 #include "bnUserTypeEntity.h"
 #include "bnScriptedSpell.h"
+#include "../bnField.h"
 
 void DefineScriptedSpellUserType(sol::table& battle_namespace) {
   auto table = battle_namespace.new_usertype<WeakWrapper<ScriptedSpell>>("Spell",
@@ -75,6 +76,16 @@ void DefineScriptedSpellUserType(sol::table& battle_namespace) {
   );
 
   DefineEntityFunctionsOn(table);
+
+  // Battle.Spell.from_pool(field, team) recycles spells erased from this field
+  table["from_pool"] = [](WeakWrapper<Field>& field, Team team) -> WeakWrapper<ScriptedSpell> {
+    auto spell = field.Unwrap()->AcquirePooled<ScriptedSpell>(team);
+    spell->Init();
+
+    auto wrappedSpell = WeakWrapper<ScriptedSpell>(spell);
+    wrappedSpell.Own();
+    return wrappedSpell;
+  };
   table["set_animation"] = [](WeakWrapper<ScriptedSpell>& spell, std::string animation) {
     spell.Unwrap()->SetAnimation(animation);
   };
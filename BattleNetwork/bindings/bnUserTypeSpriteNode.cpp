@@ -117,7 +117,9 @@ void DefineSpriteNodeUserType(sol::state& state, sol::table& engine_namespace) {
     "b", &sf::Color::b,
     "a", &sf::Color::a
   );
+}
 
+void DefineSpriteNodeEnums(sol::state& state) {
   state.new_enum("ColorMode",
     "Multiply", ColorMode::multiply,
     "Additive", ColorMode::additive
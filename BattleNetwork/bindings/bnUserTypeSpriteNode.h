@@ -4,5 +4,6 @@
 #include <sol/sol.hpp>
 
 void DefineSpriteNodeUserType(sol::state& state, sol::table& engine_namespace);
+void DefineSpriteNodeEnums(sol::state& state);
 
 #endif
@@ -118,7 +118,9 @@ void DefineTileUserType(sol::state& state) {
       [] (Battle::Tile& tile, WeakWrapper<ScriptedArtifact>& e) { return tile.AddEntity(e.UnwrapAndRelease()); }
     )
   );
+}
 
+void DefineTileEnums(sol::state& state) {
   state.new_enum("TileState",
     "Broken", TileState::broken,
     "Cracked", TileState::cracked,
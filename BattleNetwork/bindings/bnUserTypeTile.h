@@ -4,5 +4,6 @@
 #include <sol/sol.hpp>
 
 void DefineTileUserType(sol::state& state);
+void DefineTileEnums(sol::state& state);
 
 #endif
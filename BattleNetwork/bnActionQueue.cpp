@@ -5,6 +5,52 @@ ActionQueue::~ActionQueue() {
   ClearQueue(ActionQueue::CleanupType::no_interrupts);
 }
 
+ActionQueue::QueueBase* ActionQueue::GetQueue(ActionTypes type) const {
+  size_t slot = static_cast<size_t>(type);
+
+  if (slot >= queues.size()) return nullptr;
+
+  return queues[slot].get();
+}
+
+void ActionQueue::Invoke(ActionTypes type, const ExecutionType& exec) {
+  QueueBase* queue = GetQueue(type);
+
+  if (!queue) {
+    std::cout << "Action type " << static_cast<short>(type) << " not registered" << std::endl;
+    return;
+  }
+
+  // ExecutionType::reserve
+  Index& idx = indices[0];
+  idx.processing = true;
+
+  if (exec >= ExecutionType::process) {
+    queue->Invoke(idx.index, exec);
+  }
+}
+
+void ActionQueue::PopQueue(ActionTypes type, size_t index) {
+  QueueBase* queue = GetQueue(type);
+
+  if (!queue) {
+    std::cout << "Action type " << static_cast<short>(type) << " not registered" << std::endl;
+    return;
+  }
+
+  if (index < queue->Size()) {
+    // update the index positions referring to this queue...
+    for (auto& idx : indices) {
+      size_t new_index = (idx.index==0)? 0 : idx.index-1;
+      if (idx.type == type && idx.index >= index) {
+        idx.index = new_index;
+      }
+    }
+
+    queue->Erase(index);
+  }
+}
+
 ActionOrder ActionQueue::ApplyPriorityFilter(const ActionOrder& in) {
   auto iter = priorityFilters.find(in);
 
@@ -106,7 +152,7 @@ void ActionQueue::Process() {
     return; // nothing to process. abort
   }
 
-  handlers[top](ExecutionType::process); // invoke handler
+  Invoke(top, ExecutionType::process); // invoke handler
 
   // Remove anything that has a discard op of EOF
   // and didn't get resolved this frame
@@ -115,7 +161,7 @@ void ActionQueue::Process() {
     if (iter->processing == false) {
       ActionQueue::Index index = ApplyDiscardFilter(*iter);
       if (index.discardOp == ActionDiscardOp::until_eof) {
-        poppers[index.type](index.index);
+        PopQueue(index.type, index.index);
         iter = indices.erase(iter);
         continue;
       }
@@ -129,9 +175,8 @@ void ActionQueue::Pop() {
   if (indices.empty()) return;
 
   ActionTypes queue = TopType();
-  auto iter = types.find(queue);
 
-  if (iter != types.end()) {
+  if (GetQueue(queue)) {
     ActionQueue::Index idx = indices[0];
     size_t index = idx.index;
    
@@ -142,7 +187,7 @@ void ActionQueue::Pop() {
       toggleInterval = true; // switches to voluntary first
     }
 
-    poppers[queue](index);
+    PopQueue(queue, index);
     indices.erase(indices.begin());
 
     // NOTE: I had this commented but don't know why
@@ -154,7 +199,7 @@ void ActionQueue::Pop() {
     if (top == ActionTypes::none) 
       return; // nothing to process. abort
 
-    handlers[top](ExecutionType::reserve);
+    Invoke(top, ExecutionType::reserve);
     */
   }
 }
@@ -164,16 +209,15 @@ void ActionQueue::ClearQueue(ActionQueue::CleanupType cleanup)
   if (indices.empty()) return;
 
   ActionTypes queue = TopType();
-  auto iter = types.find(queue);
   bool interrupt = cleanup == ActionQueue::CleanupType::allow_interrupts && indices[0].processing;
 
-  if (iter != types.end() && interrupt) {
-    handlers[queue](ActionQueue::ExecutionType::interrupt);
+  if (GetQueue(queue) && interrupt) {
+    Invoke(queue, ActionQueue::ExecutionType::interrupt);
   }
 
   while (indices.size()) {
     size_t index = indices[0].index;
-    poppers[queue](index);
+    PopQueue(queue, index);
 
     indices.erase(indices.begin());
     queue = TopType();
@@ -190,7 +234,7 @@ void ActionQueue::ClearQueue(ActionQueue::CleanupType cleanup)
   }
 }
 
-void ActionQueue::SetIdleCallback(const std::function<void()>& callback)
+void ActionQueue::SetIdleCallback(const stx::inplace_function<void()>& callback)
 {
   idleCallback = callback;
 }
@@ -6,18 +6,10 @@
 #include <functional>
 #include <memory>
 #include <map>
+#include <array>
+#include <typeinfo>
 
-#ifndef __APPLE__
-#include <any>
-#define any_cast std::any_cast
-using any = std::any;
-using bad_any_cast = std::bad_any_cast;
-#else
-#include "stx/any.h"
-#define any_cast stx::any_cast
-using any = stx::any;
-using bad_any_cast = stx::bad_any_cast;
-#endif
+#include "stx/inplace_function.h"
 
 enum class ActionOrder : short {
   immediate = 0,
@@ -47,11 +39,6 @@ namespace Battle {
   class Tile; // forward decl
 }
 
-template<typename T>
-struct Queue {
-  std::vector<T> list;
-};
-
 class ActionQueue {
 public:
   struct Index {
@@ -78,17 +65,61 @@ private:
   friend std::ostream& operator<<(std::ostream& os, const ActionQueue::Index& index);
   friend std::ostream& operator<<(std::ostream& os, const ActionQueue& queue);
 
+  /**
+   * @brief Storage for one registered action type
+   * 
+   * Dispatching an action is one virtual call on the slot for its ActionTypes value.
+   */
+  struct QueueBase {
+    const void* key{ nullptr }; /*!< identifies the Key type of the queue */
+
+    virtual ~QueueBase() = default;
+    virtual void Invoke(size_t index, const ExecutionType& exec) = 0;
+    virtual void Erase(size_t index) = 0;
+    virtual const size_t Size() const = 0;
+  };
+
+  template<typename Key>
+  struct Queue : QueueBase {
+    std::vector<Key> list;
+
+    const size_t Size() const override { return list.size(); }
+  };
+
+  template<typename Key, typename DeleterFunc, typename Func>
+  struct TypedQueue : Queue<Key> {
+    Func func;
+
+    TypedQueue(const Func& func) : func(func) {}
+
+    void Invoke(size_t index, const ExecutionType& exec) override {
+      func(this->list[index], exec);
+    }
+
+    void Erase(size_t index) override {
+      DeleterFunc deleter{};
+      deleter.operator()(this->list[index]);
+      this->list.erase(this->list.begin() + index);
+    }
+  };
+
+  template<typename Key>
+  static const void* KeyOf() {
+    static const char key{};
+    return &key;
+  }
+
   bool clearFilters{ false };
   bool toggleInterval{ false };
-  std::map<ActionTypes, std::function<void(const ExecutionType&)>> handlers;
-  std::map<ActionTypes, std::function<void(size_t)>> poppers;
-  std::map<std::string, ActionTypes> type2Action;
-  std::map<ActionTypes, any> types;
+  std::array<std::unique_ptr<QueueBase>, static_cast<size_t>(ActionTypes::size)> queues;
   std::map<ActionTypes, ActionDiscardOp> discardFilters;
   std::map<ActionOrder, ActionOrder> priorityFilters;
   std::vector<Index> indices;
-  std::function<void()> idleCallback;
+  stx::inplace_function<void()> idleCallback;
 
+  QueueBase* GetQueue(ActionTypes type) const;
+  void Invoke(ActionTypes type, const ExecutionType& exec);
+  void PopQueue(ActionTypes type, size_t index);
   ActionOrder ApplyPriorityFilter(const ActionOrder& in);
   Index ApplyDiscardFilter(const Index& in);
   bool IsProcessing(const Index& in);
@@ -105,7 +136,7 @@ public:
   void Process();
   void Pop();
   void ClearQueue(CleanupType cleanup);
-  void SetIdleCallback(const std::function<void()>& callback);
+  void SetIdleCallback(const stx::inplace_function<void()>& callback);
 
   template<typename T>
   struct NoDeleter {
@@ -121,72 +152,34 @@ public:
 
 template<typename Key, typename DeleterFunc, typename Func>
 void ActionQueue::RegisterType(ActionTypes type, const Func& func) {
-  if (type == ActionTypes::none) return;
-
-  types.insert(std::make_pair(type, std::make_shared<Queue<Key>>()));
-  type2Action.insert(std::make_pair(typeid(Key).name(), type));
-
-  auto invoker = [=](const ExecutionType& exec) {
-    try {
-      // ExecutionType::reserve
-      auto queue = any_cast<std::shared_ptr<Queue<Key>>>(types[type]);
-      Index& idx = indices[0];
-      idx.processing = true;
-
-      if (exec >= ExecutionType::process) {
-        func(queue->list[idx.index], exec);
-      }
-    } catch (bad_any_cast&) {
-      std::cout << "Type " << typeid(Key).name() << " not registered" << std::endl;
-    }
-  };
-
-  handlers.insert(std::make_pair(type, invoker));
-
-  auto popper = [=](size_t index) {
-    try {
-      auto queue = any_cast<std::shared_ptr<Queue<Key>>>(types[type]);
-
-      if (index < queue->list.size()) {
-        DeleterFunc deleter{};
-        deleter.operator()(queue->list[index]);
+  if (type == ActionTypes::none || type == ActionTypes::size) return;
 
-        // update the index positions referring to this queue...
-        for (auto& idx : indices) {
-          size_t new_index = (idx.index==0)? 0 : idx.index-1;
-          if (idx.type == type && idx.index >= index) {
-            idx.index = new_index;
-          }
-        }
+  std::unique_ptr<QueueBase>& slot = queues[static_cast<size_t>(type)];
 
-        queue->list.erase(queue->list.begin() + index);
-      }
-    }
-    catch (bad_any_cast&) {
-      std::cout << "Type " << typeid(Key).name() << " not registered" << std::endl;
-    }
-  };
+  // first registration wins
+  if (slot) return;
 
-  poppers.insert(std::make_pair(type, popper));
+  slot = std::make_unique<TypedQueue<Key, DeleterFunc, Func>>(func);
+  slot->key = KeyOf<Key>();
 }
 
 template<typename Y>
 void ActionQueue::Add(const Y& in, ActionOrder priority, ActionDiscardOp discard) {
-  try {
-    ActionTypes key = type2Action[typeid(Y).name()];
-    auto queue = any_cast<std::shared_ptr<Queue<Y>>>(types[key]);
-
-    if (queue) {
-      queue->list.push_back(in);
-      size_t sz = queue->list.size();
-      size_t index = sz == 0? 0 : sz-1;
-      indices.push_back(Index{ key, priority, discard, index });
-      Sort();
-    }
-  }
-  catch (bad_any_cast&) {
-    std::cout << "Type " << typeid(Y).name() << " not registered" << std::endl;
+  const void* key = KeyOf<Y>();
+
+  for (size_t i = 0; i < queues.size(); i++) {
+    if (!queues[i] || queues[i]->key != key) continue;
+
+    auto& queue = static_cast<Queue<Y>&>(*queues[i]);
+    queue.list.push_back(in);
+    size_t sz = queue.list.size();
+    size_t index = sz == 0? 0 : sz-1;
+    indices.push_back(Index{ static_cast<ActionTypes>(i), priority, discard, index });
+    Sort();
+    return;
   }
+
+  std::cout << "Type " << typeid(Y).name() << " not registered" << std::endl;
 }
 
 inline std::ostream& operator<<(std::ostream& os, const ActionQueue::Index& index) {
@@ -225,5 +218,3 @@ inline std::ostream& operator<<(std::ostream& os, const ActionQueue& queue) {
 
   return os;
 }
-
-#undef any_cast
\ No newline at end of file
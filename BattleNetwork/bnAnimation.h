@@ -6,6 +6,7 @@
 #include <iostream>
 
 #include "bnAnimator.h"
+#include "bnAnimationCache.h"
 
 using std::string;
 using std::to_string;
@@ -44,6 +45,9 @@ using std::to_string;
  * ```
  *
  * etc.
+ *
+ * Parsed files are shared between every Animation through the AnimationCache.
+ * Copying an Animation is cheap and never copies the frame data.
  */
 class Animation {
 public:
@@ -139,10 +143,10 @@ public:
   /**
    * @brief Get the frame list corresponding to this animation state
    * @param animation name of the animation
-   * @return FrameList&
-   * @warning Make sure this animation exists otherwise could return an empty frame list or throw
+   * @return const FrameList&
+   * @warning If this animation does not exist, returns an empty frame list
    */
-  FrameList& GetFrameList(std::string animation);
+  const FrameList& GetFrameList(std::string animation) const;
 
   /**
    * @brief Append frame callback
@@ -169,7 +173,7 @@ public:
    * @param onFinish the function to call when the animation finishes
    * @warning does not return object. This must be the end of the chain.
    */
-  void operator<<(const std::function<void()>& onFinish);
+  void operator<<(const FrameFinishCallback& onFinish);
 
   sf::Vector2f GetPoint(const std::string& pointName);
 
@@ -181,7 +185,7 @@ public:
 
   void SyncAnimation(Animation& other);
 
-  void SetInterruptCallback(const std::function<void()> onInterrupt);
+  void SetInterruptCallback(const FrameFinishCallback& onInterrupt);
 
   const bool HasAnimation(const std::string& state) const;
 
@@ -198,12 +202,17 @@ public:
    * This explicit function signature was added for scripting
    */
   Animation& AddCallback(int frame, FrameCallback callback, bool doOnce) {
-    *this << Animator::On(frame, callback, doOnce);
+    *this << Animator::On(frame, std::move(callback), doOnce);
     return *this;
   }
 
 private:
   void HandleInterrupted();
+
+  /**
+   * @brief Points currList at the frames for currAnimation
+   */
+  void ResolveCurrentList();
 protected:
   bool noAnim{ false }; /*!< If the requested state was not found, hide the sprite when updating */
   bool handlingInterrupt{ false }; /*!< Whether or not the interupt handler is executing (for nested animations) */
@@ -212,6 +221,8 @@ protected:
   string currAnimation; /*!< Name of the current animation state */
   frame_time_t progress; /*!< Current progress of animation */
   double playbackSpeed{ 1.0 }; /*!< Factor to multiply against update `dt`*/
-  std::map<string, FrameList> animations; /*!< Dictionary of FrameLists read from file */
-  std::function<void()> interruptCallback;
+  std::shared_ptr<const AnimationDocument> document; /*!< FrameLists read from file, shared with other animations */
+  const FrameList* currList{ nullptr }; /*!< Frames for currAnimation. Never null. */
+  size_t stateChanges{}; /*!< Bumped by SetAnimation() to detect changes made by callbacks */
+  FrameFinishCallback interruptCallback;
 };
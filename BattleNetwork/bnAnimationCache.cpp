@@ -0,0 +1,558 @@
+#include "bnAnimationCache.h"
+#include "bnFileUtil.h"
+#include "bnLogger.h"
+#include "bnVirtualFileSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+
+#ifndef __APPLE__
+#include <filesystem>
+#endif
+
+static bool StartsWith(std::string_view view, std::string_view find)
+{
+  return view.rfind(find, 0) != std::string::npos;
+}
+
+static std::string_view GetLineWithoutComment(std::string_view view, size_t start, size_t end)
+{
+  std::string_view line = view.substr(start, end - start);
+  auto commentStart = line.find('#', 0);
+
+  if (commentStart != std::string::npos) {
+    line = line.substr(0, commentStart);
+  }
+
+  return line;
+}
+
+static size_t GetNextCharPos(std::string_view view, size_t start) {
+  auto nextCharPtr = std::find_if(view.begin() + start, view.end(), [](char c) { return c != ' '; });
+  return nextCharPtr == view.end() ? std::string::npos : std::distance(view.begin(), nextCharPtr);
+}
+
+static std::string_view GetValue(std::string_view line, std::string_view key) {
+  size_t keySearchStart = 0;
+
+  while (keySearchStart < line.size()) {
+    auto keyPos = line.find(key, keySearchStart);
+
+    if (keyPos == std::string::npos) {
+      // failed to find the key
+      break;
+    }
+
+    size_t posAfterKey = keyPos + key.size();
+
+    if (keyPos > 0 && line[keyPos - 1] != ' ') {
+      // space or start of line must be before the key
+      keySearchStart += posAfterKey;
+      continue;
+    }
+
+    size_t equalPos = GetNextCharPos(line, posAfterKey);
+
+    if (equalPos == std::string::npos || line[equalPos] != '=') {
+      // expecting '=' after key
+      // we might be in a text value
+      keySearchStart += posAfterKey;
+      continue;
+    }
+
+    // search for the start of the value
+    auto valueStartPos = GetNextCharPos(line, equalPos + 1);
+
+    if (valueStartPos == std::string::npos || line[valueStartPos] != '"') {
+      keySearchStart += posAfterKey;
+      // expected " after =
+      continue;
+    }
+
+    valueStartPos += 1; // trim "
+    auto valueEndPos = line.find('"', valueStartPos);
+
+    if (valueEndPos == std::string::npos) {
+      // failed to find matching "
+      keySearchStart += posAfterKey;
+      continue;
+    }
+
+    return line.substr(valueStartPos, valueEndPos - valueStartPos);
+  }
+
+  return "";
+}
+
+static int GetIntValue(std::string_view line, std::string_view key) {
+  std::string_view valueView = GetValue(line, key);
+  return (int)std::strtol(valueView.data(), nullptr, 10);
+}
+
+static float GetFloatValue(std::string_view line, std::string_view key) {
+  std::string_view valueView = GetValue(line, key);
+  return std::strtof(valueView.data(), nullptr);
+}
+
+static bool GetBoolValue(std::string_view line, std::string_view key) {
+  std::string_view valueView = GetValue(line, key);
+  return valueView == "1" || valueView == "true";
+}
+
+std::shared_ptr<AnimationDocument> AnimationDocument::Parse(std::string_view data, const std::string& path)
+{
+  auto document = std::make_shared<AnimationDocument>();
+
+  FrameList frameList;
+  bool inState = false;
+  std::string currentState;
+  int currentWidth = 0;
+  int currentHeight = 0;
+  bool legacySupport = false;
+
+  size_t endLine = 0;
+  int lineNumber = 0;
+
+  auto addCurrentState = [&] {
+    std::transform(currentState.begin(), currentState.end(), currentState.begin(), ::toupper);
+    document->Add(currentState, std::move(frameList));
+    frameList = FrameList();
+  };
+
+  do {
+    lineNumber += 1;
+    size_t startLine = endLine;
+    endLine = data.find("\n", startLine);
+
+    if (endLine == std::string::npos) {
+      endLine = data.size();
+    }
+
+    std::string_view line = GetLineWithoutComment(data, startLine, endLine);
+    endLine += 1;
+
+    // NOTE: Support older animation files until we upgrade completely...
+    if (StartsWith(line, "VERSION")) {
+      std::string_view version = GetValue(line, "VERSION");
+
+      if (version == "1.0") {
+        legacySupport = true;
+      }
+    }
+    else if (StartsWith(line, "imagePath")) {
+      // no-op 
+      // editor only at this time
+      continue;
+    }
+    else if (StartsWith(line, "animation")) {
+      if (inState) {
+        addCurrentState();
+      }
+
+      currentState = GetValue(line, "state");
+
+      if (legacySupport) {
+        currentWidth = GetIntValue(line, "width");
+        currentHeight = GetIntValue(line, "height");
+      }
+
+      inState = true;
+    }
+    else if (StartsWith(line, "blank")) {
+      if (!inState) {
+        Logger::Logf(LogLevel::critical, "%s:%d: frame defined outside of animation state!", path.c_str(), lineNumber);
+        continue;
+      }
+
+      float duration = GetFloatValue(line, "duration");
+
+      // prevent negative frame numbers
+      frame_time_t currentFrameDuration = from_seconds(std::fabs(duration));
+
+      frameList.Add(currentFrameDuration, sf::IntRect{}, sf::Vector2f{ 0, 0 }, false, false);
+    }
+    else if (StartsWith(line, "frame")) {
+      if (!inState) {
+        Logger::Logf(LogLevel::critical, "%s:%d: frame defined outside of animation state!", path.c_str(), lineNumber);
+        continue;
+      }
+
+      float duration = GetFloatValue(line, "duration");
+
+      // prevent negative frame numbers
+      frame_time_t currentFrameDuration = from_seconds(std::fabs(duration));
+
+      int currentStartx = 0;
+      int currentStarty = 0;
+      float originX = 0;
+      float originY = 0;
+      bool flipX = false;
+      bool flipY = false;
+
+      if (legacySupport) {
+        currentStartx = GetIntValue(line, "startx");
+        currentStarty = GetIntValue(line, "starty");
+      }
+      else {
+        currentStartx = GetIntValue(line, "x");
+        currentStarty = GetIntValue(line, "y");
+        currentWidth = GetIntValue(line, "w");
+        currentHeight = GetIntValue(line, "h");
+        originX = (float)GetIntValue(line, "originx");
+        originY = (float)GetIntValue(line, "originy");
+        flipX = GetBoolValue(line, "flipx");
+        flipY = GetBoolValue(line, "flipy");
+      }
+
+      if (legacySupport) {
+        frameList.Add(currentFrameDuration, sf::IntRect(currentStartx, currentStarty, currentWidth, currentHeight));
+      }
+      else {
+        frameList.Add(
+          currentFrameDuration, 
+          sf::IntRect(currentStartx, currentStarty, currentWidth, currentHeight), 
+          sf::Vector2f(originX, originY),
+          flipX,
+          flipY
+        );
+      }
+    }
+    else if (StartsWith(line, "point")) {
+      if (!inState) {
+        Logger::Logf(LogLevel::critical, "%s:%d: frame defined outside of animation state!", path.c_str(), lineNumber);
+        continue;
+      }
+
+      std::string pointName = std::string(GetValue(line, "label"));
+      int x = GetIntValue(line, "x");
+      int y = GetIntValue(line, "y");
+
+      std::transform(pointName.begin(), pointName.end(), pointName.begin(), ::toupper);
+
+      frameList.SetPoint(pointName, x, y);
+    }
+
+  } while (endLine < data.length());
+
+  // One more addAnimation to do if file is good
+  if (inState) {
+    addCurrentState();
+  }
+
+  return document;
+}
+
+namespace {
+  template<typename T>
+  void WriteValue(std::string& out, T value) {
+    // the binary format is little endian
+    for (size_t i = 0; i < sizeof(T); i++) {
+      uint64_t bits{};
+      std::memcpy(&bits, &value, sizeof(T));
+      out.push_back(static_cast<char>((bits >> (i * 8u)) & 0xFF));
+    }
+  }
+
+  void WriteName(std::string& out, std::string_view name) {
+    WriteValue<uint16_t>(out, static_cast<uint16_t>(name.size()));
+    out.append(name.data(), name.size());
+  }
+
+  struct BinaryReader {
+    std::string_view data;
+    size_t pos{};
+    bool ok{ true };
+
+    template<typename T>
+    T Read() {
+      T value{};
+
+      if (!ok || data.size() - pos < sizeof(T)) {
+        ok = false;
+        return value;
+      }
+
+      uint64_t bits{};
+      for (size_t i = 0; i < sizeof(T); i++) {
+        bits |= static_cast<uint64_t>(static_cast<uint8_t>(data[pos + i])) << (i * 8u);
+      }
+
+      std::memcpy(&value, &bits, sizeof(T));
+      pos += sizeof(T);
+      return value;
+    }
+
+    std::string_view ReadName() {
+      uint16_t length = Read<uint16_t>();
+
+      if (!ok || data.size() - pos < length) {
+        ok = false;
+        return {};
+      }
+
+      std::string_view name = data.substr(pos, length);
+      pos += length;
+      return name;
+    }
+  };
+
+  constexpr std::string_view BINARY_MAGIC = "BNAN";
+  constexpr uint8_t FLAG_APPLY_ORIGIN = 1 << 0;
+  constexpr uint8_t FLAG_FLIP_X = 1 << 1;
+  constexpr uint8_t FLAG_FLIP_Y = 1 << 2;
+}
+
+std::shared_ptr<AnimationDocument> AnimationDocument::ReadBinary(std::string_view data, const std::string& path)
+{
+  if (data.substr(0, BINARY_MAGIC.size()) != BINARY_MAGIC) {
+    Logger::Logf(LogLevel::warning, "%s is not a binary animation file", path.c_str());
+    return nullptr;
+  }
+
+  BinaryReader reader{ data, BINARY_MAGIC.size() };
+  uint16_t version = reader.Read<uint16_t>();
+  reader.Read<uint16_t>(); // reserved
+
+  if (version != BINARY_VERSION) {
+    Logger::Logf(LogLevel::warning, "%s was compiled for animation format version %d, expected %d", path.c_str(), (int)version, (int)BINARY_VERSION);
+    return nullptr;
+  }
+
+  auto document = std::make_shared<AnimationDocument>();
+  uint32_t stateCount = reader.Read<uint32_t>();
+
+  for (uint32_t i = 0; i < stateCount && reader.ok; i++) {
+    std::string_view name = reader.ReadName();
+    uint32_t frameCount = reader.Read<uint32_t>();
+
+    FrameList list;
+
+    for (uint32_t j = 0; j < frameCount && reader.ok; j++) {
+      frame_time_t duration = frames(reader.Read<int64_t>());
+      int x = reader.Read<int32_t>();
+      int y = reader.Read<int32_t>();
+      int w = reader.Read<int32_t>();
+      int h = reader.Read<int32_t>();
+      uint8_t flags = reader.Read<uint8_t>();
+      float originX = reader.Read<float>();
+      float originY = reader.Read<float>();
+
+      Frame frame(
+        duration,
+        sf::IntRect(x, y, w, h),
+        (flags & FLAG_APPLY_ORIGIN) == FLAG_APPLY_ORIGIN,
+        sf::Vector2f(originX, originY),
+        (flags & FLAG_FLIP_X) == FLAG_FLIP_X,
+        (flags & FLAG_FLIP_Y) == FLAG_FLIP_Y
+      );
+
+      uint16_t pointCount = reader.Read<uint16_t>();
+
+      for (uint16_t k = 0; k < pointCount && reader.ok; k++) {
+        std::string_view pointName = reader.ReadName();
+        float px = reader.Read<float>();
+        float py = reader.Read<float>();
+        frame.points[std::string(pointName)] = sf::Vector2f(px, py);
+      }
+
+      list.totalDuration += duration;
+      list.frames.push_back(std::move(frame));
+    }
+
+    document->Add(name, std::move(list));
+  }
+
+  if (!reader.ok) {
+    Logger::Logf(LogLevel::critical, "%s: binary animation file is truncated", path.c_str());
+    return nullptr;
+  }
+
+  return document;
+}
+
+const std::string AnimationDocument::WriteBinary() const
+{
+  std::string out;
+  out.append(BINARY_MAGIC.data(), BINARY_MAGIC.size());
+  WriteValue<uint16_t>(out, BINARY_VERSION);
+  WriteValue<uint16_t>(out, 0);
+  WriteValue<uint32_t>(out, static_cast<uint32_t>(states.size()));
+
+  for (const State& state : states) {
+    WriteName(out, *state.name);
+    WriteValue<uint32_t>(out, static_cast<uint32_t>(state.frames.frames.size()));
+
+    for (const Frame& frame : state.frames.frames) {
+      uint8_t flags = 0;
+      if (frame.applyOrigin) flags |= FLAG_APPLY_ORIGIN;
+      if (frame.flipX) flags |= FLAG_FLIP_X;
+      if (frame.flipY) flags |= FLAG_FLIP_Y;
+
+      WriteValue<int64_t>(out, frame.duration.count());
+      WriteValue<int32_t>(out, frame.subregion.left);
+      WriteValue<int32_t>(out, frame.subregion.top);
+      WriteValue<int32_t>(out, frame.subregion.width);
+      WriteValue<int32_t>(out, frame.subregion.height);
+      WriteValue<uint8_t>(out, flags);
+      WriteValue<float>(out, frame.origin.x);
+      WriteValue<float>(out, frame.origin.y);
+      WriteValue<uint16_t>(out, static_cast<uint16_t>(frame.points.size()));
+
+      for (auto& [name, point] : frame.points) {
+        WriteName(out, name);
+        WriteValue<float>(out, point.x);
+        WriteValue<float>(out, point.y);
+      }
+    }
+  }
+
+  return out;
+}
+
+const std::string& AnimationDocument::Intern(std::string_view name)
+{
+  static std::mutex mutex;
+  static std::unordered_set<std::string> names;
+
+  std::scoped_lock lock(mutex);
+
+  // set nodes never move so the reference stays valid
+  return *names.emplace(name).first;
+}
+
+const FrameList& AnimationDocument::Empty()
+{
+  static const FrameList empty;
+  return empty;
+}
+
+void AnimationDocument::Add(std::string_view state, FrameList&& list)
+{
+  if (lookup.find(state) != lookup.end()) return;
+
+  // interned names live for the whole process, the pointer does not need to own them
+  std::shared_ptr<const std::string> name(std::shared_ptr<const std::string>(), &Intern(state));
+  states.push_back(State{ name, std::move(list) });
+  lookup.emplace(std::string_view(*name), states.size() - 1u);
+}
+
+void AnimationDocument::AddScoped(std::string_view state, FrameList&& list)
+{
+  if (lookup.find(state) != lookup.end()) return;
+
+  auto name = std::make_shared<const std::string>(state);
+  states.push_back(State{ name, std::move(list) });
+  lookup.emplace(std::string_view(*name), states.size() - 1u);
+}
+
+const FrameList* AnimationDocument::Find(std::string_view state) const
+{
+  auto iter = lookup.find(state);
+
+  if (iter == lookup.end()) {
+    return nullptr;
+  }
+
+  return &states[iter->second].frames;
+}
+
+const bool AnimationDocument::Has(std::string_view state) const
+{
+  return lookup.find(state) != lookup.end();
+}
+
+const size_t AnimationDocument::Size() const
+{
+  return states.size();
+}
+
+namespace {
+  struct CacheEntry {
+    size_t generation{}; /*!< VirtualFileSystem generation the document was read in */
+    std::shared_ptr<const AnimationDocument> document;
+  };
+
+  std::mutex cacheMutex;
+  std::unordered_map<std::string, CacheEntry> cacheEntries;
+  size_t parseCount{}, hitCount{}, binaryCount{};
+}
+
+static long long GetModifiedTime(const std::string& path)
+{
+#ifndef __APPLE__
+  std::error_code ec;
+  auto time = std::filesystem::last_write_time(path, ec);
+
+  if (!ec) {
+    return static_cast<long long>(time.time_since_epoch().count());
+  }
+#endif
+
+  return 0;
+}
+
+std::shared_ptr<const AnimationDocument> AnimationCache::Load(const std::string& path)
+{
+  // a remount can serve different content at the same path, and mounted files have no modified time
+  const size_t generation = VirtualFileSystem::Instance().Generation();
+
+  {
+    std::scoped_lock lock(cacheMutex);
+    auto iter = cacheEntries.find(path);
+
+    if (iter != cacheEntries.end() && iter->second.generation == generation) {
+      hitCount++;
+      return iter->second.document;
+    }
+  }
+
+  const std::string binaryPath = path + ANIMATION_BINARY_SUFFIX;
+  long long modified = GetModifiedTime(path);
+  long long binaryModified = GetModifiedTime(binaryPath);
+
+  // parse outside of the lock so other threads are not blocked by this file
+  std::shared_ptr<const AnimationDocument> document;
+  bool fromBinary = false;
+
+  // prefer the compiled file unless the text file was edited after it was compiled
+  if (binaryModified != 0 && binaryModified >= modified) {
+    document = AnimationDocument::ReadBinary(FileUtil::Read(binaryPath), binaryPath);
+    fromBinary = document != nullptr;
+  }
+
+  if (!document) {
+    document = AnimationDocument::Parse(FileUtil::Read(path), path);
+  }
+
+  std::scoped_lock lock(cacheMutex);
+  fromBinary ? binaryCount++ : parseCount++;
+  cacheEntries[path] = CacheEntry{ generation, document };
+  return document;
+}
+
+void AnimationCache::Clear()
+{
+  std::scoped_lock lock(cacheMutex);
+  cacheEntries.clear();
+}
+
+const size_t AnimationCache::ParseCount()
+{
+  std::scoped_lock lock(cacheMutex);
+  return parseCount;
+}
+
+const size_t AnimationCache::BinaryCount()
+{
+  std::scoped_lock lock(cacheMutex);
+  return binaryCount;
+}
+
+const size_t AnimationCache::HitCount()
+{
+  std::scoped_lock lock(cacheMutex);
+  return hitCount;
+}
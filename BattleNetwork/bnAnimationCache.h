@@ -0,0 +1,132 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bnAnimator.h"
+
+#define ANIMATION_BINARY_SUFFIX ".bin"
+
+/**
+ * @class AnimationDocument
+ * @brief The parsed contents of an animation file: every state and its FrameList
+ *
+ * Documents are immutable once shared. Every Animation that loads the same file
+ * points at the same document. Animations that need to add states, such as
+ * Animation::OverrideAnimationFrames(), copy the document first.
+ *
+ * State names read from files are interned so copying a document never copies the names.
+ * Generated names, such as the ones of overridden frames, are shared by the document and
+ * its copies instead and are freed with the last of them.
+ */
+class AnimationDocument {
+public:
+  /**
+   * @brief Parses the animation file format
+   * @param data contents of an animation file
+   * @param path used to report errors
+   */
+  static std::shared_ptr<AnimationDocument> Parse(std::string_view data, const std::string& path);
+
+  /**
+   * @brief Reads a document written by WriteBinary()
+   * @param data contents of a binary animation file
+   * @param path used to report errors
+   * @return nullptr if the data is not a binary animation or was written by another version
+   */
+  static std::shared_ptr<AnimationDocument> ReadBinary(std::string_view data, const std::string& path);
+
+  /**
+   * @brief Encodes every state into the compact binary animation format
+   *
+   * Layout (little endian):
+   * "BNAN" u16 version, u16 reserved, u32 state count
+   * per state: u16 name length, name, u32 frame count
+   * per frame: i64 duration in frames, i32 x y w h, u8 flags (origin, flipx, flipy), f32 originx originy, u16 point count
+   * per point: u16 name length, name, f32 x y
+   *
+   * Names are stored upper-cased so loading does no string transforms.
+   */
+  const std::string WriteBinary() const;
+
+  /**
+   * @brief Returns the shared copy of a state name
+   * @warning The returned string lives for the whole process
+   */
+  static const std::string& Intern(std::string_view name);
+
+  /**
+   * @brief An empty frame list used when a state does not exist
+   */
+  static const FrameList& Empty();
+
+  /**
+   * @brief Adds a state. If the state already exists, the first one is kept.
+   */
+  void Add(std::string_view state, FrameList&& list);
+
+  /**
+   * @brief Adds a state without interning its name
+   *
+   * Use for names made at runtime so they do not stay in memory for the whole process
+   */
+  void AddScoped(std::string_view state, FrameList&& list);
+
+  /**
+   * @brief Find the frame list for the state
+   * @return nullptr if the state does not exist
+   * @warning Pointers are invalidated by Add()
+   */
+  const FrameList* Find(std::string_view state) const;
+
+  const bool Has(std::string_view state) const;
+
+  const size_t Size() const;
+
+private:
+  static constexpr uint16_t BINARY_VERSION = 1;
+
+  struct State {
+    std::shared_ptr<const std::string> name; /*!< does not own interned names */
+    FrameList frames;
+  };
+
+  std::vector<State> states;
+  std::unordered_map<std::string_view, size_t> lookup; /*!< views into interned names */
+};
+
+/**
+ * @class AnimationCache
+ * @brief Process-wide cache of parsed animation files keyed by path
+ *
+ * If a compiled binary file (path + ANIMATION_BINARY_SUFFIX) exists and is not older
+ * than the text file, the binary file is loaded instead. See tools/AnimationCompiler.
+ *
+ * Spawning many entities that share an animation file only reads and parses
+ * the file once. Cached documents are dropped when anything is mounted or unmounted
+ * in the VirtualFileSystem. Hits do not touch the disk, so files edited in place are
+ * only read again after Clear(). Safe to use from the loading threads.
+ */
+class AnimationCache {
+public:
+  /**
+   * @brief Returns the parsed document for the file at path
+   */
+  static std::shared_ptr<const AnimationDocument> Load(const std::string& path);
+
+  /**
+   * @brief Drops every cached document. Animations keep the documents they already use.
+   */
+  static void Clear();
+
+  /**
+   * @brief Number of text files parsed, binary files read, and loads that were served from the cache
+   */
+  static const size_t ParseCount();
+  static const size_t BinaryCount();
+  static const size_t HitCount();
+};
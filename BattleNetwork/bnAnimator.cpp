@@ -1,5 +1,6 @@
 #include "bnAnimator.h"
 
+#include <algorithm>
 #include <iostream>
 
 Animator::Mode::Mode(int playback)
@@ -65,6 +66,37 @@ const sf::Vector2f Animator::CalculatePointData(const sf::Vector2f& point, const
   return sf::Vector2f{ pointx, pointy };
 }
 
+void Animator::Insert(FrameCallbackTable& table, int id, FrameCallback&& callback)
+{
+  auto iter = std::upper_bound(table.begin(), table.end(), id, [](int id, const FrameCallbackTable::value_type& entry) {
+    return id < entry.first;
+  });
+
+  table.emplace(iter, id, std::move(callback));
+}
+
+void Animator::Merge(FrameCallbackTable& into, FrameCallbackTable& from)
+{
+  for (auto& [id, callback] : from) {
+    Insert(into, id, std::move(callback));
+  }
+
+  from.clear();
+}
+
+FrameCallbackTable::iterator Animator::Find(FrameCallbackTable& table, int id)
+{
+  auto iter = std::lower_bound(table.begin(), table.end(), id, [](const FrameCallbackTable::value_type& entry, int id) {
+    return entry.first < id;
+  });
+
+  if (iter != table.end() && iter->first == id) {
+    return iter;
+  }
+
+  return table.end();
+}
+
 Animator::Animator() {
   onFinish = nullptr;
   queuedOnFinish = nullptr;
@@ -104,7 +136,7 @@ Animator::~Animator() {
   queuedOnFinish = nullptr;
 }
 
-void Animator::UpdateCurrentPoints(int frameIndex, FrameList& sequence) {
+void Animator::UpdateCurrentPoints(int frameIndex, const FrameList& sequence) {
   if (sequence.frames.size() <= frameIndex) return;
 
   auto& data = sequence.frames[frameIndex];
@@ -115,7 +147,7 @@ void Animator::UpdateCurrentPoints(int frameIndex, FrameList& sequence) {
   }
 }
 
-void Animator::operator() (frame_time_t progress, sf::Sprite& target, FrameList& sequence) {
+void Animator::operator() (frame_time_t progress, sf::Sprite& target, const FrameList& sequence) {
   frame_time_t startProgress = progress;
 
   // If we did not progress while in an update, do not merge the queues and ignore this request 
@@ -160,12 +192,10 @@ void Animator::operator() (frame_time_t progress, sf::Sprite& target, FrameList&
     callbacksAreValid = true;
 
     // Insert any queued callbacks into the callback list
-    callbacks.insert(queuedCallbacks.begin(), queuedCallbacks.end());
-    queuedCallbacks.clear();
+    Merge(callbacks, queuedCallbacks);
 
     // Insert any queued one-time callbacks into the one-time callback list
-    onetimeCallbacks.insert(queuedOnetimeCallbacks.begin(), queuedOnetimeCallbacks.end());
-    queuedOnetimeCallbacks.clear();
+    Merge(onetimeCallbacks, queuedOnetimeCallbacks);
 
     // Insert any queued onFinish callback into the onFinish callback
     if (queuedOnFinish) {
@@ -177,19 +207,21 @@ void Animator::operator() (frame_time_t progress, sf::Sprite& target, FrameList&
     return;
   }
 
-  // We may modify the frame order, make a copy
-  std::vector<Frame> copy = sequence.frames;
+  // Walk the frames in playback order without copying them
+  // Reversing the order is only a change in direction
+  const std::vector<Frame>& list = sequence.frames;
+  const size_t last = list.size() - 1u;
+  bool reversed = (playbackMode & Mode::Reverse) == Mode::Reverse;
 
-  // If the playback mode is reverse, flip the frames
-  if ((playbackMode & Mode::Reverse) == Mode::Reverse) {
-    reverse(copy.begin(), copy.end());
-  }
+  auto frameAt = [&list, last, &reversed](size_t pos) -> const Frame& {
+    return reversed ? list[last - pos] : list[pos];
+  };
 
   // frame index
   int index = 0;
 
-  // Iterator to the frame itself
-  std::vector<Frame>::const_iterator iter = copy.begin();
+  // Position of the frame in playback order
+  size_t pos = 0;
 
   // While there is time left in the progress loop
   while (progress > frames(0)) {
@@ -197,57 +229,44 @@ void Animator::operator() (frame_time_t progress, sf::Sprite& target, FrameList&
     index++;
 
     // Subtract from the progress
-    progress -= (*iter).duration;
+    progress -= frameAt(pos).duration;
 
     // Must be <= and not <, to handle case (progress == frame.duration) correctly
     // We assume progress hits zero because we use it as a decrementing counter
     // We add a check to ensure the start progress wasn't also 0
     // If it did not start at zero, we know we came across the end of the animation
-    bool reachedLastFrame = &(*iter) == &copy.back() && startProgress != frames(0);
+    bool reachedLastFrame = pos == last && startProgress != frames(0);
 
     if (progress <= frames(0) || reachedLastFrame) {
-      FrameCallbackHash::iterator callbackIter = callbacks.begin();
-      FrameCallbackHash::iterator callbackFind = callbacks.find(index);
-      FrameCallbackHash::iterator onetimeCallbackIter = onetimeCallbacks.find(index);
-
-      // step through and execute any callbacks that haven't triggerd up to this frame
-      while (callbacksAreValid && callbacks.size() && callbackIter != callbackFind && callbackFind != callbacks.end()) {
-        if (callbackIter->second) {
-          callbackIter->second();
-        }
-
-        // If the callback modified the first callbacks list, break
-        if (!callbacksAreValid) break;
+      // A repeating callback on this frame first fires every earlier callback that has not fired this loop.
+      // Callbacks are taken out of the table before they run so a Clear() inside one cannot destroy it mid-call
+      if (Find(callbacks, index) != callbacks.end()) {
+        while (callbacksAreValid && !callbacks.empty() && callbacks.front().first <= index) {
+          auto [id, callback] = std::move(callbacks.front());
+          callbacks.erase(callbacks.begin());
+
+          if (callback) {
+            callback();
+          }
 
-        // Otherwise add the callback into the next loop queue
-        nextLoopCallbacks.insert(*callbackIter);
+          // If the callback modified the first callbacks list, break
+          if (!callbacksAreValid) break;
 
-        // Erase the callback so we don't fire again
-        callbackIter = callbacks.erase(callbackIter);
+          // Otherwise add the callback into the next loop queue
+          Insert(nextLoopCallbacks, id, std::move(callback));
 
-        // Find the callback at the given index b/c iterator will be invalidated
-        callbackFind = callbacks.find(index);
-      }
-
-      // If callbacks are ok and the iterator matches the expected frame
-      if (callbacksAreValid && callbacks.size() && callbackIter == callbackFind && callbackFind != callbacks.end()) {
-        if (callbackIter->second) {
-          callbackIter->second();
-        }
-
-        if (callbacksAreValid) {
-          nextLoopCallbacks.insert(*callbackIter);
-          callbackIter = callbacks.erase(callbackIter);
+          if (id == index) break;
         }
       }
 
+      FrameCallbackTable::iterator onetimeCallbackIter = Find(onetimeCallbacks, index);
+
       if (callbacksAreValid && onetimeCallbackIter != onetimeCallbacks.end()) {
-        if (onetimeCallbackIter->second) {
-          onetimeCallbackIter->second();
-        }
+        FrameCallback callback = std::move(onetimeCallbackIter->second);
+        onetimeCallbacks.erase(onetimeCallbackIter);
 
-        if (callbacksAreValid) {
-          onetimeCallbacks.erase(onetimeCallbackIter);
+        if (callback) {
+          callback();
         }
       }
 
@@ -266,34 +285,30 @@ void Animator::operator() (frame_time_t progress, sf::Sprite& target, FrameList&
       }
 
       // If the playback mode was set to loop...
-      if ((playbackMode & Mode::Loop) == Mode::Loop && &(*iter) == &copy.back() && startProgress >= sequence.totalDuration) {
+      if ((playbackMode & Mode::Loop) == Mode::Loop && pos == last && startProgress >= sequence.totalDuration) {
         // But it was also set to bounce, reverse the list and start over
         if ((playbackMode & Mode::Bounce) == Mode::Bounce) {
-          reverse(copy.begin(), copy.end());
-          iter = copy.begin();
-          iter++;
+          reversed = !reversed;
+          pos = std::min<size_t>(1u, last);
         }
         else {
           // It was set only to loop, start from the beginning
-          iter = copy.begin();
+          pos = 0;
         }
 
         if (callbacksAreValid) {
           // Clear callbacks
           callbacks.clear();
 
-          // Enqueue the callbacks for the next round
-          callbacks = nextLoopCallbacks;
-          nextLoopCallbacks.clear();
-
-          // callbacksAreValid = true;
+          // Enqueue the callbacks for the next round. Swapping keeps both tables' capacity
+          std::swap(callbacks, nextLoopCallbacks);
         }
 
         continue; // Start loop again
       }
 
       // apply rect, flip, and origin attributes
-      UpdateSpriteAttributes(target, *iter);
+      UpdateSpriteAttributes(target, frameAt(pos));
 
       UpdateCurrentPoints(index - 1, sequence);
 
@@ -301,13 +316,13 @@ void Animator::operator() (frame_time_t progress, sf::Sprite& target, FrameList&
     }
 
     // If not finish, go to next frame
-    iter++;
+    pos++;
   }
 
   // If we prematurely ended the loop, update the sprite
-  if (iter != copy.end()) {
+  if (pos <= last) {
     // apply rect, flip, and origin attributes
-    UpdateSpriteAttributes(target, *iter);
+    UpdateSpriteAttributes(target, frameAt(pos));
   }
 
   // End updating flag
@@ -327,11 +342,8 @@ void Animator::operator() (frame_time_t progress, sf::Sprite& target, FrameList&
   UpdateCurrentPoints(index - 1, sequence);
 
   // Merge queued callbacks
-  callbacks.insert(queuedCallbacks.begin(), queuedCallbacks.end());
-  queuedCallbacks.clear();
-
-  onetimeCallbacks.insert(queuedOnetimeCallbacks.begin(), queuedOnetimeCallbacks.end());
-  queuedOnetimeCallbacks.clear();
+  Merge(callbacks, queuedCallbacks);
+  Merge(onetimeCallbacks, queuedOnetimeCallbacks);
 
   if (queuedOnFinish) {
     onFinish = queuedOnFinish;
@@ -352,18 +364,10 @@ Animator & Animator::operator<<(On rhs)
   if(!rhs.callback) return *this;
   
   if (rhs.doOnce) {
-    if(isUpdating) {
-      queuedOnetimeCallbacks.insert(std::make_pair(rhs.id, rhs.callback));
-    } else {
-          onetimeCallbacks.insert(std::make_pair(rhs.id, rhs.callback));
-      }
+    Insert(isUpdating ? queuedOnetimeCallbacks : onetimeCallbacks, rhs.id, std::move(rhs.callback));
   }
   else {
-  if(isUpdating) {
-        queuedCallbacks.insert(std::make_pair(rhs.id, rhs.callback));
-    } else {
-        callbacks.insert(std::make_pair(rhs.id, rhs.callback));		
-  }
+    Insert(isUpdating ? queuedCallbacks : callbacks, rhs.id, std::move(rhs.callback));
   }
 
   return *this;
@@ -417,10 +421,10 @@ void Animator::Clear() {
   }
 }
 
-void Animator::SetFrame(int frameIndex, sf::Sprite& target, FrameList& sequence)
+void Animator::SetFrame(int frameIndex, sf::Sprite& target, const FrameList& sequence)
 {
   int index = 0;
-  for (Frame& frame : sequence.frames) {
+  for (const Frame& frame : sequence.frames) {
     index++;
 
     if (index == frameIndex) {
@@ -6,13 +6,15 @@
 #include <assert.h>
 #include <iostream>
 #include <list>
+#include <vector>
 
 #include "bnLogger.h"
 #include "frame_time_t.h"
+#include "stx/inplace_function.h"
 
-using FrameCallback = std::function<void()>;
-using FrameFinishCallback = std::function<void()>;
-using FrameCallbackHash = std::multimap<int, FrameCallback>;
+using FrameCallback = stx::inplace_function<void()>;
+using FrameFinishCallback = stx::inplace_function<void()>;
+using FrameCallbackTable = std::vector<std::pair<int, FrameCallback>>; /*!< sorted by frame. Same frame callbacks keep the order they were added in */
 using PointHash = std::map<std::string, sf::Vector2f>;
 
 /**
@@ -103,14 +105,18 @@ class FrameList {
 
 public:
   friend class Animator;
+  friend class AnimationDocument;
 
   FrameList() { totalDuration = ::frames(0); }
   FrameList(const FrameList& rhs) { 
     frames = rhs.frames; 
     totalDuration = rhs.totalDuration;
   }
+  FrameList(FrameList&& rhs) noexcept = default;
+  FrameList& operator=(const FrameList& rhs) = default;
+  FrameList& operator=(FrameList&& rhs) noexcept = default;
 
-  FrameList MakeNewFromOverrideData(const std::list<OverrideFrame>& data) {
+  FrameList MakeNewFromOverrideData(const std::list<OverrideFrame>& data) const {
     FrameList res;
     if (frames.empty()) return res;
 
@@ -173,14 +179,14 @@ public:
  * @brief Get the total number of frames in this list
  * @return const unsigned int
  */
-  inline const size_t GetFrameCount() { return frames.size(); }
+  inline const size_t GetFrameCount() const { return frames.size(); }
 
   /**
   * @brief Get the frame data at the given index
   * @param index of the frame in the list (base 0)
   * @return const Frame immutable
   */
-  inline const Frame& GetFrame(const int index) { return frames[index]; }
+  inline const Frame& GetFrame(const int index) const { return frames[index]; }
 
   /**
    * @brief Get the total duration for the list of frames
@@ -208,11 +214,11 @@ public:
  */
 class Animator {
 private:
-  FrameCallbackHash callbacks; /*!< Called every time on frame */
-  FrameCallbackHash onetimeCallbacks; /*!< Called once on frame then discarded */
-  FrameCallbackHash nextLoopCallbacks; /*!< used to queue already called callbacks */
-  FrameCallbackHash queuedCallbacks; /*!< used for adding new callbacks while updating */
-  FrameCallbackHash queuedOnetimeCallbacks; /*!< adding new one-time callbacks in update */
+  FrameCallbackTable callbacks; /*!< Called every time on frame */
+  FrameCallbackTable onetimeCallbacks; /*!< Called once on frame then discarded */
+  FrameCallbackTable nextLoopCallbacks; /*!< used to queue already called callbacks */
+  FrameCallbackTable queuedCallbacks; /*!< used for adding new callbacks while updating */
+  FrameCallbackTable queuedOnetimeCallbacks; /*!< adding new one-time callbacks in update */
   
   PointHash currentPoints;
   
@@ -227,6 +233,21 @@ private:
 
   void UpdateSpriteAttributes(sf::Sprite& target, const Frame& data);
   const sf::Vector2f CalculatePointData(const sf::Vector2f& point, const Frame& data);
+
+  /**
+   * @brief Inserts after any callbacks already on the same frame
+   */
+  static void Insert(FrameCallbackTable& table, int id, FrameCallback&& callback);
+
+  /**
+   * @brief Inserts every callback from `from` into `into` and empties `from`
+   */
+  static void Merge(FrameCallbackTable& into, FrameCallbackTable& from);
+
+  /**
+   * @brief First callback on frame `id` or table.end()
+   */
+  static FrameCallbackTable::iterator Find(FrameCallbackTable& table, int id);
 public:
   inline static const FrameCallback NoCallback = [](){};
 
@@ -242,7 +263,7 @@ public:
     bool doOnce; /*!< If true, this is a one-time callback */
 
     friend class Animator;
-    On(int id, FrameCallback callback, bool doOnce = false) : id(id), callback(callback), doOnce(doOnce) {
+    On(int id, FrameCallback callback, bool doOnce = false) : id(id), callback(std::move(callback)), doOnce(doOnce) {
       ;
     }
     
@@ -300,7 +321,7 @@ public:
    * @param target sprite to apply frames to
    * @param sequence list of frames
    */
-  void operator() (frame_time_t progress, sf::Sprite& target, FrameList& sequence);
+  void operator() (frame_time_t progress, sf::Sprite& target, const FrameList& sequence);
   
   /**
    * @brief Applies a callback
@@ -328,7 +349,7 @@ public:
    * @param target sprite to apply frame to
    * @param sequence frame is pulled from list using index
    */
-  void SetFrame(int frameIndex, sf::Sprite& target, FrameList& sequence);
+  void SetFrame(int frameIndex, sf::Sprite& target, const FrameList& sequence);
 
   /**
  * @brief Updates the internal points hash from the frame list for a given frame
@@ -338,5 +359,5 @@ public:
  * Once this function is complete, the currentpoints stored inside the animator
  * is refreshed with latest data
  */
-  void UpdateCurrentPoints(int frameIndex, FrameList& sequence);
+  void UpdateCurrentPoints(int frameIndex, const FrameList& sequence);
 };
@@ -3,4 +3,11 @@
 Artifact::Artifact() : Entity() {
   SetTeam(Team::unknown);
   SetPassthrough(true);
+}
+
+void Artifact::ResetPooledState()
+{
+  Entity::ResetPooledState();
+  SetTeam(Team::unknown);
+  SetPassthrough(true);
 }
\ No newline at end of file
@@ -5,6 +5,13 @@
  * @brief Artifacts do not attack and they are not living. They are tile-rooted animations purely for visual effect.
  */
 class Artifact : public Entity {
+  friend class EntityPool;
+
+  /**
+   * @brief Restores the constructor defaults
+   */
+  void ResetPooledState() override;
+
 public:
   Artifact();
 
@@ -1,5 +1,9 @@
 #include "bnAudioResourceManager.h"
 #include "bnLogger.h"
+#include "bnWorkerPool.h"
+#include "bnVirtualFileSystem.h"
+
+#include <algorithm>
 
 AudioResourceManager::AudioResourceManager(){
   midiMusic.loadSoundFontFromFile("resources/midi/soundfont.sf2");
@@ -127,21 +131,112 @@ void AudioResourceManager::LoadSource(AudioType type, const std::string& path) {
   }
 }
 
+namespace {
+  bool LoadBuffer(sf::SoundBuffer& buffer, const std::string& path) {
+    std::vector<char> data;
+
+    if (VirtualFileSystem::Instance().Read(path, data)) {
+      return buffer.loadFromMemory(data.data(), data.size());
+    }
+
+    return buffer.loadFromFile(path);
+  }
+
+  size_t SoundBufferBytes(const sf::SoundBuffer& buffer) {
+    return static_cast<size_t>(buffer.getSampleCount()) * sizeof(sf::Int16);
+  }
+}
+
 std::shared_ptr<sf::SoundBuffer> AudioResourceManager::LoadFromFile(const std::string& path)
 {
-  auto iter = cached.find(path);
-  std::shared_ptr<sf::SoundBuffer> loaded;
+  PendingAudio inFlight;
+
+  {
+    std::scoped_lock lock(mutex);
+    CacheFinishedLoads();
+
+    if (std::shared_ptr<sf::SoundBuffer> loaded = cached.Find(path)) {
+      return loaded;
+    }
 
-  if (iter == cached.end()) {
-    loaded = std::make_shared<sf::SoundBuffer>();
-    loaded->loadFromFile(path);
-    cached.insert(std::make_pair(path, CachedResource<sf::SoundBuffer>(loaded)));
+    auto pendingIter = std::find_if(pending.begin(), pending.end(), [&path](const PendingAudio& load) {
+      return load.path == path;
+    });
+
+    if (pendingIter != pending.end()) {
+      inFlight = *pendingIter;
+    }
   }
-  else {
-    loaded = iter->second.GetResource();
+
+  // already being decoded in the background, waiting is faster than decoding again
+  if (inFlight.state) {
+    inFlight.done.wait();
+
+    std::scoped_lock lock(mutex);
+    CacheFinishedLoads();
+    return inFlight.state->resource;
+  }
+
+  std::shared_ptr<sf::SoundBuffer> loaded = std::make_shared<sf::SoundBuffer>();
+  LoadBuffer(*loaded, path);
+
+  // another thread may have finished the same file while this one was decoding
+  return cached.Insert(path, loaded, SoundBufferBytes(*loaded));
+}
+
+ResourceFuture<sf::SoundBuffer> AudioResourceManager::LoadAsync(const std::string& path)
+{
+  std::scoped_lock lock(mutex);
+  CacheFinishedLoads();
+
+  if (std::shared_ptr<sf::SoundBuffer> loaded = cached.Find(path)) {
+    return ResourceFuture<sf::SoundBuffer>::Ready(loaded);
   }
 
-  return loaded;
+  auto pendingIter = std::find_if(pending.begin(), pending.end(), [&path](const PendingAudio& load) {
+    return load.path == path;
+  });
+
+  if (pendingIter != pending.end()) {
+    return ResourceFuture<sf::SoundBuffer>(pendingIter->state);
+  }
+
+  PendingAudio load;
+  load.path = path;
+  load.state = std::make_shared<ResourceFuture<sf::SoundBuffer>::State>();
+
+  // sound buffers need no render thread step so the worker publishes the result itself
+  load.done = WorkerPool::Instance().Submit([path, state = load.state] {
+    std::shared_ptr<sf::SoundBuffer> buffer = std::make_shared<sf::SoundBuffer>();
+    bool failed = !LoadBuffer(*buffer, path);
+
+    if (failed) {
+      Logger::Logf(LogLevel::critical, "Failed loading audio: %s", path.c_str());
+    }
+
+    state->Fulfill(buffer, failed);
+  });
+
+  pending.push_back(load);
+
+  return ResourceFuture<sf::SoundBuffer>(load.state);
+}
+
+void AudioResourceManager::CacheFinishedLoads()
+{
+  auto finished = std::stable_partition(pending.begin(), pending.end(), [](const PendingAudio& load) {
+    return !load.state->ready.load(std::memory_order_acquire);
+  });
+
+  for (auto iter = finished; iter != pending.end(); iter++) {
+    const std::shared_ptr<sf::SoundBuffer>& loaded = iter->state->resource;
+
+    if (loaded) {
+      cached.Insert(iter->path, loaded, SoundBufferBytes(*loaded));
+    }
+  }
+
+  pending.erase(finished, pending.end());
 }
 
 int AudioResourceManager::Play(AudioType type, AudioPriority priority) {
@@ -179,6 +274,7 @@ int AudioResourceManager::Play(AudioType type, AudioPriority priority) {
     auto changeSampleThunk = [this, priority, type](int index) {
       channels[index].buffer.stop();
       channels[index].buffer.setBuffer(sources[static_cast<size_t>(type)]);
+      channels[index].resource = nullptr;
       channels[index].buffer.play();
       channels[index].priority = priority;
     };
@@ -224,6 +320,7 @@ int AudioResourceManager::Play(AudioType type, AudioPriority priority) {
     if (priority != AudioPriority::high) {
       if (channels[i].buffer.getStatus() != sf::SoundSource::Status::Playing) {
         channels[i].buffer.setBuffer(sources[static_cast<size_t>(type)]);
+        channels[i].resource = nullptr;
         channels[i].buffer.play();
         channels[i].priority = priority;
         return 0;
@@ -235,6 +332,7 @@ int AudioResourceManager::Play(AudioType type, AudioPriority priority) {
       if (canOverwrite) {
         channels[i].buffer.stop();
         channels[i].buffer.setBuffer(sources[static_cast<size_t>(type)]);
+        channels[i].resource = nullptr;
         channels[i].buffer.play();
         channels[i].priority = priority;
         return 0;
@@ -278,6 +376,7 @@ int AudioResourceManager::Play(std::shared_ptr<sf::SoundBuffer> resource, AudioP
     auto changeSampleThunk = [this, priority, resource](int index) {
       channels[index].buffer.stop();
       channels[index].buffer.setBuffer(*resource.get());
+      channels[index].resource = resource;
       channels[index].buffer.play();
       channels[index].priority = priority;
     };
@@ -324,6 +423,7 @@ int AudioResourceManager::Play(std::shared_ptr<sf::SoundBuffer> resource, AudioP
     if (priority != AudioPriority::high) {
       if (channels[i].buffer.getStatus() != sf::SoundSource::Status::Playing) {
         channels[i].buffer.setBuffer(*resource);
+        channels[i].resource = resource;
         channels[i].buffer.play();
         channels[i].priority = priority;
         return 0;
@@ -335,6 +435,7 @@ int AudioResourceManager::Play(std::shared_ptr<sf::SoundBuffer> resource, AudioP
       if (canOverwrite) {
         channels[i].buffer.stop();
         channels[i].buffer.setBuffer(*resource);
+        channels[i].resource = resource;
         channels[i].buffer.play();
         channels[i].priority = priority;
         return 0;
@@ -357,7 +458,11 @@ int AudioResourceManager::Stream(std::string path, bool loop, long long startMs,
   stream.stop();
   midiMusic.stop();
 
-  if (!stream.openFromFile(path)) {
+  // sf::Music reads while it plays so mounted files must stay in memory until the next stream
+  streamData.clear();
+  bool mounted = VirtualFileSystem::Instance().Read(path, streamData);
+
+  if (!(mounted ? stream.openFromMemory(streamData.data(), streamData.size()) : stream.openFromFile(path))) {
     if (midiMusic.loadMidiFromFile(path)) {
       midiMusic.play();
       midiMusic.setLoop(loop);
@@ -402,6 +507,16 @@ void AudioResourceManager::SetChannelVolume(float volume) {
   channelVolume = volume;
 }
 
+void AudioResourceManager::SetCacheBudget(size_t bytes)
+{
+  cached.SetBudget(bytes);
+}
+
+const ResourceCache<sf::SoundBuffer>::Stats AudioResourceManager::GetCacheStats() const
+{
+  return cached.GetStats();
+}
+
 const float AudioResourceManager::GetStreamVolume() const
 {
   return this->streamVolume;
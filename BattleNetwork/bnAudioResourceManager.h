@@ -4,13 +4,16 @@
 #include <SFML/Audio/Sound.hpp>
 #include <SFML/Audio/Music.hpp>
 #include <atomic>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "sfMidi/include/sfMidi.h"
 #include "bnAudioType.h"
-#include "bnCachedResource.h"
+#include "bnResourceCache.h"
+#include "bnResourceFuture.h"
 
 // For more retro experience, decrease available channels.
 #define NUM_OF_CHANNELS 15
@@ -43,6 +46,8 @@ enum class AudioPriority : int {
  */
 class AudioResourceManager {
 public:
+  static constexpr size_t DEFAULT_CACHE_BUDGET = 64u * 1024u * 1024u; /*!< Bytes of RAM kept for samples nobody is using */
+
   /**
    * @brief If true, plays Audio(). If false, does not play Audio()
    * @param status
@@ -76,6 +81,15 @@ public:
   void LoadSource(AudioType type, const std::string& path);
 
   std::shared_ptr<sf::SoundBuffer> LoadFromFile(const std::string& path);
+
+  /**
+   * @brief Decodes the sample on a worker thread instead of blocking the caller
+   * @param path path to Audio() sample
+   * @return Handle that becomes ready once the sample is decoded. Already ready if the sample is cached.
+   *
+   * LoadFromFile() on a path that is still loading waits for the decode instead of starting over.
+   */
+  ResourceFuture<sf::SoundBuffer> LoadAsync(const std::string& path);
   
   /**
    * @brief Play a sound with an Audio() priority
@@ -95,24 +109,48 @@ public:
 
   const float GetStreamVolume() const;
 
+  /**
+   * @brief Bytes of RAM the sample cache may hold
+   *
+   * Samples still in use count against it but are never evicted, so the cache
+   * can stay over budget until they are released
+   */
+  void SetCacheBudget(size_t bytes);
+
+  const ResourceCache<sf::SoundBuffer>::Stats GetCacheStats() const;
+
   AudioResourceManager();
   ~AudioResourceManager();
 
 private:
   struct Channel {
     sf::Sound buffer;
+    std::shared_ptr<sf::SoundBuffer> resource; /*!< Keeps a cached sample from being evicted while it plays */
     AudioPriority priority{ AudioPriority::lowest };
   };
 
+  struct PendingAudio {
+    std::string path;
+    std::shared_future<void> done;
+    std::shared_ptr<ResourceFuture<sf::SoundBuffer>::State> state;
+  };
+
   sfmidi::Midi midiMusic;
   std::mutex mutex;
   Channel* channels;
   sf::SoundBuffer* sources;
-  std::map<std::string, CachedResource<sf::SoundBuffer>> cached;
+  ResourceCache<sf::SoundBuffer> cached{ DEFAULT_CACHE_BUDGET };
+  std::vector<PendingAudio> pending; /*!< Async loads not moved into the cache yet */
   sf::Music stream;
+  std::vector<char> streamData; /*!< File backing the stream when it comes from a mounted package */
   std::string currStreamPath;
   float channelVolume{};
   float streamVolume{};
   bool isEnabled{true};
   bool muted{false};
+
+  /**
+   * @brief Moves finished async loads into the cache. Must be called with the mutex locked.
+   */
+  void CacheFinishedLoads();
 };
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "bnBattlePreloader.h"
+#include "bnAnimationCache.h"
+#include "bnAudioResourceManager.h"
+#include "bnBlockPackageManager.h"
+#include "bnCardFolder.h"
+#include "bnCardPackageManager.h"
+#include "bnLogger.h"
+#include "bnTextureResourceManager.h"
+#include "bnVirtualFileSystem.h"
+#include "bnWorkerPool.h"
+
+#include <algorithm>
+#include <cctype>
+
+#ifndef __APPLE__
+  // TODO: mac os < 10.15 file system support
+  #include <filesystem>
+#endif
+
+void BattlePreloader::AddPackage(const std::string& path)
+{
+  if (path.empty()) return;
+
+  packages.insert(path);
+}
+
+void BattlePreloader::AddFolder(CardFolder& folder, CardPackagePartitioner& partition)
+{
+  for (auto iter = folder.Begin(); iter != folder.End(); iter++) {
+    stx::result_t<PackageAddress> maybe_addr = PackageAddress::FromStr((*iter)->GetUUID());
+
+    if (maybe_addr.is_error()) continue;
+
+    PackageAddress addr = maybe_addr.value();
+
+    if (partition.HasPackage(addr)) {
+      AddPackage(partition.FindPackageByAddress(addr).GetFilePath());
+    }
+  }
+}
+
+void BattlePreloader::AddBlocks(const std::vector<PackageAddress>& blocks, BlockPackagePartitioner& partition)
+{
+  for (const PackageAddress& addr : blocks) {
+    if (partition.HasPackage(addr)) {
+      AddPackage(partition.FindPackageByAddress(addr).GetFilePath());
+    }
+  }
+}
+
+size_t BattlePreloader::Start()
+{
+  size_t requested = 0;
+
+#ifndef __APPLE__
+  std::vector<std::string> animations;
+
+  for (const std::string& package : packages) {
+    std::vector<std::string> files;
+
+    if (VirtualFileSystem::Instance().IsMounted(package)) {
+      files = VirtualFileSystem::Instance().List(package);
+    }
+    else {
+      std::error_code error;
+      std::filesystem::recursive_directory_iterator iter(package, error), end;
+
+      if (error) {
+        Logger::Logf(LogLevel::warning, "Could not preload package %s: %s", package.c_str(), error.message().c_str());
+        continue;
+      }
+
+      for (; iter != end; iter.increment(error)) {
+        if (error) break;
+        if (!iter->is_regular_file(error)) continue;
+
+        // scripts build paths from _modpath, so the cache keys must be spelled the same way
+        files.push_back(package + "/" + iter->path().lexically_relative(package).generic_string());
+      }
+    }
+
+    for (const std::string& path : files) {
+      std::string ext = std::filesystem::path(path).extension().string();
+      std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+
+      if (ext == ".png" || ext == ".bmp") {
+        Textures().LoadAsync(path);
+      }
+      else if (ext == ".ogg" || ext == ".wav" || ext == ".flac") {
+        Audio().LoadAsync(path);
+      }
+      else if (ext == ".animation") {
+        animations.push_back(path);
+      }
+      else {
+        continue;
+      }
+
+      requested++;
+    }
+  }
+
+  if (!animations.empty()) {
+    // AnimationCache is process-wide so the job does not depend on this object
+    WorkerPool::Instance().Submit([animations = std::move(animations)] {
+      for (const std::string& path : animations) {
+        AnimationCache::Load(path);
+      }
+    });
+  }
+
+  Logger::Logf(LogLevel::debug, "Preloading %u assets from %u packages", (unsigned)requested, (unsigned)packages.size());
+#endif
+
+  packages.clear();
+  return requested;
+}
+
+const ResourceCacheStats BattlePreloader::CacheStats()
+{
+  ResourceHandle handle;
+  ResourceCacheStats stats = handle.Textures().GetCacheStats();
+  stats += handle.Audio().GetCacheStats();
+  return stats;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "bnResourceHandle.h"
+#include "bnPackageAddress.h"
+#include "bnResourceCache.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+class CardFolder;
+class CardPackagePartitioner;
+class BlockPackagePartitioner;
+
+/**
+ * @class BattlePreloader
+ * @brief Warms the resource caches with every asset the packages in an upcoming battle ship
+ *
+ * Scripts load their textures, animations and sounds the first time an entity or card needs them,
+ * which stalls the intro and the first use of each card. Start this before pushing the battle scene:
+ * images and sounds decode on the worker pool while the transition and intro play, and textures
+ * reach the GPU through TextureResourceManager::UploadPending() under its per-frame budget.
+ *
+ * Lua scripts are not preloaded. Package scripts are already compiled when the package is installed.
+ */
+class BattlePreloader : public ResourceHandle {
+public:
+  /**
+   * @brief Queues every asset inside a package folder
+   * @param path package folder, as returned by the package meta GetFilePath()
+   */
+  void AddPackage(const std::string& path);
+
+  /**
+   * @brief Queues the packages of every card in the folder
+   */
+  void AddFolder(CardFolder& folder, CardPackagePartitioner& partition);
+
+  /**
+   * @brief Queues the packages of installed blocks
+   */
+  void AddBlocks(const std::vector<PackageAddress>& blocks, BlockPackagePartitioner& partition);
+
+  /**
+   * @brief Starts loading everything queued
+   * @return number of assets requested
+   */
+  size_t Start();
+
+  /**
+   * @brief Texture and audio cache counters combined. Compare before and after a battle to count misses.
+   */
+  static const ResourceCacheStats CacheStats();
+
+private:
+  std::set<std::string> packages; /*!< Package folders. Cards share packages so this removes duplicates */
+};
@@ -0,0 +1,157 @@
+#include "bnBootScheduler.h"
+#include "bnLogger.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+BootScheduler::StageID BootScheduler::AddStage(const std::string& name, const std::vector<StageID>& dependencies, bool serial)
+{
+  Stage stage;
+  stage.name = name;
+  stage.dependencies = dependencies;
+  stage.serial = serial;
+
+  std::scoped_lock lock(mutex);
+  stages.push_back(std::move(stage));
+  return stages.size() - 1;
+}
+
+void BootScheduler::AddJob(StageID stage, Job job)
+{
+  std::scoped_lock lock(mutex);
+  stages.at(stage).queued.push_back(std::move(job));
+  jobCount++;
+}
+
+void BootScheduler::Run(unsigned threads, const std::function<void(size_t, size_t)>& onJobDone)
+{
+  if (threads == 0) {
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  {
+    std::scoped_lock lock(mutex);
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(jobCount, 1)));
+  }
+
+  std::vector<std::thread> workers;
+
+  // the calling thread works too
+  for (unsigned i = 1; i < threads; i++) {
+    workers.emplace_back(&BootScheduler::Work, this, std::cref(onJobDone));
+  }
+
+  Work(onJobDone);
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+const size_t BootScheduler::JobCount() const
+{
+  std::scoped_lock lock(mutex);
+  return jobCount;
+}
+
+const size_t BootScheduler::JobsDone() const
+{
+  return jobsDone.load();
+}
+
+bool BootScheduler::UpdateStages()
+{
+  bool changed = true;
+
+  // a stage finishing can finish empty stages that depend on it
+  while (changed) {
+    changed = false;
+
+    for (Stage& stage : stages) {
+      if (stage.done || !stage.queued.empty() || stage.running > 0) continue;
+
+      bool ready = std::all_of(stage.dependencies.begin(), stage.dependencies.end(), [this](StageID id) {
+        return stages[id].done;
+      });
+
+      if (ready) {
+        stage.done = true;
+        changed = true;
+      }
+    }
+  }
+
+  return std::all_of(stages.begin(), stages.end(), [](const Stage& stage) { return stage.done; });
+}
+
+bool BootScheduler::TakeJob(Job& job, StageID& stageID)
+{
+  for (StageID id = 0; id < stages.size(); id++) {
+    Stage& stage = stages[id];
+
+    if (stage.queued.empty()) continue;
+    if (stage.serial && stage.running > 0) continue;
+
+    bool ready = std::all_of(stage.dependencies.begin(), stage.dependencies.end(), [this](StageID dep) {
+      return stages[dep].done;
+    });
+
+    if (!ready) continue;
+
+    job = std::move(stage.queued.front());
+    stage.queued.pop_front();
+    stage.running++;
+    stageID = id;
+    return true;
+  }
+
+  return false;
+}
+
+void BootScheduler::Work(const std::function<void(size_t, size_t)>& onJobDone)
+{
+  while (true) {
+    Job job;
+    StageID stage{};
+
+    {
+      std::unique_lock lock(mutex);
+      bool finished = false;
+
+      wake.wait(lock, [&] {
+        finished = UpdateStages();
+        return finished || TakeJob(job, stage);
+      });
+
+      if (finished) break;
+    }
+
+    try {
+      job();
+    }
+    catch (std::exception& e) {
+      Logger::Logf(LogLevel::critical, "Boot job failed: %s", e.what());
+    }
+    catch (...) {
+      // the job still counts as done or its stage would never finish and Run() would hang
+      Logger::Logf(LogLevel::critical, "Boot job in stage `%s` failed with an unknown exception", stages[stage].name.c_str());
+    }
+
+    size_t done = ++jobsDone;
+
+    {
+      std::scoped_lock lock(mutex);
+      stages[stage].running--;
+    }
+
+    wake.notify_all();
+
+    if (onJobDone) {
+      onJobDone(done, jobCount);
+    }
+  }
+
+  // wake the other threads so they see that everything is done
+  wake.notify_all();
+}
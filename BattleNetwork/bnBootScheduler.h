@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class BootScheduler
+ * @brief Runs independent boot jobs, such as package installs, on several threads
+ *
+ * Jobs belong to stages. A stage starts once every stage it depends on has finished.
+ * Jobs inside a stage run concurrently unless the stage is serial, e.g. because its
+ * packages create entities or include each other while they load.
+ */
+class BootScheduler {
+public:
+  using Job = std::function<void()>;
+  using StageID = size_t;
+
+  /**
+   * @param dependencies stages that must finish before this stage starts
+   * @param serial if true, the jobs of this stage run one at a time in the order they were added
+   */
+  StageID AddStage(const std::string& name, const std::vector<StageID>& dependencies = {}, bool serial = false);
+
+  void AddJob(StageID stage, Job job);
+
+  /**
+   * @brief Runs every job and returns when all of them are done. Exceptions of any type thrown by jobs are logged and the job counts as done.
+   * @param threads number of threads to use. 0 uses one per hardware thread
+   * @param onJobDone called after each job with the number of finished jobs and the total. Called from the worker threads.
+   */
+  void Run(unsigned threads = 0, const std::function<void(size_t, size_t)>& onJobDone = nullptr);
+
+  const size_t JobCount() const;
+  const size_t JobsDone() const;
+
+private:
+  struct Stage {
+    std::string name;
+    std::vector<StageID> dependencies;
+    bool serial{};
+    std::deque<Job> queued;
+    size_t running{};
+    bool done{};
+  };
+
+  mutable std::mutex mutex;
+  std::condition_variable wake;
+  std::vector<Stage> stages;
+  size_t jobCount{};
+  std::atomic<size_t> jobsDone{ 0 };
+
+  /**
+   * @brief Marks stages with nothing left to do as done. Must be called with the mutex locked.
+   * @return true if every stage is done
+   */
+  bool UpdateStages();
+
+  /**
+   * @brief Takes the next job that is allowed to run. Must be called with the mutex locked.
+   * @return false if no job can start right now
+   */
+  bool TakeJob(Job& job, StageID& stage);
+
+  void Work(const std::function<void(size_t, size_t)>& onJobDone);
+};
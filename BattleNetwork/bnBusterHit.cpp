@@ -18,24 +18,42 @@ void BusterHit::Init()
 {
   Artifact::Init();
 
-  animationComponent = CreateComponent<AnimationComponent>(weak_from_this());
+  std::string path = type == Type::CHARGED ? CHARGED_RESOURCE_PATH : PEA_RESOURCE_PATH;
 
   if (type == Type::CHARGED) {
     setTexture(Textures().LoadFromFile(TexturePaths::SPELL_CHARGED_BULLET_HIT));
-    animationComponent->SetPath(CHARGED_RESOURCE_PATH);
   }
   else {
     setTexture(Textures().LoadFromFile(TexturePaths::SPELL_BULLET_HIT));
-    animationComponent->SetPath(PEA_RESOURCE_PATH);
+  }
+
+  // recycled hits keep their animation unless they changed type
+  if (animationComponent) {
+    ReattachComponent(animationComponent);
+  }
+  else {
+    animationComponent = CreateComponent<AnimationComponent>(weak_from_this());
+  }
+
+  if (animationComponent->GetFilePath() != path) {
+    animationComponent->SetPath(path);
+    animationComponent->Reload();
   }
 
   auto onFinish = [&]() { Delete(); };
 
-  animationComponent->Reload();
   animationComponent->SetAnimation("HIT", onFinish);
   animationComponent->OnUpdate(0);
 }
 
+void BusterHit::OnPoolReset(Type type)
+{
+  this->type = type;
+  SetLayer(0);
+  setScale(2.f, 2.f);
+  SetOffset({});
+}
+
 void BusterHit::OnUpdate(double _elapsed) {
 }
 
@@ -23,6 +23,11 @@ public:
   ~BusterHit();
   void SetOffset(const sf::Vector2f offset);
   void Init() override;
+
+  /**
+  * @brief Changes the hit type for recycled instances
+  */
+  void OnPoolReset(Type type);
   void OnUpdate(double _elapsed) override;
   void OnDelete() override;
 
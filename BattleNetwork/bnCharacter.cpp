@@ -99,9 +99,9 @@ void Character::Update(double _elapsed) {
 
       // execute when delay is over
       if (cardActionStartDelay <= frames(0)) {
-        for(std::shared_ptr<AnimationComponent>& anim : this->GetComponents<AnimationComponent>()) {
+        ForEachComponent<AnimationComponent>([](const std::shared_ptr<AnimationComponent>& anim) {
           anim->CancelCallbacks();
-        }
+        });
         MakeActionable();
         std::shared_ptr<Character> characterPtr = shared_from_base<Character>();
         currCardAction->Execute(characterPtr);
@@ -17,6 +17,7 @@ class BattleSceneBase;
 class Component : public stx::enable_shared_from_base<Component> {
 public:
   friend class BattleSceneBase;
+  friend class Entity;
 
   using ID_t = long;
 
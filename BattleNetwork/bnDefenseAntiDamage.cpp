@@ -25,7 +25,7 @@ void DefenseAntiDamage::CanBlock(DefenseFrameStateJudge& judge, std::shared_ptr<
     !judge.IsImpactBlocked()
   ) {
     if (!triggering) {
-      owner->GetField()->AddEntity(std::make_shared<HitboxSpell>(owner->GetTeam(), 0), *owner->GetTile());
+      owner->GetField()->SpawnPooled<HitboxSpell>(*owner->GetTile(), owner->GetTeam(), 0);
       judge.AddTrigger(callback, attacker, owner);
     }
 
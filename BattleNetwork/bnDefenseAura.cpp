@@ -34,8 +34,7 @@ void DefenseAura::CanBlock(DefenseFrameStateJudge& judge, std::shared_ptr<Entity
   if ((attacker->GetHitboxProperties().flags & Hit::impact) != Hit::impact) return; // no blocking happens
 
   // weak obstacles will break
-  auto hitbox = std::make_shared<HitboxSpell>(owner->GetTeam(), 0);
-  owner->GetField()->AddEntity(hitbox, *owner->GetTile());
+  owner->GetField()->SpawnPooled<HitboxSpell>(*owner->GetTile(), owner->GetTeam(), 0);
 
   judge.BlockDamage();
 
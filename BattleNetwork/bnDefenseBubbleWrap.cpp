@@ -28,8 +28,7 @@ void DefenseBubbleWrap::CanBlock(DefenseFrameStateJudge& judge, std::shared_ptr<
   if ((attacker->GetHitboxProperties().flags & Hit::impact) == 0) return;
 
   // weak obstacles will break like other bubbles
-  auto hitbox = std::make_shared<HitboxSpell>(owner->GetTeam(), 0);
-  owner->GetField()->AddEntity(hitbox, *owner->GetTile());
+  owner->GetField()->SpawnPooled<HitboxSpell>(*owner->GetTile(), owner->GetTeam(), 0);
 
   auto props = attacker->GetHitboxProperties();
   if ((props.flags & Hit::impact) == Hit::impact) {
@@ -25,7 +25,7 @@ void DefenseGuard::CanBlock(DefenseFrameStateJudge& judge, std::shared_ptr<Entit
       judge.AddTrigger(callback, attacker, owner);
       judge.BlockImpact();
       // owner->GetField()->AddEntity(std::make_shared<GuardHit>(owner, true), *owner->GetTile());
-      owner->GetField()->AddEntity(std::make_shared<HitboxSpell>(owner->GetTeam(), 0), *owner->GetTile());
+      owner->GetField()->SpawnPooled<HitboxSpell>(*owner->GetTile(), owner->GetTeam(), 0);
     }
   }
   else if((props.flags & Hit::impact) == Hit::impact){
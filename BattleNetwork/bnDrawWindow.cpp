@@ -84,32 +84,6 @@ void DrawWindow::Draw(vector<SpriteProxyNode*> _drawable) {
 
   auto it = _drawable.begin();
   for (it; it != _drawable.end(); ++it) {
-    /*
-    NOTE: Could add support for multiple shaders:
-    NOTE 12/7/2020: Use G buffers
-    
-    sf::RenderTexture image1;
-    sf::RenderTexture image2;
-
-    sf::RenderTexture* front = &image1;
-    sf::RenderTexture* back = &image2;
-
-    // draw the initial scene into "back"
-    ...
-
-    for (std::vector<sf::Shader>::iterator it = shaders.begin(); it != shaders.end(); ++it)
-    {
-    // draw "back" into "front"
-    front->clear();
-    front->draw(sf::Sprite(back->getTexture()), &*it);
-    front->display();
-
-    // swap front and back buffers
-    std::swap(back, front)
-    }
-
-    */
-
     // For now, support at most one shader.
     // Grab the shader and image, apply to a new render target, pass this render target into Draw()
 
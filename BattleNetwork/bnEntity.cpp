@@ -34,17 +34,7 @@ Entity::Entity() :
 {
   ID = ++Entity::numOfIDs;
 
-  SetColorMode(ColorMode::additive);
-  setColor(NoopCompositeColor(ColorMode::additive));
-
-  if (sf::Shader* shader = Shaders().GetShader(ShaderType::BATTLE_CHARACTER)) {
-    SetShader(shader);
-    SmartShader& smartShader = GetShader();
-    smartShader.SetUniform("texture", sf::Shader::CurrentTexture);
-    smartShader.SetUniform("additiveMode", true);
-    smartShader.SetUniform("swapPalette", false);
-    baseColor = sf::Color(0, 0, 0, 0);
-  }
+  SetDefaultVisuals();
 
   using namespace std::placeholders;
   auto handler = std::bind(&Entity::HandleMoveEvent, this, _1, _2);
@@ -54,11 +44,6 @@ Entity::Entity() :
   stun = Shaders().GetShader(ShaderType::YELLOW);
   root = Shaders().GetShader(ShaderType::BLACK);
   setColor(NoopCompositeColor(GetColorMode()));
-
-  shadow = std::make_shared<SpriteProxyNode>();
-  shadow->SetLayer(1);
-  shadow->Hide(); // default: hidden
-  AddNode(shadow);
 }
 
 Entity::~Entity() {
@@ -76,6 +61,22 @@ void Entity::SortComponents()
 {
   // Newest components appear first in the list for easy referencing
   std::sort(components.begin(), components.end(), [](std::shared_ptr<Component>& a, std::shared_ptr<Component>& b) { return a->GetID() > b->GetID(); });
+  InvalidateComponentCache();
+}
+
+void Entity::InvalidateComponentCache()
+{
+  componentsVersion++;
+
+  // drop stale references now so freed components can be destroyed.
+  // Lists being walked are dropped when their walk ends
+  for (auto& [_, cache] : componentsByType) {
+    if (cache->walks == 0) cache->Clear();
+  }
+
+  for (auto& [_, cache] : componentsByBase) {
+    if (cache->walks == 0) cache->Clear();
+  }
 }
 
 void Entity::ClearPendingComponents()
@@ -96,6 +97,7 @@ void Entity::ReleaseComponentsPendingRemoval()
 
     if (iter != components.end()) {
       components.erase(iter);
+      InvalidateComponentCache();
     }
   }
 }
@@ -316,6 +318,110 @@ bool Entity::HasInit() {
   return hasInit;
 }
 
+const bool Entity::IsPooled() const {
+  return pooled;
+}
+
+void Entity::SetDefaultVisuals()
+{
+  SetColorMode(ColorMode::additive);
+  setColor(NoopCompositeColor(ColorMode::additive));
+
+  if (sf::Shader* shader = Shaders().GetShader(ShaderType::BATTLE_CHARACTER)) {
+    SetShader(shader);
+    SmartShader& smartShader = GetShader();
+    smartShader.SetUniform("texture", sf::Shader::CurrentTexture);
+    smartShader.SetUniform("additiveMode", true);
+    smartShader.SetUniform("swapPalette", false);
+    baseColor = sf::Color(0, 0, 0, 0);
+  }
+
+  shadow = std::make_shared<SpriteProxyNode>();
+  shadow->SetLayer(1);
+  shadow->Hide(); // default: hidden
+  AddNode(shadow);
+}
+
+void Entity::ResetPooledState()
+{
+  ID = ++Entity::numOfIDs;
+
+  // Components are usually freed when the field forgets this entity
+  // but not if it was dropped before it was spawned. Init() will attach them again
+  ClearPendingComponents();
+  FreeAllComponents();
+  hasInit = false;
+  hasSpawned = false;
+  isUpdating = false;
+  updatedOnTick = 0;
+  deleted = false;
+  flagForErase = false;
+  fieldStart = false;
+  isTimeFrozen = false;
+  hit = false;
+  tile = previous = nullptr;
+  tileOffset = drawOffset = counterSlideOffset = sf::Vector2f{};
+  currMoveEvent = MoveEvent{};
+  elapsedMoveTime = 0;
+  moveCount = 0;
+  stunCooldown = rootCooldown = invincibilityCooldown = frames(0);
+  statusQueue = {};
+  actionQueue.ClearQueue(ActionQueue::CleanupType::allow_interrupts);
+  moveStartupDelay = {};
+  moveEndlagDelay.reset();
+  moveStartPosition = sf::Vector2f{};
+  moveEventFrame = frame = 0;
+  counterSlideDelta = 0;
+  slideFromDrag = false;
+  inputState = VirtualInputState{};
+
+  // gameplay properties set by the previous life
+  team = Team{};
+  element = Element::none;
+  name.clear();
+  health = maxHealth = 0;
+  height = 0;
+  hitboxProperties = Hit::DefaultProperties;
+  hitboxEnabled = true;
+  passthrough = floatShoe = airShoe = false;
+  slidesOnTiles = true;
+  canShareTile = canTilePush = false;
+  counterable = neverFlip = false;
+  ignoreCommonAggressor = false;
+  manualDelete = false;
+  defenses.clear();
+  statusCallbackHash.clear();
+  HitPublisher::ClearListeners();
+  CounterHitPublisher::ClearListeners();
+
+  // nodes attached by the previous life, including its shadow
+  for (const std::shared_ptr<SceneNode>& child : std::vector<std::shared_ptr<SceneNode>>(childNodes)) {
+    RemoveNode(child);
+  }
+
+  ClearTexture();
+  RevokeShader();
+  setPosition(0.f, 0.f);
+  setOrigin(0.f, 0.f);
+  setScale(1.f, 1.f);
+  setRotation(0.f);
+  SetLayer(0);
+  EnableParentShader(false);
+
+  palette = basePalette = nullptr;
+  swapPalette = false;
+  facing = direction = previousDirection = Direction::none;
+  elevation = currJumpHeight = 0.f;
+  alpha = 255;
+  counterFrameFlag = 0;
+  mode = Battle::TileHighlight::none;
+  baseColor = sf::Color(255, 255, 255, 255);
+  SetDefaultVisuals();
+
+  setColor(NoopCompositeColor(GetColorMode()));
+  Reveal();
+}
+
 void Entity::Init() {
   hasInit = true;
 }
@@ -522,20 +628,20 @@ void Entity::draw(sf::RenderTarget& target, sf::RenderStates states) const
 
   states.transform *= combinedTransform;
 
-  std::vector<SceneNode*> copies;
-  copies.reserve(childNodes.size() + 1);
-
-  for (std::shared_ptr<SceneNode>& child : childNodes) {
-    copies.push_back(child.get());
-  }
+  SortChildren();
 
-  copies.push_back((SceneNode*)this);
-
-  std::sort(copies.begin(), copies.end(), [](SceneNode* a, SceneNode* b) { return (a->GetLayer() > b->GetLayer()); });
+  // children are in draw order. This entity is drawn before the first child on a lower layer
+  const std::size_t selfIndex = static_cast<std::size_t>(std::find_if(childNodes.begin(), childNodes.end(), [this](const std::shared_ptr<SceneNode>& child) {
+    return child->GetLayer() < GetLayer();
+  }) - childNodes.begin());
 
   // draw its children
-  for (std::size_t i = 0; i < copies.size(); i++) {
-    SceneNode* currNode = copies[i];
+  for (std::size_t i = 0; i <= childNodes.size(); i++) {
+    SceneNode* currNode = (SceneNode*)this;
+
+    if (i != selfIndex) {
+      currNode = childNodes[i < selfIndex ? i : i - 1].get();
+    }
 
     if (!currNode) continue;
 
@@ -609,10 +715,10 @@ int Entity::GetAlpha()
   return getColor().a;
 }
 
-bool Entity::Teleport(Battle::Tile* dest, ActionOrder order, std::function<void()> onBegin) {
+bool Entity::Teleport(Battle::Tile* dest, ActionOrder order, MoveCallback onBegin) {
   if (dest && CanMoveTo(dest)) {
     frame_time_t endlagDelay = moveEndlagDelay ? *moveEndlagDelay : frame_time_t{};
-    MoveEvent event = { 0, moveStartupDelay, endlagDelay, 0, dest, onBegin };
+    MoveEvent event = { 0, moveStartupDelay, endlagDelay, 0, dest, std::move(onBegin) };
     actionQueue.Add(event, order, ActionDiscardOp::until_eof);
 
     return true;
@@ -622,11 +728,11 @@ bool Entity::Teleport(Battle::Tile* dest, ActionOrder order, std::function<void(
 }
 
 bool Entity::Slide(Battle::Tile* dest, 
-  const frame_time_t& slideTime, const frame_time_t& endlag, ActionOrder order, std::function<void()> onBegin)
+  const frame_time_t& slideTime, const frame_time_t& endlag, ActionOrder order, MoveCallback onBegin)
 {
   if (dest && CanMoveTo(dest)) {
     frame_time_t endlagDelay = moveEndlagDelay ? *moveEndlagDelay : endlag;
-    MoveEvent event = { slideTime, moveStartupDelay, endlagDelay, 0, dest, onBegin };
+    MoveEvent event = { slideTime, moveStartupDelay, endlagDelay, 0, dest, std::move(onBegin) };
     actionQueue.Add(event, order, ActionDiscardOp::until_eof);
 
     return true;
@@ -636,13 +742,13 @@ bool Entity::Slide(Battle::Tile* dest,
 }
 
 bool Entity::Jump(Battle::Tile* dest, float destHeight, 
-  const frame_time_t& jumpTime, const frame_time_t& endlag, ActionOrder order, std::function<void()> onBegin)
+  const frame_time_t& jumpTime, const frame_time_t& endlag, ActionOrder order, MoveCallback onBegin)
 {
   destHeight = std::max(destHeight, 0.f); // no negative jumps
 
   if (dest && CanMoveTo(dest)) {
     frame_time_t endlagDelay = moveEndlagDelay ? *moveEndlagDelay : endlag;
-    MoveEvent event = { jumpTime, moveStartupDelay, endlagDelay, destHeight, dest, onBegin };
+    MoveEvent event = { jumpTime, moveStartupDelay, endlagDelay, destHeight, dest, std::move(onBegin) };
     actionQueue.Add(event, order, ActionDiscardOp::until_eof);
 
     return true;
@@ -966,6 +1072,7 @@ void Entity::FreeAllComponents()
   ReleaseComponentsPendingRemoval();
 
   components.clear();
+  InvalidateComponentCache();
 }
 
 const EventBus::Channel& Entity::EventChannel() const
@@ -1016,6 +1123,14 @@ std::shared_ptr<Component> Entity::RegisterComponent(std::shared_ptr<Component>
   return c;
 }
 
+std::shared_ptr<Component> Entity::ReattachComponent(std::shared_ptr<Component> c) {
+  if (c == nullptr) return nullptr;
+
+  c->owner = weak_from_this();
+
+  return RegisterComponent(c);
+}
+
 void Entity::UpdateMoveStartPosition()
 {
   if (tile) {
@@ -18,6 +18,9 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
 using std::string;
 
 #include "bnResourceHandle.h"
@@ -37,6 +40,7 @@ using std::string;
 #include "bnDefenseRule.h"
 #include "bnHitProperties.h"
 #include "stx/memory.h"
+#include "stx/inplace_function.h"
 
 namespace Battle {
   class Tile;
@@ -46,13 +50,15 @@ namespace Battle {
 class Field;
 class BattleSceneBase; // forward decl
 
+using MoveCallback = stx::inplace_function<void()>;
+
 struct MoveEvent {
   frame_time_t deltaFrames{}; //!< Frames between tile A and B. If 0, teleport. Else, we could be sliding
   frame_time_t delayFrames{}; //!< Startup lag to be used with animations
   frame_time_t endlagFrames{}; //!< Wait period before action is complete
   float height{}; //!< If this is non-zero with delta frames, the character will effectively jump
   Battle::Tile* dest{ nullptr };
-  std::function<void()> onBegin = []{};
+  MoveCallback onBegin; //!< Called once when the move starts
   bool immutable{ false }; //!< Some move events cannot be cancelled or interupted
 
   //!< helper function true if jumping
@@ -109,6 +115,7 @@ public:
   friend class Field;
   friend class Component;
   friend class BattleSceneBase;
+  friend class EntityPool;
 
   enum class Shadow : char {
     none = 0,
@@ -125,7 +132,9 @@ private:
   bool hasSpawned{ false }; /*!< Flag toggles true when the entity is first placed onto the field. Calls OnSpawn(). */
   bool isUpdating{ false }; /*!< If an entity has updated once this frame, skip some update routines */
   bool manualDelete{ false }; /* HACK: prevent network pawns from deleting until they report their HP as zero */
+  bool pooled{ false }; /*!< Built by an EntityPool and recycled after it is erased */
   unsigned moveEventFrame{};
+  size_t updatedOnTick{}; /*!< Field update tick this entity last updated on */
   unsigned frame{};
   float currJumpHeight{};
   float height{}; /*!< Height of the entity relative to tile floor. Used for visual effects like projectiles or for hitbox detection */
@@ -139,12 +148,19 @@ private:
    * @param ID ID of the component to remove
    */
   void SortComponents();
+  void InvalidateComponentCache();
   void ClearPendingComponents();
   void ReleaseComponentsPendingRemoval();
   void InsertComponentsPendingRegistration();
   void UpdateMovement(double elapsed);
   void SetFrame(unsigned frame);
   void ShiftShadow();
+
+  /**
+   * @brief Sets the color mode, the battle shader and an empty hidden shadow node
+   */
+  void SetDefaultVisuals();
+
 public:
   Entity();
   virtual ~Entity();
@@ -166,6 +182,11 @@ public:
    */
   bool HasInit();
 
+  /**
+   * @brief Query if this entity was built by an EntityPool and will be recycled once erased
+   */
+  const bool IsPooled() const;
+
   /**
    * @brief Initializes Entity since std::shared_from_this<>() cannot call virtual methods in constructors
    */
@@ -190,9 +211,9 @@ public:
    * 
    * @warning This doesn't mean that the entity will successfully move just that they could at the time
    */
-  bool Teleport(Battle::Tile* dest, ActionOrder order = ActionOrder::voluntary, std::function<void()> onBegin = [] {});
-  bool Slide(Battle::Tile* dest, const frame_time_t& slideTime, const frame_time_t& endlag, ActionOrder order = ActionOrder::voluntary, std::function<void()> onBegin = [] {});
-  bool Jump(Battle::Tile* dest, float destHeight, const frame_time_t& jumpTime, const frame_time_t& endlag, ActionOrder order = ActionOrder::voluntary, std::function<void()> onBegin = [] {});
+  bool Teleport(Battle::Tile* dest, ActionOrder order = ActionOrder::voluntary, MoveCallback onBegin = nullptr);
+  bool Slide(Battle::Tile* dest, const frame_time_t& slideTime, const frame_time_t& endlag, ActionOrder order = ActionOrder::voluntary, MoveCallback onBegin = nullptr);
+  bool Jump(Battle::Tile* dest, float destHeight, const frame_time_t& jumpTime, const frame_time_t& endlag, ActionOrder order = ActionOrder::voluntary, MoveCallback onBegin = nullptr);
   void FinishMove();
   bool RawMoveEvent(const MoveEvent& event, ActionOrder order = ActionOrder::voluntary);
   void HandleMoveEvent(MoveEvent& event, const ActionQueue::ExecutionType& exec);
@@ -460,6 +481,8 @@ public:
    /**
    * @brief Get all components that matches the exact Type
    * @return vector of specified components
+   *
+   * The vector is a copy of the cached list so components can be registered or freed while it is walked
    */
   template<typename ComponentType>
   std::vector<std::shared_ptr<ComponentType>> GetComponents() const;
@@ -467,10 +490,28 @@ public:
   /**
 * @brief Get all components that inherit BaseType
 * @return vector of related components
+*
+* The vector is a copy of the cached list so components can be registered or freed while it is walked
 */
   template<typename BaseType>
   std::vector<std::shared_ptr<BaseType>> GetComponentsDerivedFrom() const;
 
+  /**
+   * @brief Calls func(const std::shared_ptr<ComponentType>&) for every component that matches the exact Type
+   *
+   * Walks the cached list without copying it. Components registered or freed by func
+   * do not change the walk, freed components stay alive until it ends.
+   */
+  template<typename ComponentType, typename Func>
+  void ForEachComponent(Func&& func) const;
+
+  /**
+   * @brief Calls func(const std::shared_ptr<BaseType>&) for every component that inherits BaseType
+   * @see ForEachComponent()
+   */
+  template<typename BaseType, typename Func>
+  void ForEachComponentDerivedFrom(Func&& func) const;
+
   /**
   * @brief Check if entity is a specialized type
   * @return true if entity could be dynamically casted to Type
@@ -494,6 +535,13 @@ public:
   */
   std::shared_ptr<Component> RegisterComponent(std::shared_ptr<Component> c);
 
+  /**
+  * @brief Attaches a component a pooled entity kept from its previous life
+  * @param c the component to add. Its owner is moved to this life.
+  * @return Returns the component as a pointer of the common base class type
+  */
+  std::shared_ptr<Component> ReattachComponent(std::shared_ptr<Component> c);
+
   /**
    * @brief Frees one component with the same ID
    * @param ID ID of the component to remove
@@ -738,6 +786,16 @@ public:
   void ManualDelete();
 
 protected:  
+  /**
+   * @brief Restores the base Entity state so a pooled entity can be spawned again
+   *
+   * Assigns a new ID so stale references to the previous life do not resolve.
+   * Every member is restored to the value a newly built Entity has, including child nodes,
+   * visuals, team, element, health, defense rules, status callbacks and hit listeners.
+   * Subclasses that change these in their constructor override this to apply their defaults again.
+   */
+  virtual void ResetPooledState();
+
   Battle::Tile* tile{ nullptr }; /*!< Current tile pointer */
   Battle::Tile* previous{ nullptr }; /*!< Entities retain a previous pointer in case they need to be moved back */
   sf::Vector2f tileOffset{ 0,0 }; /*!< complete motion is captured by `tile_pos + tileOffset`*/
@@ -771,6 +829,63 @@ protected:
   };
   std::list<ComponentBucket> queuedComponents;
 
+  /**
+   * @brief Cached lookup list of components for one type id
+   *
+   * Lists are built the first time a type is queried and rebuilt lazily
+   * after the component list changes. Stale lists are cleared right away
+   * so they do not keep freed components alive, unless they are being walked.
+   * A list being walked is left untouched until the last walk ends.
+   *
+   * References to the lists never leave the entity. Callers get copies or walk them with ForEachComponent().
+   */
+  struct ComponentTypeCache {
+    virtual ~ComponentTypeCache() = default;
+    virtual void Clear() = 0;
+    size_t version{};
+    unsigned walks{}; /*!< ForEachComponent() calls using the list */
+  };
+
+  template<typename T>
+  struct TypedComponentCache : ComponentTypeCache {
+    std::vector<std::shared_ptr<T>> list;
+    void Clear() override { list.clear(); }
+  };
+
+  using ComponentCacheMap = std::unordered_map<std::type_index, std::unique_ptr<ComponentTypeCache>>;
+  size_t componentsVersion{ 1 }; /*!< Bumped each time `components` changes */
+  mutable ComponentCacheMap componentsByType; /*!< Components that match a type exactly */
+  mutable ComponentCacheMap componentsByBase; /*!< Components that derive from a base type */
+
+  template<typename T>
+  TypedComponentCache<T>& GetComponentCache(ComponentCacheMap& map) const;
+
+  /**
+   * @brief The cache of components that match the exact Type, rebuilt if it is stale
+   * @warning still stale if the list is being walked. Check the version before using it.
+   */
+  template<typename ComponentType>
+  TypedComponentCache<ComponentType>& CachedComponents() const;
+
+  /**
+   * @brief The cache of components that inherit BaseType, rebuilt if it is stale
+   * @warning still stale if the list is being walked. Check the version before using it.
+   */
+  template<typename BaseType>
+  TypedComponentCache<BaseType>& CachedComponentsDerivedFrom() const;
+
+  template<typename ComponentType>
+  void CollectComponents(std::vector<std::shared_ptr<ComponentType>>& out) const;
+
+  template<typename BaseType>
+  void CollectComponentsDerivedFrom(std::vector<std::shared_ptr<BaseType>>& out) const;
+
+  /**
+   * @brief Calls func for every entry of an up to date cache. The list is not modified until the walk ends.
+   */
+  template<typename T, typename Func>
+  void WalkComponentCache(TypedComponentCache<T>& cache, Func& func) const;
+
   const int GetMoveCount() const; /*!< Total intended movements made. Used to calculate rank*/
 
   /**
@@ -826,6 +941,15 @@ protected:
    */
   virtual void OnUpdate(double _elapsed) {};
 
+  /**
+  * @brief Reset hook for pooled entities before they are handed out again
+  *
+  * The base Entity state has already been restored and Init() will be called again.
+  * Restore anything else set by the constructor, including the layer, texture and scale.
+  * Components kept in members can be attached again in Init() with ReattachComponent().
+  */
+  virtual void OnPoolReset() { };
+
 private:
   bool ignoreCommonAggressor{};
   bool hasInit{};
@@ -877,12 +1001,31 @@ private:
   void UpdateMoveStartPosition();
 };
 
+template<typename T>
+inline Entity::TypedComponentCache<T>& Entity::GetComponentCache(ComponentCacheMap& map) const
+{
+  std::unique_ptr<ComponentTypeCache>& entry = map[std::type_index(typeid(T))];
+
+  if (!entry) {
+    entry = std::make_unique<TypedComponentCache<T>>();
+  }
+
+  return static_cast<TypedComponentCache<T>&>(*entry);
+}
+
 template<typename ComponentType>
 inline std::shared_ptr<ComponentType> Entity::GetFirstComponent() const
 {
-  for (auto& component : components) {
+  TypedComponentCache<ComponentType>& cache = CachedComponents<ComponentType>();
+
+  if (cache.version == componentsVersion) {
+    return cache.list.empty() ? nullptr : cache.list.front();
+  }
+
+  // the cache is being walked and cannot be rebuilt
+  for (const std::shared_ptr<Component>& component : components) {
     if (typeid(*component) == typeid(ComponentType)) {
-      return std::dynamic_pointer_cast<ComponentType>(component);
+      return std::static_pointer_cast<ComponentType>(component);
     }
   }
 
@@ -892,32 +1035,132 @@ inline std::shared_ptr<ComponentType> Entity::GetFirstComponent() const
 template<typename ComponentType>
 inline std::vector<std::shared_ptr<ComponentType>> Entity::GetComponents() const
 {
-  auto res = std::vector<std::shared_ptr<ComponentType>>();
+  TypedComponentCache<ComponentType>& cache = CachedComponents<ComponentType>();
 
-  for (auto& component : components) {
-    if (typeid(*component) == typeid(ComponentType)) {
-      res.push_back(std::dynamic_pointer_cast<ComponentType>(component));
-    }
+  if (cache.version == componentsVersion) {
+    return cache.list;
   }
 
+  std::vector<std::shared_ptr<ComponentType>> res;
+  CollectComponents(res);
   return res;
 }
 
-
 template<typename BaseType>
 inline std::vector<std::shared_ptr<BaseType>> Entity::GetComponentsDerivedFrom() const
 {
-  auto res = std::vector<std::shared_ptr<BaseType>>();
+  TypedComponentCache<BaseType>& cache = CachedComponentsDerivedFrom<BaseType>();
+
+  if (cache.version == componentsVersion) {
+    return cache.list;
+  }
+
+  std::vector<std::shared_ptr<BaseType>> res;
+  CollectComponentsDerivedFrom(res);
+  return res;
+}
+
+template<typename ComponentType, typename Func>
+inline void Entity::ForEachComponent(Func&& func) const
+{
+  TypedComponentCache<ComponentType>& cache = CachedComponents<ComponentType>();
+
+  if (cache.version == componentsVersion) {
+    WalkComponentCache(cache, func);
+    return;
+  }
+
+  // an outer walk holds a stale list
+  for (const std::shared_ptr<ComponentType>& component : GetComponents<ComponentType>()) {
+    func(component);
+  }
+}
+
+template<typename BaseType, typename Func>
+inline void Entity::ForEachComponentDerivedFrom(Func&& func) const
+{
+  TypedComponentCache<BaseType>& cache = CachedComponentsDerivedFrom<BaseType>();
+
+  if (cache.version == componentsVersion) {
+    WalkComponentCache(cache, func);
+    return;
+  }
+
+  // an outer walk holds a stale list
+  for (const std::shared_ptr<BaseType>& component : GetComponentsDerivedFrom<BaseType>()) {
+    func(component);
+  }
+}
+
+template<typename T, typename Func>
+inline void Entity::WalkComponentCache(TypedComponentCache<T>& cache, Func& func) const
+{
+  // ends the walk even if func throws and drops the list if components changed meanwhile
+  struct Walk {
+    const Entity& entity;
+    TypedComponentCache<T>& cache;
+
+    ~Walk() {
+      if (--cache.walks == 0 && cache.version != entity.componentsVersion) {
+        cache.Clear();
+      }
+    }
+  };
+
+  cache.walks++;
+  Walk walk{ *this, cache };
+
+  for (size_t i = 0; i < cache.list.size(); i++) {
+    func(cache.list[i]);
+  }
+}
+
+template<typename ComponentType>
+inline Entity::TypedComponentCache<ComponentType>& Entity::CachedComponents() const
+{
+  TypedComponentCache<ComponentType>& cache = GetComponentCache<ComponentType>(componentsByType);
+
+  if (cache.version != componentsVersion && cache.walks == 0) {
+    cache.list.clear();
+    CollectComponents(cache.list);
+    cache.version = componentsVersion;
+  }
 
-  for (const auto& component : components) {
-    auto cast = std::dynamic_pointer_cast<BaseType>(component);
+  return cache;
+}
+
+template<typename BaseType>
+inline Entity::TypedComponentCache<BaseType>& Entity::CachedComponentsDerivedFrom() const
+{
+  TypedComponentCache<BaseType>& cache = GetComponentCache<BaseType>(componentsByBase);
 
-    if (cast) {
-      res.push_back(std::move(cast));
+  if (cache.version != componentsVersion && cache.walks == 0) {
+    cache.list.clear();
+    CollectComponentsDerivedFrom(cache.list);
+    cache.version = componentsVersion;
+  }
+
+  return cache;
+}
+
+template<typename ComponentType>
+inline void Entity::CollectComponents(std::vector<std::shared_ptr<ComponentType>>& out) const
+{
+  for (const std::shared_ptr<Component>& component : components) {
+    if (typeid(*component) == typeid(ComponentType)) {
+      out.push_back(std::static_pointer_cast<ComponentType>(component));
     }
   }
+}
 
-  return res;
+template<typename BaseType>
+inline void Entity::CollectComponentsDerivedFrom(std::vector<std::shared_ptr<BaseType>>& out) const
+{
+  for (const std::shared_ptr<Component>& component : components) {
+    if (auto cast = std::dynamic_pointer_cast<BaseType>(component)) {
+      out.push_back(std::move(cast));
+    }
+  }
 }
 
 template<typename Type>
@@ -0,0 +1,67 @@
+#include "bnEntityPool.h"
+#include <iterator>
+
+EntityPool::EntityPool(size_t capacity) : shared(std::make_shared<Shared>())
+{
+  shared->capacity = capacity;
+}
+
+void EntityPool::Recycler::operator()(Entity* entity) const
+{
+  std::shared_ptr<Shared> state = shared.lock();
+
+  if (!state) {
+    delete entity;
+    return;
+  }
+
+  Bucket& bucket = state->buckets[std::type_index(typeid(*entity))];
+
+  if (bucket.free.size() >= state->capacity) {
+    delete entity;
+    return;
+  }
+
+  bucket.free.emplace_back(entity);
+  bucket.stats.released++;
+}
+
+const EntityPool::Stats EntityPool::GetStats() const
+{
+  Stats total;
+
+  for (auto& [type, bucket] : shared->buckets) {
+    total.created += bucket.stats.created;
+    total.reused += bucket.stats.reused;
+    total.released += bucket.stats.released;
+    total.available += bucket.free.size();
+  }
+
+  return total;
+}
+
+void EntityPool::SetCapacity(size_t capacity)
+{
+  shared->capacity = capacity;
+
+  // destroying an entity can release others back to the buckets
+  // so nothing is destroyed until the buckets are no longer walked
+  std::vector<std::unique_ptr<Entity>> extra;
+
+  for (auto& [type, bucket] : shared->buckets) {
+    while (bucket.free.size() > capacity) {
+      extra.push_back(std::move(bucket.free.back()));
+      bucket.free.pop_back();
+    }
+  }
+}
+
+void EntityPool::Clear()
+{
+  std::vector<std::unique_ptr<Entity>> idle;
+
+  for (auto& [type, bucket] : shared->buckets) {
+    std::move(bucket.free.begin(), bucket.free.end(), std::back_inserter(idle));
+    bucket.free.clear();
+  }
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include "bnEntity.h"
+
+/**
+ * @class EntityPool
+ * @brief Recycles short-lived entities such as hit effects, explosions and hitboxes
+ *
+ * Entities built by the pool are flagged as pooled. Once the last strong reference to a
+ * pooled entity is dropped it is handed back to the pool instead of being destroyed.
+ * The next Acquire() for the same type restores the base Entity state and calls the
+ * entity's reset hook instead of building a new entity, loading its textures and parsing its animations.
+ *
+ * Types with constructor arguments must provide a public `OnPoolReset(Args...)` taking
+ * the same arguments and defaults. Types without constructor arguments can override Entity::OnPoolReset().
+ *
+ * Every life of an entity is handed out with its own reference count. Weak references
+ * kept from a previous life, such as the handles held by scripts, expire when it is
+ * recycled and never resolve to the next life.
+ */
+class EntityPool {
+public:
+  struct Stats {
+    size_t created{}; /*!< Entities built because nothing could be recycled */
+    size_t reused{}; /*!< Entities handed out again after a reset */
+    size_t released{}; /*!< Entities returned to the pool after their last reference was dropped */
+    size_t available{}; /*!< Entities waiting to be recycled */
+  };
+
+  static constexpr size_t DEFAULT_CAPACITY = 32;
+
+  EntityPool(size_t capacity = DEFAULT_CAPACITY);
+  ~EntityPool() = default;
+
+  /**
+   * @brief Recycles an entity of type T or builds a new one with `args`
+   * @return a pooled entity that has not been initialized or spawned
+   */
+  template<typename T, typename... Args>
+  std::shared_ptr<T> Acquire(Args&&... args);
+
+  /**
+   * @brief Statistics for one type
+   */
+  template<typename T>
+  const Stats GetStats() const;
+
+  /**
+   * @brief Statistics summed over every type
+   */
+  const Stats GetStats() const;
+
+  /**
+   * @brief Max number of idle entities kept per type
+   */
+  void SetCapacity(size_t capacity);
+
+  /**
+   * @brief Drops all idle entities
+   */
+  void Clear();
+
+private:
+  struct Bucket {
+    std::vector<std::unique_ptr<Entity>> free;
+    Stats stats;
+  };
+
+  /**
+   * @brief Idle entities. Entities still alive when the pool is destroyed are deleted normally.
+   */
+  struct Shared {
+    size_t capacity{};
+    std::unordered_map<std::type_index, Bucket> buckets;
+  };
+
+  /**
+   * @brief Deleter of every entity handed out. Returns the entity to its bucket if there is room.
+   */
+  struct Recycler {
+    std::weak_ptr<Shared> shared;
+
+    void operator()(Entity* entity) const;
+  };
+
+  std::shared_ptr<Shared> shared;
+};
+
+template<typename T, typename... Args>
+inline std::shared_ptr<T> EntityPool::Acquire(Args&&... args)
+{
+  Bucket& bucket = shared->buckets[std::type_index(typeid(T))];
+
+  if (!bucket.free.empty()) {
+    // a new control block so nothing from the previous life can lock this one
+    std::shared_ptr<T> entity(static_cast<T*>(bucket.free.back().release()), Recycler{ shared });
+    bucket.free.pop_back();
+
+    entity->ResetPooledState();
+    entity->OnPoolReset(std::forward<Args>(args)...);
+
+    bucket.stats.reused++;
+    return entity;
+  }
+
+  std::shared_ptr<T> entity(new T(std::forward<Args>(args)...), Recycler{ shared });
+  entity->pooled = true;
+  bucket.stats.created++;
+  return entity;
+}
+
+template<typename T>
+inline const EntityPool::Stats EntityPool::GetStats() const
+{
+  auto iter = shared->buckets.find(std::type_index(typeid(T)));
+
+  if (iter == shared->buckets.end()) {
+    return Stats{};
+  }
+
+  Stats stats = iter->second.stats;
+  stats.available = iter->second.free.size();
+  return stats;
+}
@@ -1,115 +1,154 @@
 #pragma once
 
-#include <list>
 #include <functional>
 #include <memory>
-#include <map>
+#include <vector>
 #include <algorithm>
 
-#ifndef __APPLE__
-#include <any>
-#define any_cast std::any_cast
-using any = std::any;
-#else
-#include "stx/any.h"
-#define any_cast stx::any_cast
-using any = stx::any;
-#endif
-
 class Scene; // forward decl
 
-namespace {
-  // utility function to compare the input type with std::any
-  auto any_compare = [](auto&& i) {
-    return [i](auto&& val) {
-      return typeid(i) == val.type() && any_cast<decltype(i)>(val) == i;
-    };
-  };
-}
-
 /*! \file  bnEventBus.h
  *  \brief Emit functions to registered objects anywhere in the game
  *
  * How It Is Organized:
- * This event bus is a little barbaric but functional and fufills its purpose.
- * EventBus delcares a hash of recievers in the global memory space.
- * The recievers themselves are another hash of typename strings and a list of std::any objects.
- * When a scene registers an object will be placed into the list identified by the typename hash.
+ * Every receiver type T has its own list of receivers in the global memory space.
+ * The list is a static inside of a function template so it is found at compile time.
+ * Each entry of the list remembers the Scene address of the channel it was registered on.
  * Each scene can make a unique channel that divides the recievers by Scene addresses in memory.
- * 
+ *
  * How It Works:
- * When an event is emitted, the reciever hash will be identified by the current scene address
- * represented by the Channel class. If one exists, the typename of the function-owning class
- * is inspected for a list. If the list is found, an iterative lookup will try and find the
- * correct std::any object and cast it before invoking the requested member function with the 
- * supplied arguments.
- * 
+ * When an event is emitted, the list for the class that owns the member function is visited
+ * and the function is invoked on every object registered with the same Scene address.
+ * Emitting does not allocate and does not look anything up by name.
+ *
+ * Subscribe() returns a Subscription that drops the object when the subscription is destroyed.
+ * Owners should keep the Subscription next to the object so they go out of scope together.
+ *
  * Caveats:
- * This event bus is in the global memory space and is not threadsafe nor is it safe from
- * invalid pointers and segfaults that come with them. 
- * 
- * If a registered object is deleted or goes out of scope, and not dropped beforehand, the event bus will crash
- * 
- * A wrapper class of some type e.g. Reciever<T> could be used as CRTP to remove itself from the 
- * recievers in the deconstructor and only those types could be registered to prevent nullptrs
+ * This event bus is in the global memory space and is not threadsafe.
+ *
+ * Objects added with Register() instead of Subscribe() must be Drop()-ed before they are deleted
  */
 
 class EventBus final {
-  //!< Recievers represents all channels and objects lists that may recieve events
-  static inline std::map<const Scene*, std::map<std::string, std::vector<any>>> receivers;
+  template<typename T>
+  struct Receiver {
+    const Scene* scene{ nullptr };
+    T* obj{ nullptr };
+  };
+
+  /**
+  * @brief The list of receivers of type T for all channels
+  */
+  template<typename T>
+  static std::vector<Receiver<T>>& Receivers() {
+    static std::vector<Receiver<T>> receivers;
+    return receivers;
+  }
+
+  /**
+  * @brief One function per receiver type that removes the scene's receivers of that type
+  */
+  static std::vector<void(*)(const Scene*)>& Clearers() {
+    static std::vector<void(*)(const Scene*)> clearers;
+    return clearers;
+  }
+
+  template<typename T>
+  static void ClearType(const Scene* scene) {
+    auto& list = Receivers<T>();
+    list.erase(std::remove_if(list.begin(), list.end(), [scene](const Receiver<T>& r) { return r.scene == scene; }), list.end());
+  }
+
+  template<typename T>
+  static void Insert(const Scene* scene, T* obj) {
+    // the first time this type is used, remember how to clear it
+    static const bool clearable = (Clearers().push_back(&ClearType<T>), true);
+    (void)clearable;
+
+    auto& list = Receivers<T>();
+    auto iter = std::find_if(list.begin(), list.end(), [scene, obj](const Receiver<T>& r) {
+      return r.scene == scene && r.obj == obj;
+    });
+
+    if (iter == list.end()) {
+      list.push_back(Receiver<T>{ scene, obj });
+    }
+  }
+
+  template<typename T>
+  static void Remove(const Scene* scene, T* obj) {
+    auto& list = Receivers<T>();
+
+    auto iter = std::find_if(list.begin(), list.end(), [scene, obj](const Receiver<T>& r) {
+      return r.scene == scene && r.obj == obj;
+    });
+
+    if (iter != list.end()) {
+      list.erase(iter);
+    }
+  }
 
 public:
-  class Channel {
-    //!< The Scene address this channel represents
-    // It is assumed the lifetime will live on beyond the channel and
-    // the address represents a unique scene ptr
-    const Scene* scene{ nullptr }; 
+  /**
+  * @class Subscription
+  * @brief Drops the subscribed object from its channel when destroyed. Move only.
+  */
+  class Subscription {
+    const Scene* scene{ nullptr };
+    void* obj{ nullptr };
+    void(*drop)(const Scene*, void*){ nullptr };
 
-    /**
-    * @brief Attempts to insert an item, obj of type T*, into the typename hash
-    * @param map typename hash
-    * @param typeStr the typid of obj as std::string
-    * @param obj to be added into the list
-    * 
-    * If the typename hash does not exist, it will create one
-    * If the item is discovered in the list of objects, it will not be re-added
-    */
     template<typename T>
-    void try_insert_item(std::map<std::string, std::vector<any>>& map,
-      std::string typeStr, T* obj) {
-      if (obj == nullptr) return;
+    static void DropAs(const Scene* scene, void* obj) {
+      EventBus::Remove(scene, static_cast<T*>(obj));
+    }
 
-      auto& vec = map[typeStr];
+  public:
+    Subscription() = default;
 
-      auto vecIter = std::find_if(vec.begin(), vec.end(), ::any_compare(obj));
+    template<typename T>
+    Subscription(const Scene* scene, T* obj) : scene(scene), obj(obj), drop(&DropAs<T>) {}
 
-      if (vecIter == vec.end()) {
-        vec.push_back(obj);
-      }
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    Subscription(Subscription&& rhs) noexcept {
+      *this = std::move(rhs);
     }
 
-    /**
-    * @brief Attempts to remove an item, obj of type T*, out of the typename hash
-    * @param map typename hash
-    * @param typeStr the typid of obj as std::string
-    * @param obj to be removed into the list
-    *
-    * If the typename hash does not exist, it will create one
-    * If the item is discovered in the list of objects, it is erased
-    */
-    template<typename T>
-    void try_remove_item(std::map<std::string, std::vector<any>>& map,
-      std::string typeStr, T* obj) {
-      if (obj == nullptr) return;
+    Subscription& operator=(Subscription&& rhs) noexcept {
+      if (this != &rhs) {
+        Reset();
+        scene = rhs.scene;
+        obj = rhs.obj;
+        drop = rhs.drop;
+        rhs.drop = nullptr;
+      }
 
-      auto& vec = map[typeStr];
+      return *this;
+    }
 
-      auto vecIter = std::find_if(vec.begin(), vec.end(), ::any_compare(obj));
+    ~Subscription() {
+      Reset();
+    }
 
-      if (vecIter != vec.end()) {
-        vec.erase(vecIter);
+    /**
+    * @brief Drops the object now instead of waiting for the destructor
+    */
+    void Reset() {
+      if (drop) {
+        drop(scene, obj);
+        drop = nullptr;
       }
     }
+  };
+
+  class Channel {
+    //!< The Scene address this channel represents
+    // It is assumed the lifetime will live on beyond the channel and
+    // the address represents a unique scene ptr
+    const Scene* scene{ nullptr };
 
   public:
     Channel() = delete;
@@ -118,66 +157,60 @@ public:
     * @brief constructs a new channel using the scene pointer to differentiate it from other channels
     * @param s of type Scene*
     */
-    Channel(const Scene* s) : scene(s) {
-      if (scene == nullptr) return;
-
-      auto mapIter = receivers.find(scene);
-
-      if (mapIter == receivers.end()) {
-        receivers.insert(std::make_pair(s, std::map<std::string, std::vector<any>>()));
-      }
-    }
+    Channel(const Scene* s) : scene(s) { }
 
     /**
     * @brief copies a channel
     */
     Channel(const Channel& rhs) : scene(rhs.scene) { }
 
+    /**
+    * @brief Subscribes an object for events until the returned Subscription is destroyed
+    * @param obj of type T*
+    * @return Subscription that drops obj. An empty Subscription if this channel has no scene.
+    */
+    template<typename T>
+    [[nodiscard]] Subscription Subscribe(T* obj) {
+      if (scene == nullptr || obj == nullptr) return Subscription();
+
+      EventBus::Insert(scene, obj);
+      return Subscription(scene, obj);
+    }
+
     /**
     * @brief Registers a varadic list of object pointers subscribing for events
     * @param args of type typename... Args
-    * @warning if an object is deleted or goes out of scope, it needs to be Drop()-ed beforehand
+    * @warning if an object is deleted or goes out of scope, it needs to be Drop()-ed beforehand.
+    *          Prefer Subscribe().
     */
     template<typename... Args>
     void Register(Args*... args) {
       if (scene == nullptr) return;
 
-      auto mapIter = receivers.find(scene);
-
-      if (mapIter != receivers.end()) {
-        auto& typenameMap = mapIter->second;
-        (try_insert_item(typenameMap, typeid(args).name(), args), ...);
-      }
+      ((args ? EventBus::Insert(scene, args) : void()), ...);
     }
 
     /**
     * @brief Drops a varadic list of object pointers
     * @param args of type typename... Args
-    * 
+    *
     * if no such object exists in the channel, nothing will happen for that object
     */
     template<typename... Args>
     void Drop(Args*... args) {
       if (scene == nullptr) return;
 
-      auto mapIter = receivers.find(scene);
-
-      if (mapIter != receivers.end()) {
-        auto& typenameMap = mapIter->second;
-        (try_remove_item(typenameMap, typeid(args).name(), args), ...);
-      }
+      ((args ? EventBus::Remove(scene, args) : void()), ...);
     }
 
     /**
-    * @brief Clears the typename hash which in turn forgets about all subscribed object pointers
-    * 
+    * @brief Forgets about all object pointers subscribed to this channel
+    *
     * Useful for scenes that are about to be destroyed in memory
     */
     void Clear() {
-      auto mapIter = receivers.find(scene);
-
-      if (mapIter != receivers.end()) {
-        mapIter->second.clear();
+      for (auto clear : Clearers()) {
+        clear(scene);
       }
     }
 
@@ -186,26 +219,22 @@ public:
     * @param Func, member-function pointer
     * @param args of type typename... Args
     * @warning If there is a dangling invalid obj pointer in the channel, this will crash
-    * 
+    *
     * Because Channels are separated by their respective Scene addresses, only those objects registered
     * to that channel will invoke their matching functions.
     */
     template<typename R, typename Class, typename... FuncArgs, typename... Args>
     void Emit(R(Class::* Func)(FuncArgs...), Args&&... args) const {
-      auto mapIter = receivers.find(scene);
+      if (scene == nullptr) return;
+
+      auto& list = Receivers<Class>();
 
-      if (mapIter != receivers.end()) {
-        std::string typeStr = typeid(Class*).name();
-        auto typenameIter = mapIter->second.find(typeStr);
+      // receivers may drop themselves while handling the event
+      for (size_t i = 0; i < list.size(); i++) {
+        if (list[i].scene != scene) continue;
 
-        if (typenameIter != mapIter->second.end()) {
-          for (auto any : typenameIter->second) {
-            (any_cast<Class*>(any)->*Func)(std::forward<decltype(args)>(args)...);
-          }
-        }
+        (list[i].obj->*Func)(std::forward<decltype(args)>(args)...);
       }
     }
   };
 };
-
-#undef any_cast
\ No newline at end of file
@@ -35,12 +35,30 @@ Explosion::Explosion(const Explosion & copy) : Artifact()
   SetOffsetArea(copy.offsetArea);
 }
 
+void Explosion::OnPoolReset(int _numOfExplosions, double _playbackSpeed)
+{
+  root = this;
+  SetLayer(-1000);
+  numOfExplosions = _numOfExplosions;
+  playbackSpeed = _playbackSpeed;
+  count = 0;
+  offset = offsetArea = sf::Vector2f{};
+  setTexture(Textures().LoadFromFile(TexturePaths::MOB_EXPLOSION));
+  setScale(2.f, 2.f);
+}
+
 void Explosion::Init() {
   Artifact::Init();
 
-  animationComponent = CreateComponent<AnimationComponent>(weak_from_this());
-  animationComponent->SetPath("resources/scenes/battle/mob_explosion.animation");
-  animationComponent->Reload();
+  // recycled explosions keep the animation they already loaded
+  if (animationComponent) {
+    ReattachComponent(animationComponent);
+  }
+  else {
+    animationComponent = CreateComponent<AnimationComponent>(weak_from_this());
+    animationComponent->SetPath("resources/scenes/battle/mob_explosion.animation");
+    animationComponent->Reload();
+  }
 
   Audio().Play(AudioType::EXPLODE, AudioPriority::low);
 
@@ -38,6 +38,11 @@ public:
   
   ~Explosion();
 
+  /**
+   * @brief Restarts the chain for recycled root explosions
+   */
+  void OnPoolReset(int _numOfExplosions=1, double _playbackSpeed=0.55);
+
   void Init() override;
 
   /**
@@ -6,6 +6,7 @@
 #include "bnTile.h"
 #include "bnTextureResourceManager.h"
 #include "battlescene/bnBattleSceneBase.h"
+#include "bnFrameArena.h"
 
 constexpr auto TILE_ANIMATION_PATH = "resources/tiles/tiles.animation";
 
@@ -89,7 +90,7 @@ int Field::GetHeight() const {
   return height;
 }
 
-Field::NotifyID_t Field::CallbackOnDelete(Entity::ID_t target, const std::function<void(std::shared_ptr<Entity>)>& callback)
+Field::NotifyID_t Field::CallbackOnDelete(Entity::ID_t target, const DeleteCallback& callback)
 {
   auto iter = entityDeleteObservers.find(target);
   Field::NotifyID_t ID = nextID;
@@ -118,7 +119,7 @@ Field::NotifyID_t Field::CallbackOnDelete(Entity::ID_t target, const std::functi
 Field::NotifyID_t Field::NotifyOnDelete(
   Entity::ID_t target,
   Entity::ID_t observer,
-  const std::function<void(std::shared_ptr<Entity>, std::shared_ptr<Entity>)>& callback
+  const DeleteNotifyCallback& callback
 ) {
   auto iter = entityDeleteObservers.find(target);
   NotifyID_t ID = {};
@@ -332,6 +333,7 @@ void Field::Update(double _elapsed) {
   // This is a state flag that decides if entities added this update tick will be
   // put into a pending queue bucket or added directly onto the field
   isUpdating = true;
+  updateTick++;
 
   int entityCount = 0;
 
@@ -348,6 +350,12 @@ void Field::Update(double _elapsed) {
     }
   }
 
+  // every tile resolved its attackers above
+  // keep the tiles that had attackers queued by the attacks themselves
+  combatWorklist.erase(std::remove_if(combatWorklist.begin(), combatWorklist.end(), [](Battle::Tile* tile) {
+    return tile->queuedAttackers.empty();
+  }), combatWorklist.end());
+
   for (int i = 0; i < tiles.size(); i++) {
     for (int j = 0; j < tiles[i].size(); j++) {
       tiles[i][j]->UpdateArtifacts(*this, _elapsed);
@@ -366,9 +374,9 @@ void Field::Update(double _elapsed) {
     }
   }
 
-  std::set<int> charCol = {}; // columns with characters in them
-  std::set<int> syncCol = {}; // synchronize columns
-  std::set<int> restCol = {}; // restore columns
+  FrameSet<int> charCol; // columns with characters in them
+  FrameSet<int> syncCol; // synchronize columns
+  FrameSet<int> restCol; // restore columns
 
   for (int i = 0; i < tiles.size(); i++) {
     for (int j = 0; j < tiles[i].size(); j++) {
@@ -496,16 +504,49 @@ void Field::Update(double _elapsed) {
     SpawnPendingEntities();
 
     // Apply new spells into this frame's combat resolution
-    for (int i = 0; i < tiles.size(); i++) {
-      for (int j = 0; j < tiles[i].size(); j++) {
-        tiles[i][j]->ExecuteAllAttacks(*this);
-      }
-    }
+    // Tiles without queued attackers have nothing to resolve, so only visit the worklist
+    ExecuteQueuedAttacks();
 
     combatEvaluationIteration--;
   }
 
-  updatedEntities.clear();
+  particles.Update(_elapsed);
+}
+
+void Field::QueueCombatEvaluation(Battle::Tile& tile)
+{
+  combatWorklist.push_back(&tile);
+}
+
+void Field::ExecuteQueuedAttacks()
+{
+  auto order = [this](Battle::Tile* tile) {
+    return tile->GetY() * (width + 2) + tile->GetX();
+  };
+
+  // A full pass visits tiles row by row. Tiles that queue attackers while this pass runs
+  // are visited in this pass if they come after the current tile, otherwise in the next one.
+  int cursor = 0;
+
+  while (true) {
+    auto next = combatWorklist.end();
+
+    for (auto iter = combatWorklist.begin(); iter != combatWorklist.end(); iter++) {
+      int index = order(*iter);
+
+      if (index >= cursor && (next == combatWorklist.end() || index < order(*next))) {
+        next = iter;
+      }
+    }
+
+    if (next == combatWorklist.end()) break;
+
+    Battle::Tile* tile = *next;
+    combatWorklist.erase(std::remove(combatWorklist.begin(), combatWorklist.end(), tile), combatWorklist.end());
+    cursor = order(tile) + 1;
+
+    tile->ExecuteAllAttacks(*this);
+  }
 }
 
 void Field::ToggleTimeFreeze(bool state)
@@ -579,12 +620,12 @@ const bool Field::HasPendingEntities() const
 
 void Field::UpdateEntityOnce(Entity& entity, const double elapsed)
 {
-  if(updatedEntities.find(entity.GetID()) != updatedEntities.end())
+  if (entity.updatedOnTick == updateTick)
       return;
 
   entity.InputState().Process();
   entity.Update(elapsed);
-  updatedEntities.insert(std::make_pair(entity.GetID(), (void*)0));
+  entity.updatedOnTick = updateTick;
 }
 
 void Field::ForgetEntity(Entity::ID_t ID)
@@ -639,6 +680,21 @@ std::shared_ptr<Character> Field::GetCharacter(Entity::ID_t ID)
   return std::dynamic_pointer_cast<Character>(GetEntity(ID));
 }
 
+const EntityPool::Stats Field::GetPoolStats() const
+{
+  return pool.GetStats();
+}
+
+EntityPool& Field::GetPool()
+{
+  return pool;
+}
+
+ParticleSystem& Field::GetParticles()
+{
+  return particles;
+}
+
 void Field::RevealCounterFrames(bool enabled)
 {
   this->revealCounterFrames = enabled;
@@ -8,6 +8,9 @@ using std::vector;
 #include "bindings/bnScriptedSpell.h"
 #include "bindings/bnScriptedObstacle.h"
 #include "bnEntity.h"
+#include "bnEntityPool.h"
+#include "bnParticleSystem.h"
+#include "stx/inplace_function.h"
 #include "bnCharacterDeletePublisher.h"
 #include "bnCharacterSpawnPublisher.h"
 
@@ -26,6 +29,8 @@ namespace Battle {
 class Field : public std::enable_shared_from_this<Field>, public CharacterDeletePublisher, public CharacterSpawnPublisher{
 public:
   using NotifyID_t = long long; // for lifetime notifiers
+  using DeleteCallback = stx::inplace_function<void(std::shared_ptr<Entity>)>; // target
+  using DeleteNotifyCallback = stx::inplace_function<void(std::shared_ptr<Entity>, std::shared_ptr<Entity>)>; // target, observer
 
   friend class Entity;
 
@@ -64,13 +69,13 @@ public:
 
   NotifyID_t CallbackOnDelete(
     Entity::ID_t target,
-    const std::function<void(std::shared_ptr<Entity>)>& callback
+    const DeleteCallback& callback
   );
 
   NotifyID_t NotifyOnDelete(
     Entity::ID_t target,
     Entity::ID_t observer,
-    const std::function<void(std::shared_ptr<Entity>, std::shared_ptr<Entity>)>& callback
+    const DeleteNotifyCallback& callback
   );
 
   void DropNotifier(NotifyID_t notifier);
@@ -91,6 +96,32 @@ public:
   AddEntityStatus AddEntity(std::shared_ptr<Entity> entity, int x, int y);
   AddEntityStatus AddEntity(std::shared_ptr<Entity> entity, Battle::Tile& dest);
 
+  /**
+   * @brief Recycles an idle pooled entity of type T or builds a new one
+   * @param args constructor arguments. Recycled entities receive them through OnPoolReset(args...)
+   * @return the entity. It is returned to the pool once nothing references it.
+   */
+  template<typename T, typename... Args>
+  std::shared_ptr<T> AcquirePooled(Args&&... args);
+
+  /**
+   * @brief AcquirePooled() and then AddEntity() on `dest`
+   */
+  template<typename T, typename... Args>
+  std::shared_ptr<T> SpawnPooled(Battle::Tile& dest, Args&&... args);
+
+  /**
+   * @brief Statistics for every pooled type on this field
+   */
+  const EntityPool::Stats GetPoolStats() const;
+
+  EntityPool& GetPool();
+
+  /**
+   * @brief Visual only particles drawn above the entities on this field
+   */
+  ParticleSystem& GetParticles();
+
   /**
    * @brief Query for entities on the entire field
    * @param query. the query input function
@@ -173,6 +204,13 @@ public:
   */
   void SpawnPendingEntities();
 
+  /**
+  * @brief Called by tiles when their first attacker is queued
+  *
+  * After the main update pass, only tiles in this list are evaluated again for combat
+  */
+  void QueueCombatEvaluation(Battle::Tile& tile);
+
   /**
   * @brief Returns true if pending.size() > 0
   *
@@ -225,6 +263,7 @@ private:
   int width; /*!< col */
   int height; /*!< rows */
   bool isUpdating; /*!< enqueue entities if added in the update loop */
+  std::vector<Battle::Tile*> combatWorklist; /*!< tiles with attackers queued since they last executed attacks */
   const Scene* scene{ nullptr };
 
   // Since we don't want to invalidate our entity lists while updating,
@@ -243,16 +282,37 @@ private:
   struct DeleteObserver {
     NotifyID_t ID{};
     std::optional<Entity::ID_t> observer;
-    std::function<void(std::shared_ptr<Entity>)> callback1; // target only variant
-    std::function<void(std::shared_ptr<Entity>, std::shared_ptr<Entity>)> callback2; // target-observer variant
+    DeleteCallback callback1; // target only variant
+    DeleteNotifyCallback callback2; // target-observer variant
   };
 
   NotifyID_t nextID{};
 
   map<Entity::ID_t, std::shared_ptr<Entity>> allEntityHash; /*!< Quick lookup of entities on the field */
-  map<Entity::ID_t, void*> updatedEntities; /*!< Since entities can be shared across tiles, prevent multiple updates*/
+  size_t updateTick{}; /*!< Bumped by every Update(). Entities can be shared across tiles, so each stamps the tick it updated on.*/
   map<Entity::ID_t, std::vector<DeleteObserver>> entityDeleteObservers; /*!< List of callback functions for when an entity is deleted*/
   map<NotifyID_t, Entity::ID_t> notify2TargetHash; /*!< Convert from target entity to its delete observer key*/
   vector<queueBucket> pending;
   vector<vector<Battle::Tile*>> tiles; /*!< Nested vector to make calls via tiles[x][y] */
-};
\ No newline at end of file
+  EntityPool pool; /*!< Recycles short lived effects and hitboxes */
+  ParticleSystem particles; /*!< Effects that do not need to be entities */
+
+  /**
+  * @brief Executes attacks on the tiles in combatWorklist in the same row-major order as a full pass
+  */
+  void ExecuteQueuedAttacks();
+};
+
+template<typename T, typename... Args>
+inline std::shared_ptr<T> Field::AcquirePooled(Args&&... args)
+{
+  return pool.Acquire<T>(std::forward<Args>(args)...);
+}
+
+template<typename T, typename... Args>
+inline std::shared_ptr<T> Field::SpawnPooled(Battle::Tile& dest, Args&&... args)
+{
+  std::shared_ptr<T> entity = AcquirePooled<T>(std::forward<Args>(args)...);
+  AddEntity(entity, dest);
+  return entity;
+}
\ No newline at end of file
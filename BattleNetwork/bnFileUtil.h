@@ -6,6 +6,7 @@
 #include <SFML/System.hpp>
 
 #include "bnLogger.h"
+#include "bnVirtualFileSystem.h"
 
 #ifdef __ANDROID_NDK__
 #include <android/asset_manager.h>
@@ -88,6 +89,11 @@ public:
   };
 
   static std::string Read(const std::string& _path) {
+    // files inside mounted packages never touch the disk
+    if (std::vector<char> data; VirtualFileSystem::Instance().Read(_path, data)) {
+      return std::string(data.data(), data.size());
+    }
+
     sf::FileInputStream in;
 
     if (in.open(_path) && in.getSize() > 0) {
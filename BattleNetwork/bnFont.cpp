@@ -93,14 +93,14 @@ void Font::ApplyStyle()
   }
 
   // Get the frame (list of size 1) of the font
-  FrameList list = animation.GetFrameList(animName);
+  const FrameList* list = &animation.GetFrameList(animName);
   
-  if (list.IsEmpty()) {
+  if (list->IsEmpty()) {
     // If the list is empty (font support not existing), use small letter 'A'
-    list = animation.GetFrameList("SMALL_A");
+    list = &animation.GetFrameList("SMALL_A");
   }
   
-  auto& frame = list.GetFrame(0);
+  auto& frame = list->GetFrame(0);
   texcoords = frame.subregion;
   origin = frame.origin;
 }
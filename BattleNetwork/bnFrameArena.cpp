@@ -0,0 +1,235 @@
+#include "bnFrameArena.h"
+#include <algorithm>
+#include <cstdint>
+
+#ifdef BN_TRACK_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// every replaceable global new and delete is defined here so the pairs always match:
+// plain, array, sized, nothrow and aligned (std::align_val_t) forms
+static std::atomic<size_t> globalAllocations{ 0 };
+
+static void* AlignedAllocate(std::size_t size, std::align_val_t alignment) noexcept {
+  globalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  const size_t align = static_cast<size_t>(alignment);
+
+  // aligned_alloc only takes sizes that are a multiple of the alignment
+  size = (std::max<size_t>(size, 1) + align - 1) / align * align;
+
+#ifdef _WIN32
+  return _aligned_malloc(size, align);
+#else
+  return std::aligned_alloc(align, size);
+#endif
+}
+
+static void AlignedFree(void* ptr) noexcept {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+void* operator new(std::size_t size) {
+  globalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  if (void* ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  globalAllocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+  return ::operator new(size, tag);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  if (void* ptr = AlignedAllocate(size, alignment)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return AlignedAllocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return AlignedAllocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  AlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  AlignedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+  AlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  AlignedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+  AlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+  AlignedFree(ptr);
+}
+#endif
+
+FrameArena::FrameArena(size_t blockSize) : blockSize(blockSize)
+{
+}
+
+FrameArena::~FrameArena()
+{
+  FreeBlocks();
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t alignment)
+{
+  bytes = std::max<size_t>(bytes, 1);
+
+  while (true) {
+    if (current == blocks.size()) {
+      AddBlock(bytes + alignment);
+    }
+
+    Block& block = blocks[current];
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+    uintptr_t aligned = (base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    size_t end = static_cast<size_t>(aligned - base) + bytes;
+
+    if (end <= block.size) {
+      used += end - offset;
+      offset = end;
+      return reinterpret_cast<void*>(aligned);
+    }
+
+    // does not fit in this block, try the next one
+    current++;
+    offset = 0;
+  }
+}
+
+void FrameArena::Reset()
+{
+  highWaterMark = std::max(highWaterMark, used);
+
+  // This frame spilled into multiple blocks
+  // Replace them with one block that can hold an entire frame
+  if (blocks.size() > 1) {
+    FreeBlocks();
+    AddBlock(highWaterMark + highWaterMark / 2);
+  }
+
+  current = 0;
+  offset = 0;
+  used = 0;
+}
+
+const size_t FrameArena::BytesUsed() const
+{
+  return used;
+}
+
+const size_t FrameArena::Capacity() const
+{
+  size_t total = 0;
+
+  for (const Block& block : blocks) {
+    total += block.size;
+  }
+
+  return total;
+}
+
+const size_t FrameArena::HighWaterMark() const
+{
+  return std::max(highWaterMark, used);
+}
+
+FrameArena& FrameArena::Instance()
+{
+  static FrameArena arena;
+  return arena;
+}
+
+size_t FrameArena::GlobalAllocationCount()
+{
+#ifdef BN_TRACK_ALLOCATIONS
+  return globalAllocations.load(std::memory_order_relaxed);
+#else
+  return 0;
+#endif
+}
+
+void FrameArena::AddBlock(size_t minSize)
+{
+  Block block;
+  block.size = std::max(blockSize, minSize);
+  block.data = new std::byte[block.size];
+  blocks.push_back(block);
+}
+
+void FrameArena::FreeBlocks()
+{
+  for (Block& block : blocks) {
+    delete[] block.data;
+  }
+
+  blocks.clear();
+}
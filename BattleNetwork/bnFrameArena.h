@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <set>
+#include <functional>
+
+/**
+ * @class FrameArena
+ * @brief Linear bump allocator for temporaries that only live for one frame
+ *
+ * Allocations move a pointer forward in a large block and are never freed
+ * individually. The whole arena is rewound by Reset() at the top of every
+ * frame in Game::ProcessFrame(). If a frame needed more than one block, the
+ * blocks are merged into one block large enough for the frame so the next
+ * frames never touch the global heap.
+ *
+ * @warning Memory handed out by the arena is invalid after the frame ends.
+ *          Only use it for locals inside update and draw routines.
+ * @warning The arena is not thread safe. Only use it on the frame thread.
+ */
+class FrameArena {
+public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+  explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+  ~FrameArena();
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  /**
+   * @brief Bump allocates `bytes` aligned to `alignment`
+   * @return pointer to uninitialized memory valid until the next Reset()
+   */
+  void* Allocate(size_t bytes, size_t alignment);
+
+  /**
+   * @brief Rewinds the arena. Everything allocated before this call is invalid.
+   */
+  void Reset();
+
+  /**
+   * @brief Bytes handed out since the last Reset()
+   */
+  const size_t BytesUsed() const;
+
+  /**
+   * @brief Total bytes reserved by all blocks
+   */
+  const size_t Capacity() const;
+
+  /**
+   * @brief Largest amount of bytes used in a single frame
+   */
+  const size_t HighWaterMark() const;
+
+  /**
+   * @brief The arena used by the battle and overworld hot paths
+   */
+  static FrameArena& Instance();
+
+  /**
+   * @brief Total global heap allocations made by the process
+   * @return the counter if built with BN_TRACK_ALLOCATIONS otherwise 0
+   */
+  static size_t GlobalAllocationCount();
+
+private:
+  struct Block {
+    std::byte* data{ nullptr };
+    size_t size{};
+  };
+
+  size_t blockSize{};
+  size_t current{}; /*!< index of the block we are bumping in */
+  size_t offset{}; /*!< bump offset into the current block */
+  size_t used{}, highWaterMark{};
+  std::vector<Block> blocks;
+
+  void AddBlock(size_t minSize);
+  void FreeBlocks();
+};
+
+/**
+ * @class FrameAllocator
+ * @brief STL allocator that draws from a FrameArena. Deallocations are ignored.
+ */
+template<typename T>
+class FrameAllocator {
+  FrameArena* arena{ nullptr };
+
+  template<typename U>
+  friend class FrameAllocator;
+public:
+  using value_type = T;
+
+  FrameAllocator() noexcept : arena(&FrameArena::Instance()) {}
+  explicit FrameAllocator(FrameArena& arena) noexcept : arena(&arena) {}
+
+  template<typename U>
+  FrameAllocator(const FrameAllocator<U>& other) noexcept : arena(other.arena) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t) noexcept {
+    // memory is reclaimed when the arena resets
+  }
+
+  template<typename U>
+  bool operator==(const FrameAllocator<U>& other) const noexcept { return arena == other.arena; }
+
+  template<typename U>
+  bool operator!=(const FrameAllocator<U>& other) const noexcept { return arena != other.arena; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+template<typename T, typename Compare = std::less<T>>
+using FrameSet = std::set<T, Compare, FrameAllocator<T>>;
@@ -15,6 +15,9 @@
 #include "bnResourceHandle.h"
 #include "bnInputHandle.h"
 #include "bnRandom.h"
+#include "bnFrameArena.h"
+#include "bnBootScheduler.h"
+#include "bnPackageFingerprintIndex.h"
 #include "overworld/bnOverworldHomepage.h"
 #include "SFML/System.hpp"
 
@@ -119,6 +122,9 @@ Game::~Game() {
 
   delete session;
 
+  // packages re-zipped while playing are remembered for the next launch
+  PackageFingerprintIndex::Instance().Save();
+
 #ifdef BN_MOD_SUPPORT
   if (cardPackagePartitioner->HasNamespace(Game::RemotePartition)) {
     cardPackagePartitioner->GetPartition(Game::RemotePartition).ErasePackages();
@@ -168,6 +174,13 @@ TaskGroup Game::Boot(const cxxopts::ParseResult& values)
   isDebug = CommandLineValue<bool>("debug");
   singlethreaded = CommandLineValue<bool>("singlethreaded");
 
+#ifdef BN_MOD_SUPPORT
+  scriptManager.GetBytecodeCache().SetEnabled(!CommandLineValue<bool>("noluacache"));
+
+  int sharedStates = CommandLineValue<int>("sharedlua");
+  scriptManager.SetSharedStateCount(sharedStates > 0 ? (size_t)sharedStates : 0);
+#endif
+
   if (reader.IsOK()) {
     Logger::Log(LogLevel::warning, "config settings was not OK. Will use internal default key layout.");
   }
@@ -191,20 +204,8 @@ TaskGroup Game::Boot(const cxxopts::ParseResult& values)
   Callback<void()> audio;
   audio.Slot(std::bind(&Game::RunAudioInit, this, &progress));
 
-  Callback<void()> libraries;
-  libraries.Slot( std::bind( &Game::RunLuaLibraryInit, this, &progress ) );
-
-  Callback<void()> navis;
-  navis.Slot(std::bind(&Game::RunNaviInit, this, &progress));
-
-  Callback<void()> mobs;
-  mobs.Slot(std::bind(&Game::RunMobInit, this, &progress));
-
-  Callback<void()> cards;
-  cards.Slot(std::bind(&Game::RunCardInit, this, &progress));
-
-  Callback<void()> blocks;
-  blocks.Slot(std::bind(&Game::RunBlocksInit, this, &progress));
+  Callback<void(const TaskGroup::ProgressFunc&)> packages;
+  packages.Slot(std::bind(&Game::RunPackageInit, this, &progress, std::placeholders::_1));
 
   Callback<void()> init;
   init.Slot([this] {
@@ -224,11 +225,7 @@ TaskGroup Game::Boot(const cxxopts::ParseResult& values)
   tasks.AddTask("Binding window", std::move(init));
   tasks.AddTask("Init graphics", std::move(graphics));
   tasks.AddTask("Init audio", std::move(audio));
-  tasks.AddTask("Load Libraries", std::move( libraries ) );
-  tasks.AddTask("Load Navis", std::move(navis));
-  tasks.AddTask("Load mobs", std::move(mobs));
-  tasks.AddTask("Load cards", std::move(cards));
-  tasks.AddTask("Load prog blocks", std::move(blocks));
+  tasks.AddTask("Load packages", std::move(packages));
 
   // Load font symbols immediately...
   textureManager.LoadFromFile(TexturePaths::FONT);
@@ -332,6 +329,10 @@ void Game::ProcessFrame()
 
   while (!quitting) {
     clock.restart();
+    ResetFrameArena();
+
+    // textures decoded in the background need the GL context of this thread
+    textureManager.UploadPending();
 
     double delta = 1.0 / static_cast<double>(frame_time_t::frames_per_second);
     this->elapsed += from_seconds(delta);
@@ -370,6 +371,7 @@ void Game::RunSingleThreaded()
 
   while (window.Running() && !quitting) {
     clock.restart();
+    ResetFrameArena();
 
     // Poll window events
     inputManager.EventPoll();
@@ -377,6 +379,9 @@ void Game::RunSingleThreaded()
     // unused images need to be free'd 
     textureManager.HandleExpiredTextureCache();
 
+    // textures decoded in the background need the GL context of this thread
+    textureManager.UploadPending();
+
     double delta = 1.0 / static_cast<double>(frame_time_t::frames_per_second);
     this->elapsed += from_seconds(delta);
 
@@ -402,6 +407,31 @@ void Game::RunSingleThreaded()
   }
 }
 
+void Game::ResetFrameArena()
+{
+  FrameArena& arena = FrameArena::Instance();
+
+#ifdef BN_TRACK_ALLOCATIONS
+  // report the frame that just finished about once a second
+  size_t allocations = FrameArena::GlobalAllocationCount();
+
+  if (FrameNumber() % frame_time_t::frames_per_second == 0) {
+    Logger::Logf(
+      LogLevel::debug,
+      "Frame %u: %u global allocations, %u bytes in frame arena (peak %u)",
+      FrameNumber(),
+      (unsigned)(allocations - frameAllocationCount),
+      (unsigned)arena.BytesUsed(),
+      (unsigned)arena.HighWaterMark()
+    );
+  }
+
+  frameAllocationCount = allocations;
+#endif
+
+  arena.Reset();
+}
+
 void Game::Exit()
 {
   quitting = true;
@@ -430,16 +460,6 @@ void Game::SetWindowMode(DrawWindow::WindowMode mode)
   windowMode = mode;
 }
 
-void Game::Postprocess(ShaderType shaderType)
-{
-  this->postprocess = shaderManager.GetShader(shaderType);
-}
-
-void Game::NoPostprocess()
-{
-  this->postprocess = nullptr;
-}
-
 void Game::PrintCommandLineArgs()
 {
   Logger::Log(LogLevel::debug, "Command line args provided");
@@ -603,55 +623,50 @@ GameSession& Game::Session()
   return *session;
 }
 
-void Game::RunNaviInit(std::atomic<int>* progress) {
+void Game::RunPackageInit(std::atomic<int>* progress, const TaskGroup::ProgressFunc& report) {
   clock_t begin_time = clock();
 
-  auto LoadPlayerMods = QueueModRegistration<class PlayerPackageManager, ScriptedPlayer>;
-  LoadPlayerMods(playerPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/players", "Player Mods");
-  playerPackagePartitioner->GetPartition(Game::LocalPartition).LoadAllPackages(*progress);
+  BootScheduler scheduler;
 
-  Logger::Logf(LogLevel::info, "Loaded registered navis: %f secs", float(clock() - begin_time) / CLOCKS_PER_SEC);
-}
+  // libraries include each other while they load
+  BootScheduler::StageID libraries = scheduler.AddStage("libraries", {}, true);
 
-void Game::RunBlocksInit(std::atomic<int>* progress)
-{
-  clock_t begin_time = clock();
+  // players create entities during install and entity IDs are not thread safe
+  BootScheduler::StageID navis = scheduler.AddStage("navis", { libraries }, true);
+  BootScheduler::StageID mobs = scheduler.AddStage("mobs", { libraries });
+  BootScheduler::StageID cards = scheduler.AddStage("cards", { libraries });
+  BootScheduler::StageID blocks = scheduler.AddStage("blocks", { libraries });
 
-  auto LoadBlockMods = QueueModRegistration<class BlockPackageManager, ScriptedBlock>;
-  LoadBlockMods(blockPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/blocks", "Prog Block Mods");
-  blockPackagePartitioner->GetPartition(Game::LocalPartition).LoadAllPackages(*progress);
+  QueueModRegistration<class LuaLibraryPackageManager, LuaLibrary>(luaLibraryPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/libs", "Core Libs Mods", scheduler, libraries);
+  QueueModRegistration<class PlayerPackageManager, ScriptedPlayer>(playerPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/players", "Player Mods", scheduler, navis);
+  QueueModRegistration<class MobPackageManager, ScriptedMob>(mobPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/enemies", "Enemy Mods", scheduler, mobs);
+  QueueModRegistration<class CardPackageManager, ScriptedCard>(cardPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/cards", "Card Mods", scheduler, cards);
+  QueueModRegistration<class BlockPackageManager, ScriptedBlock>(blockPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/blocks", "Prog Block Mods", scheduler, blocks);
 
-  Logger::Logf(LogLevel::info, "Loaded registered prog blocks: %f secs", float(clock() - begin_time) / CLOCKS_PER_SEC);
-}
+  Logger::Logf(LogLevel::info, "Installing %u packages", (unsigned)scheduler.JobCount());
 
-void Game::RunMobInit(std::atomic<int>* progress) {
-  clock_t begin_time = clock();
+  scheduler.Run(singlethreaded ? 1 : 0, [&report](size_t done, size_t total) {
+    if (report) {
+      report(done / static_cast<float>(total));
+    }
+  });
 
-  auto LoadEnemyMods = QueueModRegistration<class MobPackageManager, ScriptedMob>;
-  LoadEnemyMods(mobPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/enemies", "Enemy Mods");
+  luaLibraryPackagePartitioner->GetPartition(Game::LocalPartition).LoadAllPackages(*progress);
+  playerPackagePartitioner->GetPartition(Game::LocalPartition).LoadAllPackages(*progress);
   mobPackagePartitioner->GetPartition(Game::LocalPartition).LoadAllPackages(*progress);
-
-  Logger::Logf(LogLevel::info, "Loaded registered mobs: %f secs", float(clock() - begin_time) / CLOCKS_PER_SEC);
-}
-
-void Game::RunCardInit(std::atomic<int>* progress) {
-  clock_t begin_time = clock();
-
-  auto LoadCardMods = QueueModRegistration<class CardPackageManager, ScriptedCard>;
-  LoadCardMods(cardPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/cards", "Card Mods");
   cardPackagePartitioner->GetPartition(Game::LocalPartition).LoadAllPackages(*progress);
+  blockPackagePartitioner->GetPartition(Game::LocalPartition).LoadAllPackages(*progress);
 
-  Logger::Logf(LogLevel::info, "Loaded registered cards: %f secs", float(clock() - begin_time) / CLOCKS_PER_SEC);
-}
-
-void Game::RunLuaLibraryInit(std::atomic<int>* progress) {
-  clock_t begin_time = clock();
+  PackageFingerprintIndex::Instance().Save();
 
-  auto LoadCoreLibraryMods = QueueModRegistration<class LuaLibraryPackageManager, LuaLibrary>;
-  LoadCoreLibraryMods(luaLibraryPackagePartitioner->GetPartition(Game::LocalPartition), "resources/mods/libs", "Core Libs Mods");
-  luaLibraryPackagePartitioner->GetPartition(Game::LocalPartition).LoadAllPackages(*progress);
+#ifdef BN_MOD_SUPPORT
+  LuaBytecodeCache::Stats luaCache = scriptManager.GetBytecodeCache().GetStats();
+  size_t luaCachePruned = scriptManager.GetBytecodeCache().Prune();
+  Logger::Logf(LogLevel::info, "Lua bytecode cache: %u hits, %u misses, %u unused entries deleted", (unsigned)luaCache.hits, (unsigned)luaCache.misses, (unsigned)luaCachePruned);
+  Logger::Logf(LogLevel::info, "Package scripts use %u KiB of Lua heap in %u Lua states", (unsigned)(scriptManager.GetLuaMemoryUsed() / 1024), (unsigned)scriptManager.GetLuaStateCount());
+#endif
 
-  Logger::Logf(LogLevel::info, "Loaded registered libraries: %f secs", float(clock() - begin_time) / CLOCKS_PER_SEC);
+  Logger::Logf(LogLevel::info, "Loaded registered packages: %f secs", float(clock() - begin_time) / CLOCKS_PER_SEC);
 }
 
 void Game::RunGraphicsInit(std::atomic<int> * progress) {
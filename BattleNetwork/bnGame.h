@@ -95,8 +95,6 @@ private:
   SpriteProxyNode spinner;
   Animation spinnerAnimator;
 
-  sf::Shader* postprocess{ nullptr };
-
   // We need a render surface to draw to so Swoosh ActivityController
   // can add screen transition effects from the title screen
   sf::RenderTexture renderSurface;
@@ -111,10 +109,12 @@ private:
   std::atomic<int> progress{ 0 };
   std::mutex windowMutex;
   std::thread renderThread, recordOutThread;
+  size_t frameAllocationCount{}; /*!< Global allocation count at the start of the frame. Used with BN_TRACK_ALLOCATIONS */
 
   void HandleRecordingEvents();
   void UpdateMouse(double dt);
   void ProcessFrame();
+  void ResetFrameArena();
   void RunSingleThreaded();
   bool NextFrame();
 
@@ -132,8 +132,6 @@ public:
   void Exit();
   void Run();
   void SetWindowMode(DrawWindow::WindowMode mode);
-  void Postprocess(ShaderType shaderType);
-  void NoPostprocess();
   void PrintCommandLineArgs();
   const sf::Vector2f CameraViewOffset(Camera& camera);
   unsigned FrameNumber() const;
@@ -193,70 +191,17 @@ private:
 
   void LoadConfigSettings();
 
-  /*! \brief This thread initializes all navis
-  *
-  * Uses an std::atomic<int> pointer
-  * to keep track of all successfully loaded
-  * objects.
-  *
-  * After the media resources are loaded we
-  * safely load all registered navis.
-  * Loaded navis will show up in navi select
-  * screen and can be chosen to play as in
-  * battle.
-  */
-  void RunNaviInit(std::atomic<int>* progress);
-
-  /*! \brief This thread initializes all cards
-  *
-  * Uses an std::atomic<int> pointer
-  * to keep track of all successfully loaded
-  * objects.
-  *
-  * After the media resources are loaded we
-  * safely load all registered cards.
-  * Loaded cards will show up in available library
-  * screen and can be chosen to play with in
-  * battle.
-  */
-  void RunCardInit(std::atomic<int>* progress);
-
-  /*! \brief This thread initializes all prog blocks
-  *
-  * Uses an std::atomic<int> pointer
-  * to keep track of all successfully loaded
-  * objects.
-  *
-  * After the media resources are loaded we
-  * safely load all registered prog blocks.
-  * Loaded prog blocks will show up in available cust
-  * screen and can be chosen to play with in
-  * battle.
-  */
-  void RunBlocksInit(std::atomic<int>* progress);
-
-  /*! \brief This thread tnitializes all mobs
-  *
-  * @see RunNaviInit()
-  *
-  * After the media resources are loaded we
-  * safely load all registed mobs.
-  * Loaded mobs will show up in mob select
-  * screen and can be chosen to battle
-  * against.
-  */
-  void RunMobInit(std::atomic<int>* progress);
-
-  /*! \brief This thread tnitializes all shared lua libraries
+  /*! \brief This thread installs all packages
   *
-  * @see RunNaviInit()
+  * Libraries install first. Navis, mobs, cards and
+  * prog blocks do not depend on each other and install
+  * concurrently on a BootScheduler. Each package
+  * registers itself under its package manager's lock.
   *
-  * After the media resources are loaded we
-  * safely load all registed shared libraries.
-  * Loaded shared libraries will be able to be
-  * included by other scripts.
+  * @param progress counts successfully loaded objects
+  * @param report receives the fraction of packages installed
   */
-  void RunLuaLibraryInit(std::atomic<int>* progress);
+  void RunPackageInit(std::atomic<int>* progress, const TaskGroup::ProgressFunc& report);
 
   /*! \brief This thread loads textures and shaders
   *
@@ -27,6 +27,14 @@ private:
     listeners.push_back(listener);
   }
 
+protected:
+  /**
+   * @brief Drops every subscription
+   */
+  void ClearListeners() {
+    listeners.clear();
+  }
+
 public:
   virtual ~HitPublisher();
 
@@ -12,6 +12,20 @@ HitboxSpell::HitboxSpell(Team _team, int _damage) : Spell(_team) {
   SetHitboxProperties(props);
 }
 
+void HitboxSpell::OnPoolReset(Team _team, int _damage) {
+  SetTeam(_team);
+  SetLayer(1);
+  hit = false;
+  damage = _damage;
+  attackCallback = nullptr;
+  collisionCallback = nullptr;
+
+  auto props = Hit::DefaultProperties;
+  props.flags |= Hit::impact;
+  props.damage = _damage;
+  SetHitboxProperties(props);
+}
+
 HitboxSpell::~HitboxSpell() {
 }
 
@@ -19,6 +19,11 @@ public:
    * @brief disables tile highlighting by default
    */
   HitboxSpell(Team _team, int damage = 0);
+
+  /**
+   * @brief Restores team, damage, and clears callbacks for recycled instances
+   */
+  void OnPoolReset(Team _team, int damage = 0);
   
   /**
    * @brief deconstructor
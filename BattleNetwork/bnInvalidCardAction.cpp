@@ -12,7 +12,7 @@ InvalidCardAction::~InvalidCardAction()
 void InvalidCardAction::OnExecute(std::shared_ptr<Character> user)
 {
   Battle::Tile* tile = user->GetTile();
-  auto poof = std::make_shared<ParticlePoof>();
+  auto poof = user->GetField()->AcquirePooled<ParticlePoof>();
   poof->SetHeight(user->GetHeight());
   poof->SetLayer(-100); // in front of player and player widgets
 
@@ -1,5 +1,7 @@
 #include "bnLoaderScene.h"
 
+#include <algorithm>
+
 void LoaderScene::ExecuteTasks()
 {
   while (tasks.HasMore()) {
@@ -11,10 +13,17 @@ void LoaderScene::ExecuteTasks()
     events.push([=] { this->onTaskBegin(taskname, progress); });
     mutex.unlock();
 
-    tasks.DoNextTask();
+    tasks.DoNextTask([=](float fraction) {
+      float overall = (tasknumber + std::clamp(fraction, 0.f, 1.f)) / static_cast<float>(tasks.GetTotalTasks());
+
+      std::lock_guard lock(mutex);
+      latestProgress = [=] { this->onTaskProgress(taskname, overall); };
+    });
+
     progress = (tasknumber+1) / static_cast<float>(tasks.GetTotalTasks());
 
     mutex.lock();
+    latestProgress = nullptr;
     events.push([=] { this->onTaskComplete(taskname, progress); });
 
     mutex.unlock();
@@ -57,6 +66,10 @@ void LoaderScene::Poll()
     events.front()();
     events.pop();
   }
+  else if (latestProgress) {
+    latestProgress();
+    latestProgress = nullptr;
+  }
   else if (!tasks.HasMore()) {
     isComplete = true;
   }
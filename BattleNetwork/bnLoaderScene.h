@@ -27,6 +27,7 @@ private:
   std::mutex mutex;
   std::thread taskThread;
   std::queue<std::function<void()>> events;
+  std::function<void()> latestProgress; /*!< Only the newest progress report is kept so long tasks cannot flood the queue */
   bool isComplete{};
   void ExecuteTasks();
 public:
@@ -39,4 +40,10 @@ public:
 
   virtual void onTaskComplete(const std::string& taskName, float progress) = 0;
   virtual void onTaskBegin(const std::string& taskName, float progress) = 0;
+
+  /**
+   * @brief Called while a task that reports its own progress is running
+   * @param progress overall progress of the group, including the running task
+   */
+  virtual void onTaskProgress(const std::string& taskName, float progress) {}
 };
\ No newline at end of file
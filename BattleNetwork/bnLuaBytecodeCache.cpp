@@ -0,0 +1,169 @@
+#ifdef BN_MOD_SUPPORT
+#include "bnLuaBytecodeCache.h"
+#include "bnLogger.h"
+#include "stx/crypto_utils.h"
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#ifndef __APPLE__
+  // TODO: mac os < 10.15 file system support
+  #include <filesystem>
+#endif
+
+LuaBytecodeCache::LuaBytecodeCache(const std::string& folder) :
+  folder(folder)
+{
+}
+
+void LuaBytecodeCache::SetEnabled(bool enabled)
+{
+  this->enabled = enabled;
+}
+
+const bool LuaBytecodeCache::IsEnabled() const
+{
+  return enabled;
+}
+
+sol::load_result LuaBytecodeCache::Load(sol::state& state, std::string_view source, const std::string& chunkname)
+{
+  if (!enabled) {
+    return state.load(source, chunkname);
+  }
+
+  std::string path = PathFor(source, chunkname);
+
+  {
+    std::ifstream fs(path, std::ios::binary);
+
+    if (fs.good()) {
+      std::vector<char> bytecode((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+      sol::load_result chunk = state.load_buffer(bytecode.data(), bytecode.size(), chunkname, sol::load_mode::binary);
+
+      if (chunk.valid()) {
+        hits++;
+        Touch(path);
+        return chunk;
+      }
+
+      Logger::Logf(LogLevel::debug, "Discarding unreadable bytecode for %s", chunkname.c_str());
+    }
+  }
+
+  misses++;
+
+  sol::load_result chunk = state.load(source, chunkname);
+
+  if (!chunk.valid()) {
+    return chunk;
+  }
+
+  sol::protected_function function = chunk.get<sol::protected_function>();
+  sol::bytecode bytecode;
+
+  // debug info is kept so error messages still carry file names and line numbers
+  int status = function.dump(&sol::basic_insert_dump_writer<sol::bytecode>, &bytecode, false, &sol::dump_pass_on_error);
+
+  if (status != 0) {
+    Logger::Logf(LogLevel::debug, "Could not dump bytecode for %s", chunkname.c_str());
+  }
+  else if (Write(path, bytecode.as_string_view())) {
+    writes++;
+  }
+
+  return chunk;
+}
+
+size_t LuaBytecodeCache::Prune()
+{
+#ifndef __APPLE__
+  namespace fs = std::filesystem;
+
+  const fs::file_time_type expired = fs::file_time_type::clock::now() - std::chrono::hours(24 * MAX_UNUSED_DAYS);
+  size_t removed = 0;
+  std::error_code ec;
+
+  for (fs::directory_iterator iter(folder, ec), end; !ec && iter != end; iter.increment(ec)) {
+    const fs::path& path = iter->path();
+
+    // temporary files are left behind by writes that never finished
+    if (path.extension() != ".luac" && path.extension() != ".tmp") continue;
+
+    std::error_code fileError;
+    fs::file_time_type time = fs::last_write_time(path, fileError);
+
+    if (fileError || time > expired) continue;
+
+    if (fs::remove(path, fileError)) {
+      removed++;
+    }
+  }
+
+  return removed;
+#else
+  return 0;
+#endif
+}
+
+const LuaBytecodeCache::Stats LuaBytecodeCache::GetStats() const
+{
+  return Stats{ hits, misses, writes };
+}
+
+const std::string LuaBytecodeCache::PathFor(std::string_view source, const std::string& chunkname) const
+{
+  // the chunk name is compiled into the bytecode, so the same source at another path is another entry
+  std::string key = std::string(LUA_RELEASE) + '\0' + chunkname + '\0';
+  key.append(source.data(), source.size());
+
+  return folder + "/" + stx::generate_md5_from_buffer(key.data(), key.size()).value() + ".luac";
+}
+
+void LuaBytecodeCache::Touch(const std::string& path)
+{
+#ifndef __APPLE__
+  std::error_code ec;
+  std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+#endif
+}
+
+bool LuaBytecodeCache::Write(const std::string& path, std::string_view bytecode)
+{
+#ifndef __APPLE__
+  std::error_code ec;
+  std::filesystem::create_directories(folder, ec);
+
+  // packages compile on several threads, each writes its own temporary file
+  std::string tempPath = path + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+  {
+    std::ofstream fs(tempPath, std::ios::binary | std::ios::trunc);
+    fs.write(bytecode.data(), bytecode.size());
+
+    if (!fs.good()) {
+      fs.close();
+      std::filesystem::remove(tempPath, ec);
+      return false;
+    }
+  }
+
+  // a crash before the rename never leaves a partial file under the real name
+  std::filesystem::rename(tempPath, path, ec);
+
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+#ifdef BN_MOD_SUPPORT
+
+#include <atomic>
+#include <string>
+#include <string_view>
+
+#ifdef __unix__
+#define LUA_USE_POSIX 1
+#endif
+
+#include <sol/sol.hpp>
+
+/**
+ * @class LuaBytecodeCache
+ * @brief Keeps compiled package scripts on disk so unchanged scripts are not parsed again on the next boot
+ *
+ * Each chunk is stored under a hash of its source, its chunk name and the Lua release.
+ * Editing a script, moving it, or upgrading Lua changes the hash, so stale bytecode is never
+ * loaded and there is nothing to invalidate by hand. Bytecode that Lua refuses to load,
+ * e.g. a file cut short, is compiled again from source and replaced.
+ *
+ * Only bytecode compiled here is ever loaded as binary. Debug info is kept so errors
+ * and _modpath lookups still name the original file.
+ *
+ * Loading an entry refreshes its modified time. Entries nobody loaded for MAX_UNUSED_DAYS,
+ * such as the ones of edited or removed scripts, are deleted by Prune().
+ */
+class LuaBytecodeCache {
+public:
+  static constexpr const char* DEFAULT_FOLDER = "cache/lua";
+  static constexpr int MAX_UNUSED_DAYS = 30;
+
+  struct Stats {
+    size_t hits{};
+    size_t misses{};
+    size_t writes{};
+  };
+
+  explicit LuaBytecodeCache(const std::string& folder);
+
+  /**
+   * @brief Disabled caches always compile from source and write nothing
+   */
+  void SetEnabled(bool enabled);
+  const bool IsEnabled() const;
+
+  /**
+   * @brief Compiles a chunk without running it, from cached bytecode when the source is unchanged
+   * @param chunkname name reported by Lua for this chunk, e.g. "@" + path
+   */
+  sol::load_result Load(sol::state& state, std::string_view source, const std::string& chunkname);
+
+  /**
+   * @brief Deletes entries that were not loaded or written for MAX_UNUSED_DAYS
+   * @return number of files deleted
+   */
+  size_t Prune();
+
+  const Stats GetStats() const;
+
+private:
+  std::string folder;
+  std::atomic<bool> enabled{ true };
+  std::atomic<size_t> hits{ 0 }, misses{ 0 }, writes{ 0 };
+
+  const std::string PathFor(std::string_view source, const std::string& chunkname) const;
+  bool Write(const std::string& path, std::string_view bytecode);
+  void Touch(const std::string& path);
+};
+
+#endif
@@ -74,7 +74,7 @@ void NaviWhiteoutState<Any>::OnEnter(Any& e) {
     /* Spawn shine artifact */
     Battle::Tile* tile = e.GetTile();
     std::shared_ptr<Field> field = e.GetField();
-    shine = std::make_shared<ShineExplosion>();
+    shine = field->AcquirePooled<ShineExplosion>();
     shine->Init();
 
     // ShineExplosion loops, we just want to play once and delete
@@ -0,0 +1,331 @@
+#include "bnPackageFingerprintIndex.h"
+#include "bnLogger.h"
+#include "stx/crypto_utils.h"
+#include "stx/zip_utils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+#ifndef __APPLE__
+  // TODO: mac os < 10.15 file system support
+  #include <filesystem>
+#endif
+
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+
+namespace {
+  // bump when the signature or the line format changes so old indices are ignored
+  constexpr const char* INDEX_HEADER = "package-fingerprints 1";
+
+  /**
+   * @brief Flushes the file to the disk so the rename that follows never publishes an empty index
+   */
+  bool SyncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) {
+      return false;
+    }
+
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+  }
+}
+
+PackageFingerprintIndex& PackageFingerprintIndex::Instance()
+{
+  static PackageFingerprintIndex index(DEFAULT_PATH);
+  return index;
+}
+
+PackageFingerprintIndex::PackageFingerprintIndex(const std::string& indexPath) :
+  path(indexPath)
+{
+}
+
+stx::result_t<std::string> PackageFingerprintIndex::Fingerprint(const std::string& folder)
+{
+#ifndef __APPLE__
+  stx::result_t<std::string> signature = Signature(folder);
+
+  if (signature.is_error()) {
+    return signature;
+  }
+
+  std::string zipPath = folder + ".zip";
+  std::error_code error;
+
+  {
+    std::scoped_lock lock(mutex);
+    Load();
+
+    auto iter = entries.find(folder);
+
+    if (iter != entries.end() && iter->second.signature == signature.value()) {
+      // the zip is shared with other players so it must still be the one we hashed
+      uint64_t size = std::filesystem::file_size(zipPath, error);
+      int64_t time = error ? 0 : std::filesystem::last_write_time(zipPath, error).time_since_epoch().count();
+
+      if (!error && size == iter->second.zipSize && time == iter->second.zipTime) {
+        return stx::ok(iter->second.md5);
+      }
+    }
+  }
+
+  // write the zip beside the old one so the old zip stays whole until the new one is done
+  std::string tempPath = zipPath + ".tmp";
+
+  if (stx::result_t<bool> zip_result = stx::zip(folder, tempPath); zip_result.is_error()) {
+    return stx::error<std::string>(zip_result.error_cstr());
+  }
+
+  std::filesystem::rename(tempPath, zipPath, error);
+
+  if (error) {
+    std::filesystem::remove(tempPath, error);
+    return stx::error<std::string>("Unable to replace " + zipPath);
+  }
+
+  stx::result_t<std::string> md5 = stx::generate_md5_from_file(zipPath);
+
+  if (md5.is_error()) {
+    return md5;
+  }
+
+  Entry entry;
+  entry.signature = signature.value();
+  entry.zipSize = std::filesystem::file_size(zipPath, error);
+  entry.zipTime = error ? 0 : std::filesystem::last_write_time(zipPath, error).time_since_epoch().count();
+  entry.md5 = md5.value();
+
+  if (!error) {
+    std::scoped_lock lock(mutex);
+    entries[folder] = std::move(entry);
+    dirty = true;
+  }
+
+  return md5;
+#else
+  return stx::error<std::string>("std::filesystem not supported");
+#endif
+}
+
+bool PackageFingerprintIndex::Save()
+{
+#ifndef __APPLE__
+  std::scoped_lock lock(mutex);
+
+  if (!dirty) {
+    return true;
+  }
+
+  std::error_code error;
+  std::filesystem::path indexPath(path);
+
+  if (indexPath.has_parent_path()) {
+    std::filesystem::create_directories(indexPath.parent_path(), error);
+  }
+
+  std::string tempPath = path + ".tmp";
+
+  std::stringstream contents;
+  contents << INDEX_HEADER << "\n";
+
+  // folder goes last so it can hold any character except a newline
+  for (auto& [folder, entry] : entries) {
+    contents << entry.md5 << "\t" << entry.zipSize << "\t" << entry.zipTime << "\t" << entry.signature << "\t" << folder << "\n";
+  }
+
+  std::string buffer = contents.str();
+  std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+
+  if (!file) {
+    Logger::Logf(LogLevel::warning, "Failed to write package fingerprint index %s", tempPath.c_str());
+    return false;
+  }
+
+  bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+  written = SyncFile(file) && written;
+  written = std::fclose(file) == 0 && written;
+
+  if (!written) {
+    Logger::Logf(LogLevel::warning, "Failed to write package fingerprint index %s", tempPath.c_str());
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+
+  // the rename replaces the old index in one step. A crash before this leaves the old index intact
+  std::filesystem::rename(tempPath, path, error);
+
+  if (error) {
+    Logger::Logf(LogLevel::warning, "Failed to replace package fingerprint index %s: %s", path.c_str(), error.message().c_str());
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+
+  dirty = false;
+  Logger::Logf(LogLevel::debug, "Saved %u package fingerprints", (unsigned)entries.size());
+#endif
+
+  return true;
+}
+
+const size_t PackageFingerprintIndex::Size()
+{
+  std::scoped_lock lock(mutex);
+  Load();
+  return entries.size();
+}
+
+void PackageFingerprintIndex::Load()
+{
+  if (loaded) return;
+
+  loaded = true;
+
+  Read();
+
+  if (size_t removed = RemoveTemporaryFiles(); removed > 0) {
+    Logger::Logf(LogLevel::info, "Removed %u unfinished package files", (unsigned)removed);
+  }
+}
+
+void PackageFingerprintIndex::Read()
+{
+  std::ifstream fin(path);
+
+  if (!fin.is_open()) {
+    return;
+  }
+
+  std::string line;
+
+  if (!std::getline(fin, line) || line != INDEX_HEADER) {
+    Logger::Logf(LogLevel::info, "Ignoring outdated package fingerprint index %s", path.c_str());
+    dirty = true;
+    return;
+  }
+
+  while (std::getline(fin, line)) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+
+    for (int i = 0; i < 4; i++) {
+      size_t tab = line.find('\t', start);
+
+      if (tab == std::string::npos) break;
+
+      fields.push_back(line.substr(start, tab - start));
+      start = tab + 1;
+    }
+
+    if (fields.size() != 4 || start >= line.size()) {
+      // skip damaged lines, the package is fingerprinted again
+      dirty = true;
+      continue;
+    }
+
+    try {
+      Entry entry;
+      entry.md5 = fields[0];
+      entry.zipSize = std::stoull(fields[1]);
+      entry.zipTime = std::stoll(fields[2]);
+      entry.signature = fields[3];
+      entries[line.substr(start)] = std::move(entry);
+    }
+    catch (std::exception&) {
+      dirty = true;
+    }
+  }
+}
+
+size_t PackageFingerprintIndex::RemoveTemporaryFiles()
+{
+#ifndef __APPLE__
+  namespace fs = std::filesystem;
+
+  size_t removed = 0;
+  std::error_code ec;
+
+  if (fs::remove(path + ".tmp", ec)) {
+    removed++;
+  }
+
+  // packages of one category share a folder, so this also finds zips of packages not indexed yet
+  std::set<fs::path> folders;
+
+  for (auto& [folder, entry] : entries) {
+    folders.insert(fs::path(folder).parent_path());
+  }
+
+  for (const fs::path& folder : folders) {
+    for (fs::directory_iterator iter(folder, ec), end; !ec && iter != end; iter.increment(ec)) {
+      const fs::path& file = iter->path();
+
+      if (file.extension() != ".tmp" || file.stem().extension() != ".zip") continue;
+
+      std::error_code fileError;
+
+      if (fs::remove(file, fileError)) {
+        removed++;
+      }
+    }
+  }
+
+  return removed;
+#else
+  return 0;
+#endif
+}
+
+stx::result_t<std::string> PackageFingerprintIndex::Signature(const std::string& folder)
+{
+#ifndef __APPLE__
+  std::vector<std::tuple<std::string, uintmax_t, int64_t>> files;
+  std::error_code error;
+  std::filesystem::recursive_directory_iterator iter(folder, error), end;
+
+  for (; !error && iter != end; iter.increment(error)) {
+    if (!iter->is_regular_file(error)) continue;
+
+    uintmax_t size = iter->file_size(error);
+    if (error) break;
+
+    int64_t time = iter->last_write_time(error).time_since_epoch().count();
+    if (error) break;
+
+    files.emplace_back(iter->path().lexically_relative(folder).generic_string(), size, time);
+  }
+
+  if (error) {
+    return stx::error<std::string>("Unable to read package folder " + folder + ": " + error.message());
+  }
+
+  // directory order is not stable across file systems
+  std::sort(files.begin(), files.end());
+
+  std::stringstream listing;
+
+  for (auto& [file, size, time] : files) {
+    listing << file << '\0' << size << '\0' << time << '\n';
+  }
+
+  std::string buffer = listing.str();
+  char digest[16];
+  MD5(digest, buffer.data(), buffer.size());
+
+  return stx::ok(stx::as_hex(std::string(digest, sizeof(digest)), 0));
+#else
+  return stx::error<std::string>("std::filesystem not supported");
+#endif
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include "stx/result.h"
+
+/**
+ * @class PackageFingerprintIndex
+ * @brief Remembers the zip fingerprint of every installed package folder between launches
+ *
+ * Installing a package zips its folder and hashes the zip so peers can compare packages.
+ * Doing that for every package on every launch is most of the boot time. The index stores
+ * a signature of each folder (relative path, size and modification time of every file)
+ * next to the fingerprint of the zip made from it. While the signature and the zip on disk
+ * are unchanged, the stored fingerprint is returned without touching the zip.
+ *
+ * The index is written to a temporary file that is flushed to the disk and then replaces
+ * the old index in one rename, and zips are written the same way, so a crash never leaves
+ * a half written file that looks valid. A missing or unreadable index only means every
+ * package is zipped again. Temporary files left by a crash are deleted when the index loads.
+ *
+ * Save() is called after boot, after packages are re-zipped at runtime, and at shutdown.
+ */
+class PackageFingerprintIndex {
+public:
+  static constexpr const char* DEFAULT_PATH = "cache/package_fingerprints.index";
+
+  static PackageFingerprintIndex& Instance();
+
+  explicit PackageFingerprintIndex(const std::string& indexPath);
+
+  /**
+   * @brief Returns the MD5 of folder + ".zip", zipping the folder first if it changed since it was indexed
+   * @param folder package folder
+   */
+  stx::result_t<std::string> Fingerprint(const std::string& folder);
+
+  /**
+   * @brief Writes the index to disk if anything changed since it was read
+   * @return false if the index could not be written
+   */
+  bool Save();
+
+  const size_t Size();
+
+private:
+  struct Entry {
+    std::string signature; /*!< Hash of the folder's file list, sizes and modification times */
+    uint64_t zipSize{};
+    int64_t zipTime{};
+    std::string md5; /*!< Fingerprint of the zip */
+  };
+
+  std::string path;
+  std::mutex mutex;
+  std::map<std::string, Entry> entries; /*!< Folder to entry */
+  bool loaded{}, dirty{};
+
+  /**
+   * @brief Reads the index the first time it is needed. Must be called with the mutex locked.
+   *
+   * Nothing is zipped before the index is loaded, so any temporary file found then was left by a crash.
+   */
+  void Load();
+
+  void Read();
+
+  /**
+   * @brief Deletes the index's temporary file and unfinished .zip.tmp files beside indexed packages
+   * @return how many files were removed
+   */
+  size_t RemoveTemporaryFiles();
+
+  static stx::result_t<std::string> Signature(const std::string& folder);
+};
@@ -5,6 +5,8 @@
 #include "bnResourceHandle.h"
 #include "bnScriptResourceManager.h"
 #include "bnSolHelpers.h"
+#include "bnPackageFingerprintIndex.h"
+#include "bnVirtualFileSystem.h"
 #include "stx/string.h"
 #include "stx/result.h"
 #include "stx/tuple.h"
@@ -15,6 +17,7 @@
 #include <string>
 #include <functional>
 #include <atomic>
+#include <mutex>
 
 // forward decl.
 template<typename MetaClass>
@@ -166,9 +169,19 @@ class PackageManager {
     template<typename ScriptedDataType>
     stx::result_t<std::string> LoadPackageFromDisk(const std::string& path);
 
+    /**
+    * @brief Mounts the zip over the folder it would extract to and loads the package from there
+    */
     template<typename ScriptedDataType>
     stx::result_t<std::string> LoadPackageFromZip(const std::string& path);
 
+    /**
+    * @brief Loads a package from a zip held in memory, e.g. one received from another player
+    * @param path where the package appears to live. Nothing is written there
+    */
+    template<typename ScriptedDataType>
+    stx::result_t<std::string> LoadPackageFromMemory(const std::string& path, std::vector<char>&& zipData);
+
     /**
     * @brief Get the size of the package list
     * @return const unsigned size
@@ -202,6 +215,7 @@ class PackageManager {
     std::map<std::string, MetaClass*> packages;
     std::map<std::string, std::string> filepathToPackageId;
     std::map<std::string, std::string> zipFilepathToPackageId;
+    std::mutex commitMutex; /*!< Packages install on several threads at boot. Only one may register at a time */
 };
 
 template<typename MetaClass>
@@ -229,29 +243,41 @@ stx::result_t<std::string> PackageManager<MetaClass>::LoadPackageFromDisk(const
 
   std::string packageName = modpath.filename().generic_string();
 
-  stx::result_t<sol::state*> res = handle.Scripts().LoadScript(namespaceId, modpath);
+  stx::result_t<ScriptPackage*> res = handle.Scripts().LoadScript(namespaceId, modpath);
 
   if (!res.is_error()) {
-    sol::state& state = *res.value();
-    packageClass = this->CreatePackage<ScriptedDataType>(std::ref(state));
+    ScriptPackage& package = *res.value();
+
+    {
+      // other packages may be loading into the same state on other threads
+      std::scoped_lock lock(package.vm->mutex);
+      sol::environment& env = package.environment;
+      packageClass = this->CreatePackage<ScriptedDataType>(std::ref(package));
+
+      //  Run all "includes" first
+      if (env["package_requires_scripts"].valid()) {
+        stx::result_t<sol::object> includesResult = CallLuaFunction(env, "package_requires_scripts");
+
+        if (includesResult.is_error()) {
+          delete packageClass;
+          std::string msg = std::string("Failed to install package `") + packageName + "`. Reason: " + includesResult.error_cstr();
+          return stx::error<std::string>(msg);
+        }
+      }
 
-    //  Run all "includes" first
-    if (state["package_requires_scripts"].valid()) {
-      stx::result_t<sol::object> includesResult = CallLuaFunction(state, "package_requires_scripts");
+      // todo: use a ScopedWrapper
+      stx::result_t<sol::object> initResult = CallLuaFunction(env, "package_init", packageClass);
 
-      if (includesResult.is_error()) {
+      if (initResult.is_error()) {
         delete packageClass;
-        std::string msg = std::string("Failed to install package `") + packageName + "`. Reason: " + includesResult.error_cstr();
+        std::string msg = std::string("Failed to install package `") + packageName + "`. Reason: " + initResult.error_cstr();
         return stx::error<std::string>(msg);
       }
     }
 
-    // todo: use a ScopedWrapper
-    stx::result_t<sol::object> initResult = CallLuaFunction(state, "package_init", packageClass);
-
-    if (initResult.is_error()) {
+    if (stx::result_t<bool> registerResult = handle.Scripts().RegisterPackage(package, packageClass->GetPackageID()); registerResult.is_error()) {
       delete packageClass;
-      std::string msg = std::string("Failed to install package `") + packageName + "`. Reason: " + initResult.error_cstr();
+      std::string msg = std::string("Failed to install package `") + packageName + "`. Reason: " + registerResult.error_cstr();
       return stx::error<std::string>(msg);
     }
 
@@ -260,14 +286,9 @@ stx::result_t<std::string> PackageManager<MetaClass>::LoadPackageFromDisk(const
     std::string file_path = modpath.generic_string();
     packageClass->SetFilePath(file_path);
 
-    stx::result_t<bool> zip_result = stx::zip(file_path, file_path + ".zip");
-    if (zip_result.is_error()) {
-      delete packageClass;
-      std::string msg = std::string("Failed to install package `") + packageName + "`. Reason: " + zip_result.error_cstr();
-      return stx::error<std::string>(msg);
-    }
-
-    stx::result_t<std::string> md5_result = stx::generate_md5_from_file(file_path + ".zip");
+    // mounted zips are hashed as they are. Folders are only re-zipped if their files changed since the last launch
+    VirtualFileSystem& vfs = VirtualFileSystem::Instance();
+    stx::result_t<std::string> md5_result = vfs.IsMounted(file_path) ? vfs.Fingerprint(file_path) : PackageFingerprintIndex::Instance().Fingerprint(file_path);
     if (md5_result.is_error()) {
       delete packageClass;
       std::string msg = std::string("Failed to install package `") + packageName + "`. Reason: " + md5_result.error_cstr();
@@ -309,18 +330,46 @@ stx::result_t<std::string> PackageManager<MetaClass>::LoadPackageFromZip(const s
   absolute = absolute.remove_filename();
   std::string extracted_path = (absolute / std::filesystem::path(file_str)).generic_string();
 
-  auto result = stx::unzip(path, extracted_path);
+  // files are read straight out of the zip so nothing is extracted
+  if (auto result = VirtualFileSystem::Instance().MountZip(extracted_path, path); result.is_error()) {
+    return stx::error<std::string>(result.error_cstr());
+  }
+
+  auto result = this->LoadPackageFromDisk<ScriptedDataType>(extracted_path);
 
   if (result.is_error()) {
-    return stx::error<std::string>(result.error_cstr());
+    VirtualFileSystem::Instance().Unmount(extracted_path);
   }
-  
-  return this->LoadPackageFromDisk<ScriptedDataType>(extracted_path);
+
+  return result;
 #elif
   return stx::error<std::string>("std::filesystem not supported");
 #endif
 }
 
+template<typename MetaClass>
+template<typename ScriptedDataType>
+stx::result_t<std::string> PackageManager<MetaClass>::LoadPackageFromMemory(const std::string& path, std::vector<char>&& zipData)
+{
+#if defined(BN_MOD_SUPPORT) && !defined(__APPLE__)
+  std::string mount_path = std::filesystem::absolute(path).generic_string();
+
+  if (auto result = VirtualFileSystem::Instance().MountZip(mount_path, std::move(zipData)); result.is_error()) {
+    return stx::error<std::string>(result.error_cstr());
+  }
+
+  auto result = this->LoadPackageFromDisk<ScriptedDataType>(mount_path);
+
+  if (result.is_error()) {
+    VirtualFileSystem::Instance().Unmount(mount_path);
+  }
+
+  return result;
+#else
+  return stx::error<std::string>("std::filesystem not supported");
+#endif
+}
+
 /**
  * @brief Sets the deferred type constructor for T
  *
@@ -452,6 +501,8 @@ stx::result_t<bool> PackageManager<MetaClass>::Commit(MetaClass* package)
     return stx::error<bool>(std::string("package ID was not set"));
   }
 
+  std::scoped_lock lock(commitMutex);
+
   if (packages.find(packageId) != packages.end()) {
     return stx::error<bool>(std::string("There is already a package in the package manager with id of ") + packageId);
   }
@@ -474,6 +525,7 @@ stx::result_t<std::string> PackageManager<MetaClass>::RemovePackageByID(const st
 {
   if (auto iter = packages.find(id); iter != packages.end()) {
     std::string path = iter->second->filepath;
+    VirtualFileSystem::Instance().Unmount(path);
     filepathToPackageId.erase(path);
     zipFilepathToPackageId.erase(path + ".zip");
 
@@ -585,6 +637,10 @@ inline void PackageManager<MetaClass>::ClearPackages()
     handle.Scripts().DropPackageData(addr);
   }
 
+  for (auto& [path, _] : filepathToPackageId) {
+    VirtualFileSystem::Instance().Unmount(path);
+  }
+
   packages.clear();
   filepathToPackageId.clear();
   zipFilepathToPackageId.clear();
@@ -601,6 +657,8 @@ inline void PackageManager<MetaClass>::ErasePackages()
   }
 
   for (auto& [path, _] : filepathToPackageId) {
+    VirtualFileSystem::Instance().Unmount(path);
+
     std::filesystem::path absolute = std::filesystem::absolute(path);
     std::filesystem::remove_all(absolute);
   }
@@ -20,6 +20,10 @@ ParticlePoof::ParticlePoof() :
   animation = Animation(RESOURCE_PATH);
   animation.Reload();
 
+  Play();
+}
+
+void ParticlePoof::Play() {
   animation.SetAnimation("DEFAULT");
 
   auto onEnd = [this]() {
@@ -29,7 +33,14 @@ ParticlePoof::ParticlePoof() :
   animation << onEnd;
 
   animation.Update(0, getSprite());
+}
 
+void ParticlePoof::OnPoolReset() {
+  SetLayer(0);
+  setTexture(Textures().LoadFromFile(TexturePaths::SPELL_POOF));
+  setScale(2.f, 2.f);
+  SetHeight(0);
+  Play();
 }
 
 void ParticlePoof::OnUpdate(double _elapsed) {
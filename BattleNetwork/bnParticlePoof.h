@@ -10,6 +10,11 @@ class ParticlePoof : public Artifact {
 private:
   Animation animation;
   sf::Sprite poof;
+
+  /**
+   * \brief restarts the poof animation and deletes when finished
+   */
+  void Play();
 public:
   /**
    * \brief sets the animation 
@@ -26,6 +31,11 @@ public:
    * @param _elapsed in seconds
    */
   void OnUpdate(double _elapsed) override;
+
+  /**
+  * @brief Restarts the poof for recycled instances
+  */
+  void OnPoolReset() override;
   
   /** 
   * @brief Removes the poof
@@ -0,0 +1,327 @@
+#include "bnParticleSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  constexpr float DEG_TO_RAD = 3.14159265f / 180.f;
+
+  template<typename T>
+  void Move(std::vector<T>& values, size_t from, size_t to) {
+    values[to] = values[from];
+  }
+
+  template<typename T>
+  void Shrink(std::vector<T>& values, size_t size) {
+    values.resize(size);
+  }
+
+  sf::Uint8 Lerp(sf::Uint8 a, sf::Uint8 b, float t) {
+    return static_cast<sf::Uint8>(static_cast<float>(a) + (static_cast<float>(b) - static_cast<float>(a)) * t);
+  }
+}
+
+ParticleSystem::ParticleSystem(size_t capacity) :
+  capacity(capacity),
+  rand(std::random_device{}())
+{
+}
+
+size_t ParticleSystem::Emit(const ParticleEmitter& emitter, const sf::Vector2f& origin, size_t count)
+{
+  if (!emitter.texture) return 0;
+
+  count = std::min(count, capacity - std::min(capacity, this->count));
+
+  if (count == 0) return 0;
+
+  Buffer& buffer = FindBuffer(emitter.texture, emitter.blendMode);
+
+  sf::IntRect frame = emitter.frame;
+
+  if (frame.width == 0 || frame.height == 0) {
+    const sf::Vector2u size = emitter.texture->getSize();
+    frame = sf::IntRect(0, 0, static_cast<int>(size.x), static_cast<int>(size.y));
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    const float life = std::max(Range(emitter.minLifetime, emitter.maxLifetime), 0.001f);
+
+    buffer.x.push_back(origin.x + Range(-emitter.spread.x, emitter.spread.x));
+    buffer.y.push_back(origin.y + Range(-emitter.spread.y, emitter.spread.y));
+    buffer.vx.push_back(Range(emitter.minVelocity.x, emitter.maxVelocity.x));
+    buffer.vy.push_back(Range(emitter.minVelocity.y, emitter.maxVelocity.y));
+    buffer.ax.push_back(emitter.acceleration.x);
+    buffer.ay.push_back(emitter.acceleration.y);
+    buffer.drag.push_back(std::max(emitter.drag, 0.f));
+    buffer.age.push_back(0.f);
+    buffer.life.push_back(life);
+    buffer.scale.push_back(emitter.startScale);
+    buffer.scaleDelta.push_back((emitter.endScale - emitter.startScale) / life);
+    buffer.rotation.push_back(0.f);
+    buffer.spin.push_back(Range(emitter.minSpin, emitter.maxSpin));
+    buffer.startColor.push_back(emitter.startColor);
+    buffer.endColor.push_back(emitter.endColor);
+    buffer.frame.push_back(frame);
+  }
+
+  this->count += count;
+  return count;
+}
+
+void ParticleSystem::Update(double elapsed)
+{
+  const float dt = static_cast<float>(elapsed);
+
+  count = 0;
+
+  for (Buffer& buffer : buffers) {
+    Integrate(buffer, dt);
+
+    const size_t alive = RemoveExpired(buffer);
+
+    // let go of textures nothing is drawing anymore
+    if (alive == 0) {
+      buffer.texture.reset();
+    }
+
+    count += alive;
+  }
+}
+
+void ParticleSystem::Draw(sf::RenderTarget& target, sf::RenderStates states)
+{
+  drawCalls = 0;
+
+  for (Buffer& buffer : buffers) {
+    if (buffer.Size() == 0) continue;
+
+    BuildVertices(buffer);
+
+    states.texture = buffer.texture.get();
+    states.blendMode = buffer.blendMode;
+
+    target.draw(buffer.vertices.data(), buffer.vertices.size(), sf::Triangles, states);
+    drawCalls++;
+  }
+}
+
+void ParticleSystem::Clear()
+{
+  for (Buffer& buffer : buffers) {
+    buffer.Clear();
+  }
+
+  count = 0;
+}
+
+void ParticleSystem::SetCapacity(size_t capacity)
+{
+  this->capacity = capacity;
+}
+
+const size_t ParticleSystem::GetCapacity() const
+{
+  return capacity;
+}
+
+const size_t ParticleSystem::Count() const
+{
+  return count;
+}
+
+const size_t ParticleSystem::DrawCalls() const
+{
+  return drawCalls;
+}
+
+ParticleSystem::Buffer& ParticleSystem::FindBuffer(const std::shared_ptr<sf::Texture>& texture, const sf::BlendMode& blendMode)
+{
+  auto iter = std::find_if(buffers.begin(), buffers.end(), [&texture, &blendMode](const Buffer& buffer) {
+    return buffer.texture == texture && buffer.blendMode == blendMode;
+  });
+
+  if (iter != buffers.end()) {
+    return *iter;
+  }
+
+  // reuse a buffer that emptied out before making a new one
+  iter = std::find_if(buffers.begin(), buffers.end(), [](const Buffer& buffer) {
+    return buffer.Size() == 0;
+  });
+
+  if (iter == buffers.end()) {
+    buffers.emplace_back();
+    iter = std::prev(buffers.end());
+  }
+
+  iter->texture = texture;
+  iter->blendMode = blendMode;
+  return *iter;
+}
+
+float ParticleSystem::Range(float min, float max)
+{
+  if (max <= min) return min;
+
+  return std::uniform_real_distribution<float>(min, max)(rand);
+}
+
+void ParticleSystem::Integrate(Buffer& buffer, float dt)
+{
+  const size_t n = buffer.Size();
+
+  float* x = buffer.x.data();
+  float* y = buffer.y.data();
+  float* vx = buffer.vx.data();
+  float* vy = buffer.vy.data();
+  const float* ax = buffer.ax.data();
+  const float* ay = buffer.ay.data();
+  const float* drag = buffer.drag.data();
+  float* age = buffer.age.data();
+  float* scale = buffer.scale.data();
+  const float* scaleDelta = buffer.scaleDelta.data();
+  float* rotation = buffer.rotation.data();
+  const float* spin = buffer.spin.data();
+
+  // each loop reads and writes contiguous floats with no branches
+  for (size_t i = 0; i < n; i++) {
+    const float damping = 1.f / (1.f + drag[i] * dt);
+    vx[i] = (vx[i] + ax[i] * dt) * damping;
+    vy[i] = (vy[i] + ay[i] * dt) * damping;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    x[i] += vx[i] * dt;
+    y[i] += vy[i] * dt;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    age[i] += dt;
+    scale[i] += scaleDelta[i] * dt;
+    rotation[i] += spin[i] * dt;
+  }
+}
+
+size_t ParticleSystem::RemoveExpired(Buffer& buffer)
+{
+  const size_t n = buffer.Size();
+  size_t alive = 0;
+
+  // keeps the order particles were emitted in so overlapping particles do not flicker
+  for (size_t i = 0; i < n; i++) {
+    if (buffer.age[i] >= buffer.life[i]) continue;
+
+    if (alive != i) {
+      Move(buffer.x, i, alive);
+      Move(buffer.y, i, alive);
+      Move(buffer.vx, i, alive);
+      Move(buffer.vy, i, alive);
+      Move(buffer.ax, i, alive);
+      Move(buffer.ay, i, alive);
+      Move(buffer.drag, i, alive);
+      Move(buffer.age, i, alive);
+      Move(buffer.life, i, alive);
+      Move(buffer.scale, i, alive);
+      Move(buffer.scaleDelta, i, alive);
+      Move(buffer.rotation, i, alive);
+      Move(buffer.spin, i, alive);
+      Move(buffer.startColor, i, alive);
+      Move(buffer.endColor, i, alive);
+      Move(buffer.frame, i, alive);
+    }
+
+    alive++;
+  }
+
+  if (alive != n) {
+    Shrink(buffer.x, alive);
+    Shrink(buffer.y, alive);
+    Shrink(buffer.vx, alive);
+    Shrink(buffer.vy, alive);
+    Shrink(buffer.ax, alive);
+    Shrink(buffer.ay, alive);
+    Shrink(buffer.drag, alive);
+    Shrink(buffer.age, alive);
+    Shrink(buffer.life, alive);
+    Shrink(buffer.scale, alive);
+    Shrink(buffer.scaleDelta, alive);
+    Shrink(buffer.rotation, alive);
+    Shrink(buffer.spin, alive);
+    Shrink(buffer.startColor, alive);
+    Shrink(buffer.endColor, alive);
+    Shrink(buffer.frame, alive);
+  }
+
+  return alive;
+}
+
+void ParticleSystem::BuildVertices(Buffer& buffer)
+{
+  const size_t n = buffer.Size();
+  buffer.vertices.resize(n * 6u);
+
+  sf::Vertex* v = buffer.vertices.data();
+
+  for (size_t i = 0; i < n; i++, v += 6) {
+    const sf::IntRect& frame = buffer.frame[i];
+    const float t = std::min(buffer.age[i] / buffer.life[i], 1.f);
+    const sf::Color& from = buffer.startColor[i];
+    const sf::Color& to = buffer.endColor[i];
+    const sf::Color color(Lerp(from.r, to.r, t), Lerp(from.g, to.g, t), Lerp(from.b, to.b, t), Lerp(from.a, to.a, t));
+
+    // half extents of the frame, rotated about the particle's center
+    const float scale = std::max(buffer.scale[i], 0.f);
+    const float halfW = static_cast<float>(frame.width) * 0.5f * scale;
+    const float halfH = static_cast<float>(frame.height) * 0.5f * scale;
+    const float radians = buffer.rotation[i] * DEG_TO_RAD;
+    const float c = std::cos(radians), s = std::sin(radians);
+
+    const sf::Vector2f center(buffer.x[i], buffer.y[i]);
+    const sf::Vector2f right(c * halfW, s * halfW);
+    const sf::Vector2f down(-s * halfH, c * halfH);
+
+    const float left = static_cast<float>(frame.left);
+    const float top = static_cast<float>(frame.top);
+    const float texRight = left + static_cast<float>(frame.width);
+    const float texBottom = top + static_cast<float>(frame.height);
+
+    const sf::Vertex topLeft(center - right - down, color, sf::Vector2f(left, top));
+    const sf::Vertex bottomLeft(center - right + down, color, sf::Vector2f(left, texBottom));
+    const sf::Vertex topRight(center + right - down, color, sf::Vector2f(texRight, top));
+    const sf::Vertex bottomRight(center + right + down, color, sf::Vector2f(texRight, texBottom));
+
+    v[0] = topLeft;
+    v[1] = bottomLeft;
+    v[2] = topRight;
+    v[3] = topRight;
+    v[4] = bottomLeft;
+    v[5] = bottomRight;
+  }
+}
+
+const size_t ParticleSystem::Buffer::Size() const
+{
+  return x.size();
+}
+
+void ParticleSystem::Buffer::Clear()
+{
+  x.clear();
+  y.clear();
+  vx.clear();
+  vy.clear();
+  ax.clear();
+  ay.clear();
+  drag.clear();
+  age.clear();
+  life.clear();
+  scale.clear();
+  scaleDelta.clear();
+  rotation.clear();
+  spin.clear();
+  startColor.clear();
+  endColor.clear();
+  frame.clear();
+  vertices.clear();
+  texture.reset();
+}
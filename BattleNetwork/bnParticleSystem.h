@@ -0,0 +1,110 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <random>
+#include <vector>
+
+/**
+ * @struct ParticleEmitter
+ * @brief Describes how new particles look and move. Every range is picked uniformly per particle.
+ *
+ * Emitters are plain values. They own nothing but a reference to the texture and can be
+ * copied, kept by scripts and reused for as many Emit() calls as needed.
+ */
+struct ParticleEmitter {
+  std::shared_ptr<sf::Texture> texture;
+  sf::IntRect frame; /*!< Region of the texture drawn for each particle. Empty uses the whole texture */
+  sf::BlendMode blendMode{ sf::BlendAlpha };
+  sf::Vector2f spread; /*!< Particles start up to this far from the origin on each axis */
+  sf::Vector2f minVelocity, maxVelocity; /*!< pixels per second */
+  sf::Vector2f acceleration; /*!< pixels per second squared, e.g. gravity */
+  float drag{}; /*!< Fraction of velocity lost per second */
+  float minLifetime{ 1.f }, maxLifetime{ 1.f }; /*!< seconds */
+  float startScale{ 1.f }, endScale{ 1.f };
+  float minSpin{}, maxSpin{}; /*!< degrees per second */
+  sf::Color startColor{ sf::Color::White }, endColor{ sf::Color::White };
+};
+
+/**
+ * @class ParticleSystem
+ * @brief Simulates and draws large numbers of short lived visual effects without entities
+ *
+ * Particles live in one buffer per texture and blend mode. Each property has its own array
+ * so the update kernel is a handful of flat loops over floats that the compiler can vectorize.
+ * Each buffer is drawn with a single call.
+ *
+ * Particles do not interact with anything and use their own random numbers,
+ * so they never affect the outcome of a battle or netplay sync.
+ */
+class ParticleSystem {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 8192;
+
+  ParticleSystem(size_t capacity = DEFAULT_CAPACITY);
+  ParticleSystem(const ParticleSystem&) = delete;
+  ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+  /**
+   * @brief Spawns `count` particles around `origin`
+   * @return how many particles were spawned. Less than `count` if the system is full.
+   */
+  size_t Emit(const ParticleEmitter& emitter, const sf::Vector2f& origin, size_t count = 1);
+
+  /**
+   * @brief Moves, ages and removes expired particles
+   * @param elapsed in seconds
+   */
+  void Update(double elapsed);
+
+  /**
+   * @brief Draws every particle. One draw call per texture and blend mode in use.
+   */
+  void Draw(sf::RenderTarget& target, sf::RenderStates states);
+
+  /**
+   * @brief Removes every particle. Buffers keep their capacity.
+   */
+  void Clear();
+
+  /**
+   * @brief Changes the maximum number of live particles. Existing particles are kept.
+   */
+  void SetCapacity(size_t capacity);
+
+  const size_t GetCapacity() const;
+  const size_t Count() const;
+
+  /**
+   * @brief Draw calls made by the last Draw()
+   */
+  const size_t DrawCalls() const;
+
+private:
+  struct Buffer {
+    std::shared_ptr<sf::Texture> texture;
+    sf::BlendMode blendMode;
+
+    // one entry per particle in every array
+    std::vector<float> x, y, vx, vy, ax, ay, drag;
+    std::vector<float> age, life;
+    std::vector<float> scale, scaleDelta;
+    std::vector<float> rotation, spin;
+    std::vector<sf::Color> startColor, endColor;
+    std::vector<sf::IntRect> frame;
+
+    std::vector<sf::Vertex> vertices; /*!< sf::Triangles, 6 per particle. Keeps its capacity between frames */
+
+    const size_t Size() const;
+    void Clear();
+  };
+
+  std::vector<Buffer> buffers;
+  size_t capacity{}, count{}, drawCalls{};
+  std::minstd_rand rand;
+
+  Buffer& FindBuffer(const std::shared_ptr<sf::Texture>& texture, const sf::BlendMode& blendMode);
+  float Range(float min, float max);
+  static void Integrate(Buffer& buffer, float dt);
+  static size_t RemoveExpired(Buffer& buffer);
+  static void BuildVertices(Buffer& buffer);
+};
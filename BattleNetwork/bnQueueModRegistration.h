@@ -4,6 +4,7 @@
 #pragma once
 #include <vector>
 #include <functional>
+#include "bnBootScheduler.h"
 
 // TODO: mac os < 10.5 file system support...
 #ifndef __APPLE__
@@ -21,10 +22,17 @@ static inline stx::result_t<bool> InstallMod(PackageManagerT& packageManager, co
   return stx::error<bool>(result.error_cstr());
 }
 
+/**
+ * @brief Queues one install job per package found in modPath
+ *
+ * Package folders win over a zip of the same name. Jobs of the same stage may run concurrently,
+ * PackageManager::Commit() serializes registration.
+ */
 template<typename PackageManagerT, typename ScriptedResourceT>
-static inline void QueueModRegistration(PackageManagerT& packageManager, const char* modPath, const char* modCategory) {
+static inline void QueueModRegistration(PackageManagerT& packageManager, const char* modPath, const char* modCategory, BootScheduler& scheduler, BootScheduler::StageID stage) {
 #if defined(BN_MOD_SUPPORT) && !defined(__APPLE__)
   std::map<std::string, bool> ignoreList;
+  std::vector<std::string> folderList;
   std::vector<std::string> zipList;
 
   std::filesystem::create_directories(modPath);
@@ -41,22 +49,23 @@ static inline void QueueModRegistration(PackageManagerT& packageManager, const c
     if (size_t pos = full_path.find(".md"); pos != std::string::npos)
       continue;
 
-    try {
-      if (size_t pos = full_path.find(".zip"); pos == std::string::npos) {
-        ignoreList[full_path] = true;
-        ignoreList[full_path + ".zip"] = true;
-
-        if (auto res = InstallMod<PackageManagerT, ScriptedResourceT>(packageManager, full_path); res.is_error()) {
-          throw std::runtime_error(res.error_cstr());
-        }
-      }
-      else {
-        zipList.push_back(full_path);
-      }
+    if (entry.path().extension() == ".zip") {
+      zipList.push_back(full_path);
     }
-    catch (std::runtime_error& e) {
-      Logger::Logf(LogLevel::critical, "[%s] extracted package error: %s", modCategory, e.what());
+    else if (entry.is_directory()) {
+      ignoreList[full_path] = true;
+      ignoreList[full_path + ".zip"] = true;
+      folderList.push_back(full_path);
     }
+    // other files, such as unfinished .zip.tmp files, are not packages
+  }
+
+  for (const auto& path : folderList) {
+    scheduler.AddJob(stage, [&packageManager, path, modCategory] {
+      if (auto res = InstallMod<PackageManagerT, ScriptedResourceT>(packageManager, path); res.is_error()) {
+        Logger::Logf(LogLevel::critical, "[%s] extracted package error: %s", modCategory, res.error_cstr());
+      }
+    });
   }
 
   for (const auto& path : zipList) {
@@ -64,14 +73,11 @@ static inline void QueueModRegistration(PackageManagerT& packageManager, const c
     if (ignoreList.find(path) != ignoreList.end())
       continue;
 
-    try {
+    scheduler.AddJob(stage, [&packageManager, path, modCategory] {
       if (auto res = packageManager.template LoadPackageFromZip<ScriptedResourceT>(path); res.is_error()) {
-        throw std::runtime_error(res.error_cstr());
+        Logger::Logf(LogLevel::critical, "[%s] .zip package error %s", modCategory, res.error_cstr());
       }
-    }
-    catch (std::runtime_error& e) {
-      Logger::Logf(LogLevel::critical, "[%s] .zip package error %s", modCategory, e.what());
-    }
+    });
   }
 #endif
-}
\ No newline at end of file
+}
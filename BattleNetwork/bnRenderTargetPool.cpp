@@ -0,0 +1,149 @@
+#include "bnRenderTargetPool.h"
+#include "bnLogger.h"
+#include <algorithm>
+
+RenderTargetPool::Lease::Lease(Lease&& rhs) noexcept
+{
+  *this = std::move(rhs);
+}
+
+RenderTargetPool::Lease& RenderTargetPool::Lease::operator=(Lease&& rhs) noexcept
+{
+  if (this != &rhs) {
+    Reset();
+    pool = rhs.pool;
+    entry = rhs.entry;
+    rhs.pool = nullptr;
+    rhs.entry = nullptr;
+  }
+
+  return *this;
+}
+
+RenderTargetPool::Lease::~Lease()
+{
+  Reset();
+}
+
+void RenderTargetPool::Lease::Reset()
+{
+  if (pool && entry) {
+    pool->Release(entry);
+  }
+
+  pool = nullptr;
+  entry = nullptr;
+}
+
+sf::RenderTexture& RenderTargetPool::Lease::Get() const
+{
+  return entry->texture;
+}
+
+RenderTargetPool::RenderTargetPool(size_t idleLimit) : idleLimit(idleLimit)
+{
+}
+
+RenderTargetPool::Lease RenderTargetPool::Acquire(const sf::Vector2u& size)
+{
+  Entry* found = nullptr;
+
+  for (std::unique_ptr<Entry>& entry : entries) {
+    if (!entry->leased && entry->size == size) {
+      found = entry.get();
+      break;
+    }
+  }
+
+  if (!found) {
+    auto entry = std::make_unique<Entry>();
+
+    if (!entry->texture.create(size.x, size.y)) {
+      Logger::Logf(LogLevel::critical, "Failed to create a %ux%u render target", size.x, size.y);
+      return Lease();
+    }
+
+    entry->size = size;
+    found = entry.get();
+    entries.push_back(std::move(entry));
+    created++;
+  }
+
+  found->leased = true;
+  found->lastUsed = ++clock;
+
+  // the last user may have changed these
+  found->texture.setView(found->texture.getDefaultView());
+  found->texture.clear(sf::Color::Transparent);
+
+  return Lease(this, found);
+}
+
+void RenderTargetPool::SetIdleLimit(size_t limit)
+{
+  idleLimit = limit;
+  Trim();
+}
+
+void RenderTargetPool::Clear()
+{
+  entries.erase(std::remove_if(entries.begin(), entries.end(), [](const std::unique_ptr<Entry>& entry) {
+    return !entry->leased;
+  }), entries.end());
+}
+
+const size_t RenderTargetPool::Count() const
+{
+  return entries.size();
+}
+
+const size_t RenderTargetPool::BytesAllocated() const
+{
+  size_t total = 0;
+
+  for (const std::unique_ptr<Entry>& entry : entries) {
+    total += static_cast<size_t>(entry->size.x) * entry->size.y * 4u;
+  }
+
+  return total;
+}
+
+const size_t RenderTargetPool::CreatedCount() const
+{
+  return created;
+}
+
+RenderTargetPool& RenderTargetPool::Instance()
+{
+  static RenderTargetPool pool;
+  return pool;
+}
+
+void RenderTargetPool::Release(Entry* entry)
+{
+  entry->leased = false;
+  entry->lastUsed = ++clock;
+  Trim();
+}
+
+void RenderTargetPool::Trim()
+{
+  size_t idle = std::count_if(entries.begin(), entries.end(), [](const std::unique_ptr<Entry>& entry) {
+    return !entry->leased;
+  });
+
+  while (idle > idleLimit) {
+    auto oldest = entries.end();
+
+    for (auto iter = entries.begin(); iter != entries.end(); iter++) {
+      if ((*iter)->leased) continue;
+
+      if (oldest == entries.end() || (*iter)->lastUsed < (*oldest)->lastUsed) {
+        oldest = iter;
+      }
+    }
+
+    entries.erase(oldest);
+    idle--;
+  }
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class RenderTargetPool
+ * @brief Reuses off-screen render textures across frames and scenes
+ *
+ * Creating an sf::RenderTexture allocates a texture and a framebuffer on the GPU.
+ * Effects that need a scratch target every frame lease one from the pool instead.
+ * When the lease is dropped the target goes back to the pool for the next request of the same size.
+ *
+ * Idle targets beyond the idle limit are freed, oldest first, so GPU memory stays bounded.
+ * @warning The pool is not thread safe. Only use it on the render thread.
+ */
+class RenderTargetPool {
+  struct Entry {
+    sf::RenderTexture texture;
+    sf::Vector2u size;
+    bool leased{};
+    uint64_t lastUsed{};
+  };
+
+public:
+  static constexpr size_t DEFAULT_IDLE_LIMIT = 8;
+
+  /**
+   * @class Lease
+   * @brief Exclusive use of a pooled render target. Returns the target to the pool when destroyed. Move only.
+   */
+  class Lease {
+    friend class RenderTargetPool;
+
+    RenderTargetPool* pool{ nullptr };
+    Entry* entry{ nullptr };
+
+    Lease(RenderTargetPool* pool, Entry* entry) : pool(pool), entry(entry) {}
+
+  public:
+    Lease() = default;
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease(Lease&& rhs) noexcept;
+    Lease& operator=(Lease&& rhs) noexcept;
+    ~Lease();
+
+    /**
+     * @brief Returns the target to the pool now instead of waiting for the destructor
+     */
+    void Reset();
+
+    sf::RenderTexture& Get() const;
+    sf::RenderTexture* operator->() const { return &Get(); }
+    explicit operator bool() const { return entry != nullptr; }
+  };
+
+  explicit RenderTargetPool(size_t idleLimit = DEFAULT_IDLE_LIMIT);
+  ~RenderTargetPool() = default;
+
+  RenderTargetPool(const RenderTargetPool&) = delete;
+  RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+  /**
+   * @brief Leases a cleared render target of exactly `size` pixels with its default view
+   * @return an empty lease if the target could not be created
+   */
+  Lease Acquire(const sf::Vector2u& size);
+
+  /**
+   * @brief Max number of targets kept while nobody leases them
+   */
+  void SetIdleLimit(size_t limit);
+
+  /**
+   * @brief Frees every target that is not leased
+   */
+  void Clear();
+
+  /**
+   * @brief Number of targets alive, leased or idle
+   */
+  const size_t Count() const;
+
+  /**
+   * @brief Approximate GPU memory held by the pool, 4 bytes per pixel
+   */
+  const size_t BytesAllocated() const;
+
+  /**
+   * @brief Number of targets that had to be created because none could be reused
+   */
+  const size_t CreatedCount() const;
+
+  /**
+   * @brief The pool shared by the whole app
+   */
+  static RenderTargetPool& Instance();
+
+private:
+  size_t idleLimit{};
+  size_t created{};
+  uint64_t clock{};
+  std::vector<std::unique_ptr<Entry>> entries; /*!< heap allocated so leases can point into them */
+
+  void Release(Entry* entry);
+  void Trim();
+};
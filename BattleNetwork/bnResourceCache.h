@@ -0,0 +1,344 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct ResourceCacheStats {
+  size_t hits{};
+  size_t misses{};
+  size_t evictions{};
+  size_t bytes{}; /*!< Bytes held by every entry, including ones that cannot be evicted */
+  size_t entries{};
+
+  ResourceCacheStats& operator+=(const ResourceCacheStats& other) {
+    hits += other.hits;
+    misses += other.misses;
+    evictions += other.evictions;
+    bytes += other.bytes;
+    entries += other.entries;
+    return *this;
+  }
+};
+
+/**
+ * @class ResourceCache
+ * @brief Thread-safe cache of shared resources that stays under a byte budget
+ *
+ * Entries are spread over shards, each with its own lock, so loaders on different
+ * threads rarely wait on each other. Every entry records how many bytes it costs.
+ * When the total goes over the budget, the least recently used entries are dropped
+ * until it fits again. Entries that are permanent, pinned, or still referenced
+ * outside the cache are never dropped: freeing them would not release any memory.
+ * They still count against the budget, so the cache can stay over it while they are held.
+ */
+template<typename T>
+class ResourceCache {
+public:
+  using Stats = ResourceCacheStats;
+
+  static constexpr size_t SHARD_COUNT = 8;
+
+  explicit ResourceCache(size_t budget) : budget(budget) {}
+
+  ResourceCache(const ResourceCache&) = delete;
+  ResourceCache& operator=(const ResourceCache&) = delete;
+
+  /**
+   * @brief Returns the resource and marks it as most recently used
+   * @return nullptr if key is not cached
+   */
+  std::shared_ptr<T> Find(const std::string& key) {
+    Shard& shard = ShardFor(key);
+    std::scoped_lock lock(shard.mutex);
+
+    auto iter = shard.index.find(key);
+
+    if (iter == shard.index.end()) {
+      misses.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    hits.fetch_add(1, std::memory_order_relaxed);
+    Touch(shard, iter->second);
+    return iter->second->resource;
+  }
+
+  /**
+   * @brief Caches the resource unless key is already cached
+   * @param size bytes the resource costs
+   * @param permanent if true the entry is never evicted
+   * @return the resource that ended up in the cache. Callers should use this one.
+   */
+  std::shared_ptr<T> Insert(const std::string& key, std::shared_ptr<T> resource, size_t size, bool permanent = false) {
+    std::shared_ptr<T> result;
+
+    {
+      Shard& shard = ShardFor(key);
+      std::scoped_lock lock(shard.mutex);
+
+      auto iter = shard.index.find(key);
+
+      if (iter != shard.index.end()) {
+        Touch(shard, iter->second);
+        return iter->second->resource;
+      }
+
+      result = resource;
+      Add(shard, key, std::move(resource), size, permanent);
+    }
+
+    Trim();
+    return result;
+  }
+
+  /**
+   * @brief Caches the resource, dropping the entry already cached for key
+   */
+  void Replace(const std::string& key, std::shared_ptr<T> resource, size_t size, bool permanent = false) {
+    {
+      Shard& shard = ShardFor(key);
+      std::scoped_lock lock(shard.mutex);
+
+      auto iter = shard.index.find(key);
+
+      if (iter != shard.index.end()) {
+        Remove(shard, iter->second);
+      }
+
+      Add(shard, key, std::move(resource), size, permanent);
+    }
+
+    Trim();
+  }
+
+  /**
+   * @return true if key was cached
+   */
+  bool Erase(const std::string& key) {
+    Shard& shard = ShardFor(key);
+    std::scoped_lock lock(shard.mutex);
+
+    auto iter = shard.index.find(key);
+
+    if (iter == shard.index.end()) {
+      return false;
+    }
+
+    Remove(shard, iter->second);
+    return true;
+  }
+
+  /**
+   * @brief Keeps the entry from being evicted until a matching Unpin()
+   * @return false if key is not cached
+   */
+  bool Pin(const std::string& key) {
+    Shard& shard = ShardFor(key);
+    std::scoped_lock lock(shard.mutex);
+
+    auto iter = shard.index.find(key);
+
+    if (iter == shard.index.end()) {
+      return false;
+    }
+
+    iter->second->pins++;
+    return true;
+  }
+
+  void Unpin(const std::string& key) {
+    Shard& shard = ShardFor(key);
+    std::scoped_lock lock(shard.mutex);
+
+    auto iter = shard.index.find(key);
+
+    if (iter != shard.index.end() && iter->second->pins > 0) {
+      iter->second->pins--;
+    }
+  }
+
+  /**
+   * @brief Changes whether the entry can be evicted
+   * @return false if key is not cached
+   */
+  bool SetPermanent(const std::string& key, bool permanent) {
+    Shard& shard = ShardFor(key);
+    std::scoped_lock lock(shard.mutex);
+
+    auto iter = shard.index.find(key);
+
+    if (iter == shard.index.end()) {
+      return false;
+    }
+
+    iter->second->permanent = permanent;
+    return true;
+  }
+
+  void SetBudget(size_t bytes) {
+    budget.store(bytes, std::memory_order_relaxed);
+    Trim();
+  }
+
+  const size_t GetBudget() const {
+    return budget.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Evicts least recently used entries until the cache fits its budget
+   * @return bytes released
+   */
+  size_t Trim() {
+    size_t released = 0;
+
+    while (bytes.load(std::memory_order_relaxed) > GetBudget()) {
+      // stop if everything left is in use
+      if (!EvictOldest(released)) break;
+    }
+
+    return released;
+  }
+
+  /**
+   * @brief Drops every entry, including permanent and pinned ones
+   */
+  void Clear() {
+    for (Shard& shard : shards) {
+      std::scoped_lock lock(shard.mutex);
+
+      while (!shard.lru.empty()) {
+        Remove(shard, std::prev(shard.lru.end()));
+      }
+    }
+  }
+
+  const Stats GetStats() const {
+    Stats stats;
+    stats.hits = hits.load(std::memory_order_relaxed);
+    stats.misses = misses.load(std::memory_order_relaxed);
+    stats.evictions = evictions.load(std::memory_order_relaxed);
+    stats.bytes = bytes.load(std::memory_order_relaxed);
+    stats.entries = entries.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<T> resource;
+    size_t bytes{};
+    size_t lastUse{}; /*!< Value of the cache clock when the entry was last requested */
+    unsigned pins{};
+    bool permanent{};
+
+    const bool IsEvictable() const {
+      return !permanent && pins == 0 && resource.use_count() <= 1;
+    }
+  };
+
+  using EntryList = std::list<Entry>;
+
+  struct Shard {
+    std::mutex mutex;
+    EntryList lru; /*!< Most recently used first */
+    std::unordered_map<std::string, typename EntryList::iterator> index;
+  };
+
+  std::array<Shard, SHARD_COUNT> shards;
+  std::atomic<size_t> budget;
+  std::atomic<size_t> clock{ 0 };
+  std::atomic<size_t> bytes{ 0 };
+  std::atomic<size_t> entries{ 0 };
+  std::atomic<size_t> hits{ 0 };
+  std::atomic<size_t> misses{ 0 };
+  std::atomic<size_t> evictions{ 0 };
+
+  Shard& ShardFor(const std::string& key) {
+    return shards[std::hash<std::string>{}(key) % SHARD_COUNT];
+  }
+
+  void Touch(Shard& shard, typename EntryList::iterator entry) {
+    entry->lastUse = clock.fetch_add(1, std::memory_order_relaxed);
+    shard.lru.splice(shard.lru.begin(), shard.lru, entry);
+  }
+
+  void Add(Shard& shard, const std::string& key, std::shared_ptr<T> resource, size_t size, bool permanent) {
+    Entry entry;
+    entry.key = key;
+    entry.resource = std::move(resource);
+    entry.bytes = size;
+    entry.lastUse = clock.fetch_add(1, std::memory_order_relaxed);
+    entry.permanent = permanent;
+
+    shard.lru.push_front(std::move(entry));
+    shard.index.emplace(key, shard.lru.begin());
+
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    entries.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Remove(Shard& shard, typename EntryList::iterator entry) {
+    bytes.fetch_sub(entry->bytes, std::memory_order_relaxed);
+    entries.fetch_sub(1, std::memory_order_relaxed);
+
+    shard.index.erase(entry->key);
+    shard.lru.erase(entry);
+  }
+
+  /**
+   * @brief Finds the least recently used evictable entry in a shard. Shard must be locked.
+   */
+  typename EntryList::iterator OldestEvictable(Shard& shard) {
+    for (auto iter = shard.lru.rbegin(); iter != shard.lru.rend(); iter++) {
+      if (iter->IsEvictable()) {
+        return std::prev(iter.base());
+      }
+    }
+
+    return shard.lru.end();
+  }
+
+  /**
+   * @brief Evicts the least recently used evictable entry across all shards
+   * @param released increased by the bytes of the evicted entry
+   * @return false if nothing could be evicted
+   */
+  bool EvictOldest(size_t& released) {
+    // shards are locked one at a time so the pick can go stale. It is checked again before erasing
+    while (true) {
+      Shard* victimShard = nullptr;
+      size_t oldest = 0;
+
+      for (Shard& shard : shards) {
+        std::scoped_lock lock(shard.mutex);
+        auto candidate = OldestEvictable(shard);
+
+        if (candidate != shard.lru.end() && (!victimShard || candidate->lastUse < oldest)) {
+          victimShard = &shard;
+          oldest = candidate->lastUse;
+        }
+      }
+
+      if (!victimShard) {
+        return false;
+      }
+
+      std::scoped_lock lock(victimShard->mutex);
+      auto victim = OldestEvictable(*victimShard);
+
+      if (victim == victimShard->lru.end() || victim->lastUse != oldest) {
+        continue;
+      }
+
+      released += victim->bytes;
+      Remove(*victimShard, victim);
+      evictions.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <memory>
+
+/**
+ * @class ResourceFuture
+ * @brief Handle to a resource that is still loading in the background
+ *
+ * Cheap to copy. Every copy sees the resource once the owning resource manager finishes it.
+ * Until then Get() returns nullptr and GetOr() returns the placeholder it is given.
+ */
+template<typename T>
+class ResourceFuture {
+public:
+  struct State {
+    std::atomic<bool> ready{ false };
+    bool failed{ false };
+    std::shared_ptr<T> resource;
+
+    /**
+     * @brief Publishes the resource. Called once by the resource manager.
+     */
+    void Fulfill(std::shared_ptr<T> resource, bool failed) {
+      this->resource = std::move(resource);
+      this->failed = failed;
+      ready.store(true, std::memory_order_release);
+    }
+  };
+
+  ResourceFuture() = default;
+  explicit ResourceFuture(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+  /**
+   * @brief Handle for a resource that was already loaded
+   */
+  static ResourceFuture Ready(std::shared_ptr<T> resource) {
+    auto state = std::make_shared<State>();
+    state->Fulfill(std::move(resource), false);
+    return ResourceFuture(state);
+  }
+
+  const bool Valid() const {
+    return state != nullptr;
+  }
+
+  const bool IsReady() const {
+    return state && state->ready.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief True if the resource finished loading but the file could not be read.
+   *        The resource is still usable, it is just empty.
+   */
+  const bool Failed() const {
+    return IsReady() && state->failed;
+  }
+
+  std::shared_ptr<T> Get() const {
+    return IsReady() ? state->resource : nullptr;
+  }
+
+  std::shared_ptr<T> GetOr(const std::shared_ptr<T>& placeholder) const {
+    return IsReady() ? state->resource : placeholder;
+  }
+
+private:
+  std::shared_ptr<State> state;
+};
@@ -1,5 +1,7 @@
 #include "bnSceneNode.h"
 
+size_t SceneNode::layerChanges = 0;
+
 SceneNode::SceneNode() :
 show(true), layer(0), parent(nullptr), childNodes() {
 }
@@ -9,7 +11,17 @@ SceneNode::~SceneNode() {
 }
 
 void SceneNode::SetLayer(int layer) {
+  if (SceneNode::layer == layer) return;
+
   SceneNode::layer = layer;
+
+  // a node shared by more than one parent only knows the last one
+  // so other parents see the change through the counter
+  layerChanges++;
+
+  if (parent) {
+    parent->childrenDirty = true;
+  }
 }
 
 const int SceneNode::GetLayer() const {
@@ -35,7 +47,7 @@ const bool SceneNode::IsVisible() const {
 void SceneNode::draw(sf::RenderTarget& target, sf::RenderStates states) const {
   if (!show) return;
 
-  std::sort(childNodes.begin(), childNodes.end(), [](std::shared_ptr<SceneNode>& a, std::shared_ptr<SceneNode>& b) { return (a->GetLayer() > b->GetLayer()); });
+  SortChildren();
 
   // draw its children
   for (auto& childNode : childNodes) {
@@ -50,7 +62,20 @@ void SceneNode::draw(sf::RenderTarget& target, sf::RenderStates states) const {
 }
 
 void SceneNode::AddNode(std::shared_ptr<SceneNode> child) { 
-  if (child == nullptr) return;  child->parent = this; childNodes.push_back(child); 
+  if (child == nullptr) return;
+
+  child->parent = this;
+
+  if (childrenDirty || sortedAtLayerChange != layerChanges) {
+    // the list may be out of order, sort once before the next draw
+    childNodes.push_back(child);
+    childrenDirty = true;
+    return;
+  }
+
+  // after every child with the same layer so ties draw in the order they were added
+  auto iter = std::upper_bound(childNodes.begin(), childNodes.end(), child, &SceneNode::DrawsBefore);
+  childNodes.insert(iter, child);
 }
 
 void SceneNode::RemoveNode(std::shared_ptr<SceneNode> find) {
@@ -82,9 +107,27 @@ const bool SceneNode::IsUsingParentShader() const
 
 std::vector<std::shared_ptr<SceneNode>>& SceneNode::GetChildNodes() const
 {
+  SortChildren();
   return childNodes;
 }
 
+void SceneNode::SortChildren() const
+{
+  if (!childrenDirty && sortedAtLayerChange == layerChanges) return;
+
+  if (!std::is_sorted(childNodes.begin(), childNodes.end(), &SceneNode::DrawsBefore)) {
+    std::stable_sort(childNodes.begin(), childNodes.end(), &SceneNode::DrawsBefore);
+  }
+
+  childrenDirty = false;
+  sortedAtLayerChange = layerChanges;
+}
+
+bool SceneNode::DrawsBefore(const std::shared_ptr<SceneNode>& a, const std::shared_ptr<SceneNode>& b)
+{
+  return a->layer > b->layer;
+}
+
 std::set<std::shared_ptr<SceneNode>> SceneNode::GetChildNodesWithTag(const std::vector<std::string>& query)
 {
   std::set<std::shared_ptr<SceneNode>> results;
@@ -3,6 +3,10 @@
  * 
  * Nodes attached are not handled by the parent node.
  * Do not expect the deletion of this node to free the memory.
+ *
+ * Children are kept in draw order: descending layer, then the order they were added.
+ * AddNode() inserts in place and SetLayer() marks the parent for a re-sort,
+ * so drawing never sorts unless a layer actually changed.
  * */
 
 #pragma once
@@ -20,6 +24,20 @@ protected:
   bool show; /*!< Flag to hide or display a scene node and its children */
   int layer; /*!< Draw order of this node */
   bool useParentShader{ false }; /*!< Default: use your own internal shader*/
+  mutable bool childrenDirty{ false }; /*!< True if childNodes may be out of draw order */
+  mutable size_t sortedAtLayerChange{ 0 }; /*!< Value of layerChanges when childNodes were last known to be in order */
+
+  static size_t layerChanges; /*!< Bumped by every SetLayer() that changes a layer */
+
+  /**
+   * @brief Restores draw order if a layer changed since the last draw. Does nothing otherwise.
+   */
+  void SortChildren() const;
+
+  /**
+   * @brief Draw order of two nodes. Higher layers are drawn first.
+   */
+  static bool DrawsBefore(const std::shared_ptr<SceneNode>& a, const std::shared_ptr<SceneNode>& b);
 
 public:
   /**
@@ -69,7 +87,7 @@ public:
   const bool IsVisible() const;
 
   /**
-   * @brief Sort the nodes by Ascending Z Order and draw the nodes
+   * @brief Draw the nodes from highest to lowest layer
    * @param target
    * @param states
    */
@@ -103,8 +121,9 @@ public:
   const bool IsUsingParentShader() const;
 
   /**
-  * Fetches all the child nodes attached to this node
+  * Fetches all the child nodes attached to this node in draw order
   * @return a reference to the vector of SceneNode*
+  * @warning Use AddNode() and RemoveNode() to change the children
   */
   std::vector<std::shared_ptr<SceneNode>>& GetChildNodes() const;
 
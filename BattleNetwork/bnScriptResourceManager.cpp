@@ -3,6 +3,9 @@
 #include <vector>
 #include <functional>
 #include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <iterator>
 #include "bnScriptResourceManager.h"
 #include "bnAudioResourceManager.h"
 #include "bnTextureResourceManager.h"
@@ -13,6 +16,7 @@
 #include "bnMobPackageManager.h"
 #include "bnBlockPackageManager.h"
 #include "bnLuaLibraryPackageManager.h"
+#include "bnVirtualFileSystem.h"
 
 #include "bnCard.h"
 #include "bnEntity.h"
@@ -32,6 +36,7 @@
 #include "bindings/bnUserTypeSceneNode.h"
 #include "bindings/bnUserTypeSpriteNode.h"
 #include "bindings/bnUserTypeSyncNode.h"
+#include "bindings/bnUserTypeParticleEmitter.h"
 #include "bindings/bnUserTypeField.h"
 #include "bindings/bnUserTypeTile.h"
 #include "bindings/bnUserTypeEntity.h"
@@ -66,6 +71,109 @@ namespace {
 
     return sol::stack::push(L, description);
   }
+
+  // Run once per shared state with the state's globals, returns a function that creates the globals of one package.
+  // Every shared table a package reads, the globals included, is seen through an overlay that belongs to the package:
+  // reads fall through to the shared table and writes stay in the overlay. Loaders, metatables and the
+  // collector are wrapped so they cannot reach past the overlays either.
+  constexpr const char* PACKAGE_SANDBOX = R"(
+local shared = ...
+local type, next, rawget, rawset, select = type, next, rawget, rawset, select
+local getmetatable, setmetatable = getmetatable, setmetatable
+local load, loadfile, collectgarbage, error = load, loadfile, collectgarbage, error
+
+return function()
+  local overlays = {}
+
+  local function wrap(t)
+    local overlay = overlays[t]
+
+    if overlay then
+      return overlay
+    end
+
+    overlay = setmetatable({}, {
+      __index = function(self, key)
+        local value = t[key]
+
+        if type(value) == "table" then
+          value = wrap(value)
+        end
+
+        -- shared values never change once set, later reads skip this function
+        if value ~= nil then
+          rawset(self, key, value)
+        end
+
+        return value
+      end,
+      __pairs = function(self)
+        for key, value in next, t do
+          if rawget(self, key) == nil then
+            rawset(self, key, type(value) == "table" and wrap(value) or value)
+          end
+        end
+
+        return next, self, nil
+      end,
+      __metatable = false
+    })
+
+    overlays[t] = overlay
+    return overlay
+  end
+
+  local env = wrap(shared)
+
+  env.load = function(chunk, chunkname, mode, ...)
+    if select("#", ...) == 0 then
+      return load(chunk, chunkname, mode, env)
+    end
+
+    return load(chunk, chunkname, mode, ...)
+  end
+
+  env.loadfile = function(filename, mode, ...)
+    if select("#", ...) == 0 then
+      return loadfile(filename, mode, env)
+    end
+
+    return loadfile(filename, mode, ...)
+  end
+
+  env.dofile = function(filename)
+    local chunk, message = loadfile(filename, "bt", env)
+
+    if not chunk then
+      error(message, 2)
+    end
+
+    return chunk()
+  end
+
+  -- usertype metatables are shared by every package in the state
+  env.getmetatable = function(object)
+    local metatable = getmetatable(object)
+
+    if type(object) ~= "table" and type(metatable) == "table" then
+      return wrap(metatable)
+    end
+
+    return metatable
+  end
+
+  -- the collector is shared too. Packages may run it but not stop or tune it for everyone
+  env.collectgarbage = function(option, ...)
+    if option == nil or option == "collect" or option == "step" or option == "count" or option == "isrunning" then
+      return collectgarbage(option, ...)
+    end
+
+    return 0
+  end
+
+  return env
+end
+)";
 }
 
 // Creates a std::list<OverrideFrame> object from a provided table.
@@ -87,10 +195,9 @@ std::list<OverrideFrame> CreateFrameData(sol::lua_table table)
   return frames;
 }
 
-void ScriptResourceManager::SetSystemFunctions(ScriptPackage& scriptPackage)
+void ScriptResourceManager::SetSystemFunctions(LuaVM& vm)
 {
-  sol::state& state = *scriptPackage.state;
-  const std::string& namespaceId = scriptPackage.address.namespaceId;
+  sol::state& state = vm.state;
 
   state.open_libraries(sol::lib::base, sol::lib::math, sol::lib::table);
 
@@ -110,56 +217,12 @@ void ScriptResourceManager::SetSystemFunctions(ScriptPackage& scriptPackage)
       return (float)SyncedRand() / ((float)(SyncedRandMax()) + 1);
     }
   );
-
-  // 'include()' in Lua is intended to load a LIBRARY file of Lua code into the current lua state.
-  // Currently only loads library files included in the SAME directory as the script file.
-  // Has to capture a pointer to sol::state, the copy constructor was deleted, cannot capture a copy to reference.
-  state.set_function("include",
-    [this, &state, &namespaceId, &scriptPackage](const std::string& fileName) -> sol::object {
-      std::string scriptPath;
-
-      // Prefer using the shared libraries if possible.
-      // i.e. ones that were present in "mods/libs/"
-      // make sure it was required by checking dependencies as well
-      if(std::find(scriptPackage.dependencies.begin(), scriptPackage.dependencies.end(), scriptPath) != scriptPackage.dependencies.end())
-      {
-        Logger::Logf(LogLevel::debug, "Including shared library: %s", fileName.c_str());
-
-        auto* libraryPackage = FetchScriptPackage(namespaceId, fileName, ScriptPackageType::library);
-
-        if (!libraryPackage) {
-          throw std::runtime_error("Library package \"" + fileName + "\" is either not installed or has not had time to initialize");
-        }
-
-        scriptPath = libraryPackage->path;
-      }
-      else
-      {
-        Logger::Logf(LogLevel::debug, "Including local library: %s", fileName.c_str());
-
-        auto parentFolder = GetCurrentFolder(state).unwrap();
-        scriptPath = parentFolder + "/" + fileName;
-      }
-
-      sol::environment env(state, sol::create, state.globals());
-      env["_folderpath"] = std::filesystem::path(scriptPath).parent_path().string() + "/";
-
-      sol::protected_function_result result = state.do_file(scriptPath, env);
-
-      if (!result.valid()) {
-        sol::error error = result;
-        throw std::runtime_error(error.what());
-      }
-
-      return result;
-    }
-  );
 }
 
-void ScriptResourceManager::SetModPathVariable( sol::state& state, const std::filesystem::path& modDirectory )
+void ScriptResourceManager::SetModPathVariable( sol::environment& environment, const std::filesystem::path& modDirectory )
 {
-  state["_modpath"] = modDirectory.generic_string() + "/";
-  state["_folderpath"] = modDirectory.generic_string() + "/";
+  environment["_modpath"] = modDirectory.generic_string() + "/";
+  environment["_folderpath"] = modDirectory.generic_string() + "/";
 }
 
 // Free Function provided to a number of Lua types that will print an error message when attempting to access a key that does not exist.
@@ -181,6 +244,61 @@ sol::object ScriptResourceManager::PrintInvalidAssignMessage( sol::table table,
   return sol::lua_nil;
 }
 
+sol::protected_function_result ScriptResourceManager::RunFile(sol::state& state, const std::string& path)
+{
+  return RunFile(state, path, nullptr);
+}
+
+sol::protected_function_result ScriptResourceManager::RunFile(sol::state& state, const std::string& path, const sol::environment& env)
+{
+  return RunFile(state, path, &env);
+}
+
+sol::protected_function_result ScriptResourceManager::RunFile(sol::state& state, const std::string& path, const sol::environment* env)
+{
+  std::vector<char> data;
+
+  if (!VirtualFileSystem::Instance().Read(path, data)) {
+    std::ifstream fs(path, std::ios::binary);
+
+    if (!fs.good()) {
+      // lets sol report the missing file the way it always has
+      return env ? state.safe_script_file(path, *env, sol::script_pass_on_error) : state.safe_script_file(path, sol::script_pass_on_error);
+    }
+
+    data.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+  }
+
+  // the chunk name keeps the path so GetCurrentFile() works the same for mounted packages
+  std::string chunkname = "@" + path;
+  std::string_view source(data.data(), data.size());
+  sol::protected_function function;
+
+  {
+    // downloaded packages are mounted from memory at a new random path every time
+    // their bytecode could never be loaded again so it is not written
+    bool cacheable = !VirtualFileSystem::Instance().IsInMemory(path);
+
+    // the chunk leaves the stack at the end of this scope
+    sol::load_result chunk = cacheable ? bytecodeCache.Load(state, source, chunkname) : state.load(source, chunkname);
+
+    if (chunk.valid()) {
+      function = chunk.get<sol::protected_function>();
+    }
+  }
+
+  if (!function.valid()) {
+    // compiling again is cheap next to a broken script and reports the error like before
+    return env ? state.safe_script(source, *env, sol::script_pass_on_error, chunkname) : state.safe_script(source, sol::script_pass_on_error, chunkname);
+  }
+
+  if (env) {
+    env->set_on(function);
+  }
+
+  return function();
+}
+
 stx::result_t<std::string> ScriptResourceManager::GetCurrentFile(lua_State* L)
 {
   lua_Debug ar;
@@ -220,10 +338,9 @@ std::string ScriptResourceManager::GetCurrentLine( lua_State* L )
   return std::string(ar.source) + ":" + std::to_string(ar.currentline);
 }
 
-void ScriptResourceManager::ConfigureEnvironment(ScriptPackage& scriptPackage) {
+void ScriptResourceManager::ConfigureEnvironment(LuaVM& vm) {
 
-  sol::state& state = *scriptPackage.state;
-  const std::string& namespaceId = scriptPackage.address.namespaceId;
+  sol::state& state = vm.state;
   sol::table battle_namespace = state.create_table("Battle");
   sol::table overworld_namespace = state.create_table("Overworld");
   sol::table engine_namespace = state.create_table("Engine");
@@ -233,42 +350,34 @@ void ScriptResourceManager::ConfigureEnvironment(ScriptPackage& scriptPackage) {
     return 0;
   });
 
-  DefineFieldUserType(battle_namespace);
-  DefineTileUserType(state);
-  DefineAnimationUserType(state, engine_namespace);
-  DefineSceneNodeUserType(engine_namespace);
-  DefineSpriteNodeUserType(state, engine_namespace);
-  DefineSyncNodeUserType(engine_namespace);
-  DefineEntityUserType(state, battle_namespace);
-  DefineHitboxUserTypes(state, battle_namespace);
-  DefineBasicCharacterUserType(battle_namespace);
-  DefineScriptedCharacterUserType(this, namespaceId, state, battle_namespace);
-  DefineBasicPlayerUserType(battle_namespace);
-  DefineScriptedPlayerUserType(state, battle_namespace);
-  DefineScriptedSpellUserType(battle_namespace);
-  DefineScriptedObstacleUserType(state, battle_namespace);
-  DefineScriptedArtifactUserType(battle_namespace);
-  DefineScriptedComponentUserType(state, battle_namespace);
-  DefineBaseCardActionUserType(state, battle_namespace);
-  DefineScriptedCardActionUserType(namespaceId, this, battle_namespace);
-  DefineDefenseRuleUserTypes(state, battle_namespace);
-
-  auto SetPackageId = [this, &scriptPackage] (const std::string& packageId) {
+  // enums are cheap and package_init() uses them. The battle usertypes are bound on first use
+  DefineTileEnums(state);
+  DefineAnimationEnums(state);
+  DefineSpriteNodeEnums(state);
+  DefineEntityEnums(state);
+  DefineHitboxEnums(state);
+  DefineScriptedComponentEnums(state);
+  DefineBaseCardActionEnums(state);
+  DefineDefenseRuleEnums(state);
+
+  // meta usertypes of a shared state serve several packages, so their ids are registered once package_init() returns
+  // a private state has one package and checks its id right away
+  auto SetPackageId = [this, &vm] (const std::string& packageId) {
     if (packageId.empty()) {
       throw std::runtime_error("Package id is blank!");
     }
 
+    if (vm.shared || !vm.package) return;
+
+    ScriptPackage& scriptPackage = *vm.package;
+
     if (!scriptPackage.address.packageId.empty()) {
       throw std::runtime_error("Package id has already been set");
     }
 
-    scriptPackage.address.packageId = packageId;
-
-    if (address2package.find(scriptPackage.address) != address2package.end()) {
-      throw std::runtime_error("Package id is already in use");
+    if (stx::result_t<bool> result = RegisterPackage(scriptPackage, packageId); result.is_error()) {
+      throw std::runtime_error(result.error_cstr());
     }
-
-    address2package[scriptPackage.address] = &scriptPackage;
   };
 
   DefineCardMetaUserTypes(this, state, battle_namespace, SetPackageId);
@@ -338,10 +447,12 @@ void ScriptResourceManager::ConfigureEnvironment(ScriptPackage& scriptPackage) {
     "set_color", &BlockMeta::SetColor,
     "set_shape", &BlockMeta::SetShape,
     "as_program", &BlockMeta::AsProgram,
-    "set_mutator", [](BlockMeta& self, sol::object mutatorObject) {
+    "set_mutator", [this, &vm](BlockMeta& self, sol::object mutatorObject) {
       ExpectLuaFunction(mutatorObject);
 
-      self.mutator = [mutatorObject](Player& player) {
+      self.mutator = [this, &vm, mutatorObject](Player& player) {
+        BindBattleTypes(vm);
+
         sol::protected_function mutator = mutatorObject;
         auto result = mutator(WeakWrapper(player.shared_from_base<Player>()));
 
@@ -357,60 +468,19 @@ void ScriptResourceManager::ConfigureEnvironment(ScriptPackage& scriptPackage) {
     }
   );
 
-  const auto& scriptedmob_table = battle_namespace.new_usertype<ScriptedMob>("Mob",
-    sol::meta_function::index, []( sol::table table, const std::string key ) { 
-      ScriptResourceManager::PrintInvalidAccessMessage( table, "Mob", key );
-    },
-    sol::meta_function::new_index, []( sol::table table, const std::string key, sol::object obj ) { 
-      ScriptResourceManager::PrintInvalidAssignMessage( table, "Mob", key );
-    },
-    "create_spawner", [&namespaceId](ScriptedMob& self, const std::string& fqn, Character::Rank rank) {
-      return self.CreateSpawner(namespaceId, fqn, rank);
-    },
-    "set_background", &ScriptedMob::SetBackground,
-    "stream_music", &ScriptedMob::StreamMusic,
-    "get_field", [](ScriptedMob& o) { return WeakWrapper(o.GetField()); },
-    "enable_freedom_mission", &ScriptedMob::EnableFreedomMission,
-    "spawn_player", &ScriptedMob::SpawnPlayer
-  );
-
-  const auto& scriptedspawner_table = battle_namespace.new_usertype<ScriptedMob::ScriptedSpawner>("Spawner",
-    sol::meta_function::index, []( sol::table table, const std::string key ) { 
-      ScriptResourceManager::PrintInvalidAccessMessage( table, "Spawner", key );
-    },
-    sol::meta_function::new_index, []( sol::table table, const std::string key, sol::object obj ) { 
-      ScriptResourceManager::PrintInvalidAssignMessage( table, "Spawner", key );
-    },
-    "spawn_at", &ScriptedMob::ScriptedSpawner::SpawnAt
-  );
-
-  battle_namespace.new_usertype<Mob::Mutator>("SpawnMutator",
-    sol::meta_function::index, []( sol::table table, const std::string key ) { 
-      ScriptResourceManager::PrintInvalidAccessMessage( table, "SpawnMutator", key );
-    },
-    sol::meta_function::new_index, []( sol::table table, const std::string key, sol::object obj ) { 
-      ScriptResourceManager::PrintInvalidAssignMessage( table, "SpawnMutator", key );
-    },
-    "mutate", [](Mob::Mutator& mutator, sol::object callbackObject) {
-      ExpectLuaFunction(callbackObject);
-
-      mutator.Mutate([callbackObject] (std::shared_ptr<Character> character) {
-        sol::protected_function callback = callbackObject;
-
-        auto result = callback(WeakWrapper(character));
-
-        if (!result.valid()) {
-          sol::error error = result;
-          Logger::Log(LogLevel::critical, error.what());
-        }
-      });
+  // scripts hand textures to sprite nodes which keep them alive, so the cache may drop them once the script is done
+  engine_namespace.set_function("load_texture",
+    [](const std::string& path) {
+      static ResourceHandle handle;
+      return handle.Textures().LoadFromFile(path, true);
     }
   );
 
-  engine_namespace.set_function("load_texture",
+  // starts decoding in the background so a later load_texture() does not stall the frame
+  engine_namespace.set_function("preload_texture",
     [](const std::string& path) {
       static ResourceHandle handle;
-      return handle.Textures().LoadFromFile(path);
+      handle.Textures().LoadAsync(path);
     }
   );
 
@@ -428,6 +498,13 @@ void ScriptResourceManager::ConfigureEnvironment(ScriptPackage& scriptPackage) {
     }
   );
 
+  engine_namespace.set_function("preload_audio",
+    [](const std::string& path) {
+      static ResourceHandle handle;
+      handle.Audio().LoadAsync(path);
+    }
+  );
+
   engine_namespace.set_function("play_audio",
     sol::factories(
       [](std::shared_ptr<sf::SoundBuffer> buffer, AudioPriority priority) {
@@ -455,42 +532,6 @@ void ScriptResourceManager::ConfigureEnvironment(ScriptPackage& scriptPackage) {
     }
   );
 
-  engine_namespace.set_function("define_character",
-    [this, &scriptPackage](const std::string& fqn, const std::string& path) {
-      DefineSubpackage(scriptPackage, ScriptPackageType::character, fqn, path);
-    }
-  );
-
-  engine_namespace.set_function("requires_character",
-    [this, &scriptPackage, &namespaceId](const std::string& fqn) {
-      scriptPackage.dependencies.push_back(fqn);
-    }
-  );
-
-  engine_namespace.set_function("define_card",
-    [this, &scriptPackage](const std::string& fqn, const std::string& path) {
-      DefineSubpackage(scriptPackage, ScriptPackageType::card, fqn, path);
-    }
-  );
-
-  engine_namespace.set_function("requires_card",
-    [this, &scriptPackage, &namespaceId](const std::string& fqn) {
-      scriptPackage.dependencies.push_back(fqn);
-    }
-  );
-
-  engine_namespace.set_function("define_library",
-    [this, &scriptPackage]( const std::string& fqn, const std::string& path ) {
-      DefineSubpackage(scriptPackage, ScriptPackageType::library, fqn, path);
-    }
-  );
-
-  engine_namespace.set_function("requires_library",
-    [this, &scriptPackage, &namespaceId](const std::string& fqn) {
-      scriptPackage.dependencies.push_back(fqn);
-    }
-  );
-
   const auto& elements_table = state.new_enum("Element",
     "Fire", Element::fire,
     "Aqua", Element::aqua,
@@ -641,156 +682,602 @@ void ScriptResourceManager::ConfigureEnvironment(ScriptPackage& scriptPackage) {
     "Yellow", PlayerCustScene::Piece::Types::yellow
   );
 
-  const auto& move_event_record = state.new_usertype<MoveEvent>("MoveEvent",
-    sol::factories([] {
-      return MoveEvent{};
-    }),
-    "delta_frames", &MoveEvent::deltaFrames,
-    "delay_frames", &MoveEvent::delayFrames,
-    "endlag_frames",&MoveEvent::endlagFrames,
-    "height", &MoveEvent::height,
-    "dest_tile", &MoveEvent::dest,
-    "on_begin_func", sol::property(
-      [](MoveEvent& event, sol::object onBeginObject) {
-        ExpectLuaFunction(onBeginObject);
-
-        event.onBegin = [onBeginObject] {
-          sol::protected_function onBegin = onBeginObject;
-          auto result = onBegin();
-
-          if (!result.valid()) {
-            sol::error error = result;
-            Logger::Log(LogLevel::critical, error.what());
-          }
-        };
-      }
-    )
-  );
-
-  const auto& explosion_record = battle_namespace.new_usertype<Explosion>("Explosion",
-    sol::factories([](int count, double speed) -> WeakWrapper<Entity> {
-      std::shared_ptr<Entity> artifact = std::make_shared<Explosion>(count, speed);
-      auto wrappedArtifact = WeakWrapper(artifact);
-      wrappedArtifact.Own();
-      return wrappedArtifact;
-    })
-  );
-
-  const auto& particle_poof = battle_namespace.new_usertype<ParticlePoof>("ParticlePoof",
-    sol::factories([]() -> WeakWrapper<Entity> {
-      std::shared_ptr<Entity> artifact = std::make_shared<ParticlePoof>();
-      auto wrappedArtifact = WeakWrapper(artifact);
-      wrappedArtifact.Own();
-      return wrappedArtifact;
-    })
-  );
-
-  const auto& vector_record = state.new_usertype<sf::Vector2f>("Vector2",
-    "x", &sf::Vector2f::x,
-    "y", &sf::Vector2f::y
-  );
-
   state.set_function("frames",
     [](unsigned num) { return frames(num); }
   );
 
   state.set_function( "make_frame_data", &CreateFrameData );
-}
 
-ScriptResourceManager::~ScriptResourceManager()
+  DeferBattleTypes(vm);
+
+  if (vm.shared) {
+    sol::load_result sandbox = state.load(PACKAGE_SANDBOX, "=sandbox");
+    sol::protected_function makeSandbox = sandbox;
+    vm.makeEnvironment = makeSandbox(state.globals()).get<sol::protected_function>();
+  }
+}
+
+void ScriptResourceManager::ConfigurePackage(ScriptPackage& scriptPackage, const std::filesystem::path& modDirectory) {
+  sol::state& state = *scriptPackage.state;
+  const std::string& namespaceId = scriptPackage.address.namespaceId;
+
+  if (scriptPackage.vm->shared) {
+    scriptPackage.environment = scriptPackage.vm->makeEnvironment().get<sol::environment>();
+  }
+  else {
+    scriptPackage.environment = sol::environment(state.globals());
+  }
+
+  sol::environment& environment = scriptPackage.environment;
+  SetModPathVariable(environment, modDirectory);
+
+  // 'include()' in Lua is intended to load a LIBRARY file of Lua code into the current lua state.
+  // Currently only loads library files included in the SAME directory as the script file.
+  // Has to capture a pointer to sol::state, the copy constructor was deleted, cannot capture a copy to reference.
+  environment.set_function("include",
+    [this, &state, &namespaceId, &scriptPackage](const std::string& fileName) -> sol::object {
+      std::string scriptPath;
+
+      // Prefer using the shared libraries if possible.
+      // i.e. ones that were present in "mods/libs/"
+      // make sure it was required by checking dependencies as well
+      if(std::find(scriptPackage.dependencies.begin(), scriptPackage.dependencies.end(), scriptPath) != scriptPackage.dependencies.end())
+      {
+        Logger::Logf(LogLevel::debug, "Including shared library: %s", fileName.c_str());
+
+        auto* libraryPackage = FetchScriptPackage(namespaceId, fileName, ScriptPackageType::library);
+
+        if (!libraryPackage) {
+          throw std::runtime_error("Library package \"" + fileName + "\" is either not installed or has not had time to initialize");
+        }
+
+        scriptPath = libraryPackage->path;
+      }
+      else
+      {
+        Logger::Logf(LogLevel::debug, "Including local library: %s", fileName.c_str());
+
+        auto parentFolder = GetCurrentFolder(state).unwrap();
+        scriptPath = parentFolder + "/" + fileName;
+      }
+
+      sol::environment env(state, sol::create, scriptPackage.environment);
+      env["_folderpath"] = std::filesystem::path(scriptPath).parent_path().string() + "/";
+
+      sol::protected_function_result result = RunFile(state, scriptPath, env);
+
+      if (!result.valid()) {
+        sol::error error = result;
+        throw std::runtime_error(error.what());
+      }
+
+      return result;
+    }
+  );
+
+  // in a shared state this is the package's own overlay of Engine
+  sol::table engine_namespace = environment["Engine"];
+
+  engine_namespace.set_function("define_character",
+    [this, &scriptPackage](const std::string& fqn, const std::string& path) {
+      DefineSubpackage(scriptPackage, ScriptPackageType::character, fqn, path);
+    }
+  );
+
+  engine_namespace.set_function("requires_character",
+    [this, &scriptPackage, &namespaceId](const std::string& fqn) {
+      scriptPackage.dependencies.push_back(fqn);
+    }
+  );
+
+  engine_namespace.set_function("define_card",
+    [this, &scriptPackage](const std::string& fqn, const std::string& path) {
+      DefineSubpackage(scriptPackage, ScriptPackageType::card, fqn, path);
+    }
+  );
+
+  engine_namespace.set_function("requires_card",
+    [this, &scriptPackage, &namespaceId](const std::string& fqn) {
+      scriptPackage.dependencies.push_back(fqn);
+    }
+  );
+
+  engine_namespace.set_function("define_library",
+    [this, &scriptPackage]( const std::string& fqn, const std::string& path ) {
+      DefineSubpackage(scriptPackage, ScriptPackageType::library, fqn, path);
+    }
+  );
+
+  engine_namespace.set_function("requires_library",
+    [this, &scriptPackage, &namespaceId](const std::string& fqn) {
+      scriptPackage.dependencies.push_back(fqn);
+    }
+  );
+}
+
+void ScriptResourceManager::DefineBattleTypes(LuaVM& vm) {
+  sol::state& state = vm.state;
+  const std::string& namespaceId = vm.namespaceId;
+  sol::table battle_namespace = state.globals().raw_get<sol::table>("Battle");
+  sol::table engine_namespace = state.globals().raw_get<sol::table>("Engine");
+
+  DefineFieldUserType(battle_namespace);
+  DefineTileUserType(state);
+  DefineAnimationUserType(state, engine_namespace);
+  DefineSceneNodeUserType(engine_namespace);
+  DefineSpriteNodeUserType(state, engine_namespace);
+  DefineSyncNodeUserType(engine_namespace);
+  DefineParticleEmitterUserType(engine_namespace);
+  DefineEntityUserType(state, battle_namespace);
+  DefineHitboxUserTypes(state, battle_namespace);
+  DefineBasicCharacterUserType(battle_namespace);
+  DefineScriptedCharacterUserType(this, namespaceId, state, battle_namespace);
+  DefineBasicPlayerUserType(battle_namespace);
+  DefineScriptedPlayerUserType(state, battle_namespace);
+  DefineScriptedSpellUserType(battle_namespace);
+  DefineScriptedObstacleUserType(state, battle_namespace);
+  DefineScriptedArtifactUserType(battle_namespace);
+  DefineScriptedComponentUserType(state, battle_namespace);
+  DefineBaseCardActionUserType(state, battle_namespace);
+  DefineScriptedCardActionUserType(namespaceId, this, battle_namespace);
+  DefineDefenseRuleUserTypes(state, battle_namespace);
+
+  const auto& scriptedmob_table = battle_namespace.new_usertype<ScriptedMob>("Mob",
+    sol::meta_function::index, []( sol::table table, const std::string key ) { 
+      ScriptResourceManager::PrintInvalidAccessMessage( table, "Mob", key );
+    },
+    sol::meta_function::new_index, []( sol::table table, const std::string key, sol::object obj ) { 
+      ScriptResourceManager::PrintInvalidAssignMessage( table, "Mob", key );
+    },
+    "create_spawner", [&namespaceId](ScriptedMob& self, const std::string& fqn, Character::Rank rank) {
+      return self.CreateSpawner(namespaceId, fqn, rank);
+    },
+    "set_background", &ScriptedMob::SetBackground,
+    "stream_music", &ScriptedMob::StreamMusic,
+    "get_field", [](ScriptedMob& o) { return WeakWrapper(o.GetField()); },
+    "enable_freedom_mission", &ScriptedMob::EnableFreedomMission,
+    "spawn_player", &ScriptedMob::SpawnPlayer
+  );
+
+  const auto& scriptedspawner_table = battle_namespace.new_usertype<ScriptedMob::ScriptedSpawner>("Spawner",
+    sol::meta_function::index, []( sol::table table, const std::string key ) { 
+      ScriptResourceManager::PrintInvalidAccessMessage( table, "Spawner", key );
+    },
+    sol::meta_function::new_index, []( sol::table table, const std::string key, sol::object obj ) { 
+      ScriptResourceManager::PrintInvalidAssignMessage( table, "Spawner", key );
+    },
+    "spawn_at", &ScriptedMob::ScriptedSpawner::SpawnAt
+  );
+
+  battle_namespace.new_usertype<Mob::Mutator>("SpawnMutator",
+    sol::meta_function::index, []( sol::table table, const std::string key ) { 
+      ScriptResourceManager::PrintInvalidAccessMessage( table, "SpawnMutator", key );
+    },
+    sol::meta_function::new_index, []( sol::table table, const std::string key, sol::object obj ) { 
+      ScriptResourceManager::PrintInvalidAssignMessage( table, "SpawnMutator", key );
+    },
+    "mutate", [](Mob::Mutator& mutator, sol::object callbackObject) {
+      ExpectLuaFunction(callbackObject);
+
+      mutator.Mutate([callbackObject] (std::shared_ptr<Character> character) {
+        sol::protected_function callback = callbackObject;
+
+        auto result = callback(WeakWrapper(character));
+
+        if (!result.valid()) {
+          sol::error error = result;
+          Logger::Log(LogLevel::critical, error.what());
+        }
+      });
+    }
+  );
+
+  const auto& move_event_record = state.new_usertype<MoveEvent>("MoveEvent",
+    sol::factories([] {
+      return MoveEvent{};
+    }),
+    "delta_frames", &MoveEvent::deltaFrames,
+    "delay_frames", &MoveEvent::delayFrames,
+    "endlag_frames",&MoveEvent::endlagFrames,
+    "height", &MoveEvent::height,
+    "dest_tile", &MoveEvent::dest,
+    "on_begin_func", sol::property(
+      [](MoveEvent& event, sol::object onBeginObject) {
+        ExpectLuaFunction(onBeginObject);
+
+        event.onBegin = [onBeginObject] {
+          sol::protected_function onBegin = onBeginObject;
+          auto result = onBegin();
+
+          if (!result.valid()) {
+            sol::error error = result;
+            Logger::Log(LogLevel::critical, error.what());
+          }
+        };
+      }
+    )
+  );
+
+  const auto& explosion_record = battle_namespace.new_usertype<Explosion>("Explosion",
+    sol::factories([](int count, double speed) -> WeakWrapper<Entity> {
+      std::shared_ptr<Entity> artifact = std::make_shared<Explosion>(count, speed);
+      auto wrappedArtifact = WeakWrapper(artifact);
+      wrappedArtifact.Own();
+      return wrappedArtifact;
+    })
+  );
+
+  const auto& particle_poof = battle_namespace.new_usertype<ParticlePoof>("ParticlePoof",
+    sol::factories([]() -> WeakWrapper<Entity> {
+      std::shared_ptr<Entity> artifact = std::make_shared<ParticlePoof>();
+      auto wrappedArtifact = WeakWrapper(artifact);
+      wrappedArtifact.Own();
+      return wrappedArtifact;
+    })
+  );
+
+  const auto& vector_record = state.new_usertype<sf::Vector2f>("Vector2",
+    "x", &sf::Vector2f::x,
+    "y", &sf::Vector2f::y
+  );
+}
+
+void ScriptResourceManager::DeferBattleTypes(LuaVM& vm) {
+  sol::state& state = vm.state;
+  const BattleTypeNames& names = GetBattleTypeNames();
+
+  // only names the battle types would define trigger the binding, other missing names stay nil
+  auto defer = [this, &state, &vm](sol::table table, const std::set<std::string>& keys) {
+    sol::table metatable = state.create_table();
+
+    metatable[sol::meta_function::index] = [this, &vm, &keys](sol::table self, sol::object key) -> sol::object {
+      if (key.get_type() != sol::type::string || keys.count(key.as<std::string>()) == 0) {
+        return sol::lua_nil;
+      }
+
+      BindBattleTypes(vm);
+      return self.raw_get<sol::object>(key);
+    };
+
+    table[sol::metatable_key] = metatable;
+    vm.deferredBattleTypes.emplace_back(table, metatable);
+  };
+
+  sol::table globals = state.globals();
+  defer(globals, names.globals);
+  defer(globals.raw_get<sol::table>("Battle"), names.battle);
+  defer(globals.raw_get<sol::table>("Engine"), names.engine);
+}
+
+void ScriptResourceManager::BindBattleTypes(ScriptPackage& package) {
+  std::scoped_lock lock(package.vm->mutex);
+  BindBattleTypes(*package.vm);
+}
+
+void ScriptResourceManager::BindBattleTypes(LuaVM& vm) {
+  if (vm.battleTypesBound) return;
+
+  // set first, defining the types reads the tables that trigger this
+  vm.battleTypesBound = true;
+
+  sol::state& state = vm.state;
+  size_t heapBefore = state.memory_used();
+  auto begin = std::chrono::steady_clock::now();
+
+  try {
+    DefineBattleTypes(vm);
+  }
+  catch (...) {
+    // keep the lookups deferred so the next access tries again
+    vm.battleTypesBound = false;
+    throw;
+  }
+
+  // every name is defined now, so lookups no longer need to come through here
+  for (auto& [table, metatable] : vm.deferredBattleTypes) {
+    sol::object current = table[sol::metatable_key];
+
+    // leave metatables that scripts have set since alone
+    if (current.pointer() == metatable.pointer()) {
+      table[sol::metatable_key] = sol::lua_nil;
+    }
+  }
+
+  vm.deferredBattleTypes.clear();
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+  Logger::Logf(LogLevel::debug, "Bound battle types for %s in %.2f ms, Lua heap %u KiB -> %u KiB",
+    vm.name.c_str(), elapsed.count(), (unsigned)(heapBefore / 1024), (unsigned)(state.memory_used() / 1024));
+}
+
+const ScriptResourceManager::BattleTypeNames& ScriptResourceManager::GetBattleTypeNames() {
+  std::call_once(battleTypeNamesFlag, [this] {
+    LuaVM scratchVM("", "scratch state", false);
+    sol::state& scratch = scratchVM.state;
+
+    sol::table battle_namespace = scratch.create_named_table("Battle");
+    sol::table engine_namespace = scratch.create_named_table("Engine");
+
+    auto keysOf = [](sol::table table) {
+      std::set<std::string> keys;
+
+      table.for_each([&keys](sol::object key, sol::object value) {
+        if (key.get_type() == sol::type::string) {
+          keys.insert(key.as<std::string>());
+        }
+      });
+
+      return keys;
+    };
+
+    std::set<std::string> globalsBefore = keysOf(scratch.globals());
+
+    DefineBattleTypes(scratchVM);
+
+    for (const std::string& key : keysOf(scratch.globals())) {
+      // sol keeps its own bookkeeping tables in the globals, scripts never name them
+      if (globalsBefore.count(key) == 0 && key.rfind("sol.", 0) != 0) {
+        battleTypeNames.globals.insert(key);
+      }
+    }
+
+    battleTypeNames.battle = keysOf(battle_namespace);
+    battleTypeNames.engine = keysOf(engine_namespace);
+  });
+
+  return battleTypeNames;
+}
+
+LuaVM::LuaVM(const std::string& namespaceId, const std::string& name, bool shared) :
+  namespaceId(namespaceId),
+  name(name),
+  shared(shared)
+{
+}
+
+const size_t ScriptResourceManager::GetLuaMemoryUsed()
+{
+  std::scoped_lock lock(packageMutex);
+
+  size_t total = 0;
+
+  for (LuaVM* vm : vms) {
+    total += vm->state.memory_used();
+  }
+
+  return total;
+}
+
+const size_t ScriptResourceManager::GetLuaStateCount()
+{
+  std::scoped_lock lock(packageMutex);
+  return vms.size();
+}
+
+void ScriptResourceManager::SetSharedStateCount(size_t count)
 {
-  for (auto [state, scriptPackage] : state2package) {
-    delete state;
-    delete scriptPackage;
+  std::scoped_lock lock(packageMutex);
+  sharedStateCount = count;
+}
+
+ScriptResourceManager::~ScriptResourceManager()
+{
+  // environments are references into their state
+  for (ScriptPackage* package : packages) {
+    delete package;
+  }
+
+  for (LuaVM* vm : vms) {
+    delete vm;
   }
 }
 
-stx::result_t<sol::state*> ScriptResourceManager::LoadScript(const std::string& namespaceId, const std::filesystem::path& modDirectory, ScriptPackageType type)
+LuaVM* ScriptResourceManager::AcquireVM(const std::string& namespaceId, const std::string& path, LuaVM* parent)
+{
+  std::scoped_lock lock(packageMutex);
+
+  LuaVM* vm{ nullptr };
+
+  if (sharedStateCount == 0) {
+    vm = new LuaVM(namespaceId, path, false);
+  }
+  else if (parent && parent->shared) {
+    // the parent's state is locked while it defines this package, another state could deadlock against it
+    vm = parent;
+  }
+  else {
+    size_t count = 0;
+
+    for (LuaVM* candidate : vms) {
+      if (!candidate->shared || candidate->namespaceId != namespaceId) continue;
+
+      count++;
+
+      if (!vm || candidate->packages < vm->packages) {
+        vm = candidate;
+      }
+    }
+
+    if (count < sharedStateCount) {
+      vm = new LuaVM(namespaceId, "shared state " + std::to_string(count + 1) + " of " + namespaceId, true);
+    }
+  }
+
+  vm->packages++;
+  vms.insert(vm);
+  return vm;
+}
+
+void ScriptResourceManager::ReleasePackage(ScriptPackage* package)
+{
+  LuaVM* vm = package->vm;
+
+  {
+    std::scoped_lock lock(vm->mutex);
+
+    if (vm->package == package) {
+      vm->package = nullptr;
+    }
+
+    delete package;
+  }
+
+  {
+    std::scoped_lock lock(packageMutex);
+
+    if (--vm->packages > 0) {
+      return;
+    }
+
+    vms.erase(vm);
+  }
+
+  delete vm;
+}
+
+stx::result_t<ScriptPackage*> ScriptResourceManager::LoadScript(const std::string& namespaceId, const std::filesystem::path& modDirectory, ScriptPackageType type)
+{
+  return LoadScript(namespaceId, modDirectory, type, nullptr);
+}
+
+stx::result_t<ScriptPackage*> ScriptResourceManager::LoadScript(const std::string& namespaceId, const std::filesystem::path& modDirectory, ScriptPackageType type, LuaVM* parent)
 {
   auto entryPath = modDirectory / "entry.lua";
 
-  sol::state* lua = new sol::state;
+  LuaVM* vm = AcquireVM(namespaceId, modDirectory.generic_string(), parent);
+  ScriptPackage* package = new ScriptPackage();
 
-  // We must store package information for the proceeding configurations to work correctly
-  auto [it, _] = state2package.emplace(lua, new ScriptPackage());
-  ScriptPackage& scriptPackage = *it->second;
-  scriptPackage.state = lua;
+  ScriptPackage& scriptPackage = *package;
+  scriptPackage.vm = vm;
+  scriptPackage.state = &vm->state;
   scriptPackage.type = type;
   scriptPackage.address.namespaceId = namespaceId;
   scriptPackage.path = modDirectory.generic_string();
 
-  // Configure the scripts to run safely
-  SetModPathVariable(*lua, modDirectory);
-  SetSystemFunctions(scriptPackage);
-  ConfigureEnvironment(scriptPackage);
+  // We must store package information for the proceeding configurations to work correctly
+  {
+    std::scoped_lock lock(packageMutex);
+    packages.insert(package);
+
+    if (!vm->shared) {
+      vm->package = package;
+    }
+  }
+
+  std::string msg;
+
+  {
+    std::scoped_lock lock(vm->mutex);
+    sol::state& lua = vm->state;
+
+    // Configure the scripts to run safely
+    if (!vm->configured) {
+      vm->configured = true;
+      SetSystemFunctions(*vm);
+      ConfigureEnvironment(*vm);
+      lua.set_exception_handler(&::exception_handler);
+    }
+
+    ConfigurePackage(scriptPackage, modDirectory);
 
-  lua->set_exception_handler(&::exception_handler);
-  auto loadResult = lua->safe_script_file(entryPath.generic_string(), sol::script_pass_on_error);
+    size_t heapBefore = lua.memory_used();
+    auto begin = std::chrono::steady_clock::now();
+    auto loadResult = RunFile(lua, entryPath.generic_string(), scriptPackage.environment);
+
+    if (loadResult.valid()) {
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+      Logger::Logf(LogLevel::debug, "Loaded %s in %.2f ms, Lua heap +%d KiB in %s",
+        scriptPackage.path.c_str(), elapsed.count(), (int)(((long long)lua.memory_used() - (long long)heapBefore) / 1024), vm->name.c_str());
+
+      return stx::ok<ScriptPackage*>(package);
+    }
 
-  if (!loadResult.valid()) {
     sol::error loadError = loadResult;
-    std::string msg = "Failed to load package " + scriptPackage.address.packageId + ". Reason: " + loadError.what();
-    DropPackageData(lua);
-    loadResult.abandon();
-    return stx::error<sol::state*>(msg);
+    msg = "Failed to load package " + scriptPackage.address.packageId + ". Reason: " + loadError.what();
   }
 
-  return stx::ok<sol::state*>(lua);
+  DropPackageData(package);
+  return stx::error<ScriptPackage*>(msg);
 }
 
-void ScriptResourceManager::DropPackageData(sol::state* state)
+void ScriptResourceManager::DropPackageData(ScriptPackage* package)
 {
-  auto stateIt = state2package.find(state);
+  {
+    std::scoped_lock lock(packageMutex);
 
-  if (stateIt == state2package.end()) {
-    return;
-  }
+    if (packages.erase(package) == 0) {
+      return;
+    }
+
+    // drop package
+    auto addressIt = address2package.find(package->address);
 
-  auto* package = stateIt->second;
-  state2package.erase(stateIt);
+    if (addressIt != address2package.end() && addressIt->second == package) {
+      Logger::Logf(LogLevel::debug, "Dropping package in partition %s with ID %s", package->address.namespaceId.c_str(), package->address.packageId.c_str());
+      address2package.erase(addressIt);
+    } else {
+      Logger::Logf(LogLevel::debug, "Dropping unknown package in partition %s", package->address.namespaceId.c_str());
+    }
+  }
 
   // drop subpackages
   for (auto& packageId : package->subpackages) {
     DropPackageData({ package->address.namespaceId, packageId });
   }
 
-  // drop package
-  auto addressIt = address2package.find(package->address);
-
-  if (addressIt != address2package.end()) {
-    Logger::Logf(LogLevel::debug, "Dropping package in partition %s with ID %s", package->address.namespaceId.c_str(), package->address.packageId.c_str());
-    address2package.erase(addressIt);
-  } else {
-    Logger::Logf(LogLevel::debug, "Dropping unknown package in partition %s", package->address.namespaceId.c_str());
-  }
-
-  delete state;
-  delete package;
+  ReleasePackage(package);
 }
 
 void ScriptResourceManager::DropPackageData(const PackageAddress& addr)
 {
   Logger::Logf(LogLevel::debug, "Dropping package in partition %s with ID %s", addr.namespaceId.c_str(), addr.packageId.c_str());
-  auto it = address2package.find(addr);
 
-  if (it == address2package.end()) {
-    Logger::Logf(LogLevel::debug, "Cannot drop package in partition %s with ID %s", addr.namespaceId.c_str(), addr.packageId.c_str());
-    return;
-  }
+  ScriptPackage* package{ nullptr };
 
-  auto* package = it->second;
-  address2package.erase(it);
+  {
+    std::scoped_lock lock(packageMutex);
+    auto it = address2package.find(addr);
+
+    if (it == address2package.end()) {
+      Logger::Logf(LogLevel::debug, "Cannot drop package in partition %s with ID %s", addr.namespaceId.c_str(), addr.packageId.c_str());
+      return;
+    }
+
+    package = it->second;
+    address2package.erase(it);
+    packages.erase(package);
+  }
 
   // drop subpackages
   for (auto& packageId : package->subpackages) {
     DropPackageData({ package->address.namespaceId, packageId });
   }
 
-  state2package.erase(package->state);
-
   // drop package
-  delete package->state;
-  delete package;
+  ReleasePackage(package);
+}
+
+stx::result_t<bool> ScriptResourceManager::RegisterPackage(ScriptPackage& package, const std::string& packageId)
+{
+  // a blank id is reported when the package is committed
+  if (packageId.empty()) {
+    return stx::ok();
+  }
+
+  std::scoped_lock lock(packageMutex);
+
+  PackageAddress addr = { package.address.namespaceId, packageId };
+  auto iter = address2package.find(addr);
+
+  if (iter != address2package.end() && iter->second != &package) {
+    return stx::error<bool>("Package id is already in use");
+  }
+
+  package.address = addr;
+  address2package[addr] = &package;
+  return stx::ok();
 }
 
 static std::string PackageTypeToString(ScriptPackageType type) {
@@ -806,16 +1293,19 @@ static std::string PackageTypeToString(ScriptPackageType type) {
   }
 }
 
-ScriptPackage* ScriptResourceManager::DefinePackage(ScriptPackageType type, const std::string& namespaceId, const std::string& fqn, const std::string& path)
+ScriptPackage* ScriptResourceManager::DefinePackage(ScriptPackageType type, const std::string& namespaceId, const std::string& fqn, const std::string& path, LuaVM* parent)
 {
   PackageAddress addr = { namespaceId, fqn };
-  auto iter = address2package.find(addr);
 
-  if (iter != address2package.end()) {
-    throw std::runtime_error("A package in partition " + addr.namespaceId + " with id " + fqn + " has already been registered");
+  {
+    std::scoped_lock lock(packageMutex);
+
+    if (address2package.find(addr) != address2package.end()) {
+      throw std::runtime_error("A package in partition " + addr.namespaceId + " with id " + fqn + " has already been registered");
+    }
   }
 
-  auto res = LoadScript(addr.namespaceId, path, type);
+  auto res = LoadScript(addr.namespaceId, path, type, parent);
 
   if (res.is_error()) {
     Logger::Logf(LogLevel::critical, "Failed to define %s with FQN %s. Reason: %s", PackageTypeToString(type).c_str(), fqn.c_str(), res.error_cstr());
@@ -824,21 +1314,34 @@ ScriptPackage* ScriptResourceManager::DefinePackage(ScriptPackageType type, cons
     throw std::runtime_error(res.error_cstr());
   }
 
-  auto& scriptPackage = state2package[res.value()];
-  scriptPackage->address = addr;
-  address2package[addr] = scriptPackage;
-  return scriptPackage;
+  ScriptPackage* scriptPackage = res.value();
+
+  {
+    std::scoped_lock lock(packageMutex);
+
+    // another package may have defined the same id while this script was loading
+    if (address2package.find(addr) == address2package.end()) {
+      scriptPackage->address = addr;
+      address2package[addr] = scriptPackage;
+      return scriptPackage;
+    }
+  }
+
+  DropPackageData(scriptPackage);
+  throw std::runtime_error("A package in partition " + addr.namespaceId + " with id " + fqn + " has already been registered");
 }
 
 void ScriptResourceManager::DefineSubpackage(ScriptPackage& parentPackage, ScriptPackageType type, const std::string& fqn, const std::string& path)
 {
-  ScriptPackage* scriptPackage = DefinePackage(type, parentPackage.address.namespaceId, fqn, path);
+  ScriptPackage* scriptPackage = DefinePackage(type, parentPackage.address.namespaceId, fqn, path, parentPackage.vm);
   parentPackage.subpackages.push_back(scriptPackage->address.packageId);
 }
 
 ScriptPackage* ScriptResourceManager::FetchScriptPackage(const std::string& namespaceId, const std::string& fqn, ScriptPackageType type)
 {
   PackageAddress addr = { namespaceId, fqn };
+
+  std::scoped_lock lock(packageMutex);
   auto iter = address2package.find(addr);
 
   if (iter == address2package.end()) {
@@ -864,4 +1367,9 @@ CardPackagePartitioner& ScriptResourceManager::GetCardPackagePartitioner()
   return *cardPartition;
 }
 
+LuaBytecodeCache& ScriptResourceManager::GetBytecodeCache()
+{
+  return bytecodeCache;
+}
+
 #endif
\ No newline at end of file
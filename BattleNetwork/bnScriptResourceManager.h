@@ -6,11 +6,13 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <map>
+#include <set>
 #include <vector>
 #include <iostream>
 #include <atomic>
 #include <filesystem>
 #include <list>
+#include <mutex>
 #include "stx/result.h"
 
 #ifdef __unix__
@@ -19,6 +21,7 @@
 
 #include <sol/sol.hpp>
 #include "bnPackageAddress.h"
+#include "bnLuaBytecodeCache.h"
 
 class CardPackagePartitioner;
 
@@ -30,8 +33,36 @@ enum class ScriptPackageType : uint8_t {
   any
 };
 
+struct ScriptPackage;
+
+/**
+ * @brief A Lua state and what the packages running in it have in common
+ *
+ * By default every package runs in a state of its own. With shared states, packages of the
+ * same namespace are spread over a few states. Each package then gets its own globals table,
+ * and reads the libraries and usertypes of the state through it without being able to change
+ * them for the other packages. Usertypes are defined and garbage is collected once per state.
+ */
+struct LuaVM {
+  std::string namespaceId; /*!< Bindings keep a reference to this so it must outlive the state */
+  std::string name; /*!< Names the state in logs */
+  sol::state state;
+  sol::protected_function makeEnvironment; /*!< Creates the globals of one package. Only set in shared states */
+  std::recursive_mutex mutex; /*!< Held while C++ runs scripts in this state. Packages install on several threads at boot */
+  size_t packages{}; /*!< The state closes with its last package. Guarded by the package mutex */
+  ScriptPackage* package{ nullptr }; /*!< The only package of a private state */
+  bool shared{ false };
+  bool configured{ false };
+  bool battleTypesBound{ false }; /*!< Battle usertypes are only defined once a package needs them */
+  std::vector<std::pair<sol::table, sol::table>> deferredBattleTypes; /*!< Tables and the metatables DeferBattleTypes gave them */
+
+  LuaVM(const std::string& namespaceId, const std::string& name, bool shared);
+};
+
 struct ScriptPackage {
+  LuaVM* vm{ nullptr };
   sol::state* state{ nullptr };
+  sol::environment environment; /*!< Globals of this package. The state's own globals unless the state is shared */
   ScriptPackageType type;
   PackageAddress address;
   std::string path;
@@ -43,29 +74,93 @@ class ScriptResourceManager {
 public:
   ~ScriptResourceManager();
 
-  stx::result_t<sol::state*> LoadScript(const std::string& namespaceId, const std::filesystem::path& path, ScriptPackageType type = ScriptPackageType::other);
+  stx::result_t<ScriptPackage*> LoadScript(const std::string& namespaceId, const std::filesystem::path& path, ScriptPackageType type = ScriptPackageType::other);
 
-  void DropPackageData(sol::state* state);
+  void DropPackageData(ScriptPackage* package);
   void DropPackageData(const PackageAddress& addr);
-  ScriptPackage* DefinePackage(ScriptPackageType type, const std::string& namespaceId, const std::string& fqn, const std::string& path); /* throws */
+
+  /**
+   * @brief Makes a loaded package reachable by the id it declared in package_init()
+   *
+   * Packages in private states are registered as soon as they declare their id.
+   * Calling this again with the same id does nothing.
+   */
+  stx::result_t<bool> RegisterPackage(ScriptPackage& package, const std::string& packageId);
+
+  ScriptPackage* DefinePackage(ScriptPackageType type, const std::string& namespaceId, const std::string& fqn, const std::string& path, LuaVM* parent = nullptr); /* throws */
   ScriptPackage* FetchScriptPackage(const std::string& namespaceId, const std::string& fqn, ScriptPackageType type);
   void SetCardPackagePartitioner(CardPackagePartitioner& partition);
   CardPackagePartitioner& GetCardPackagePartitioner();
+  LuaBytecodeCache& GetBytecodeCache();
+
+  /**
+   * @brief Packages loaded from now on share this many Lua states per namespace. 0 gives each package its own state
+   */
+  void SetSharedStateCount(size_t count);
+
+  /**
+   * @brief Defines the battle usertypes in a package's state if they are not defined yet
+   *
+   * Call before handing battle objects to a package. Scripts that name a battle type
+   * bind them on their own.
+   */
+  void BindBattleTypes(ScriptPackage& package);
+
+  /**
+   * @brief Lua heap used by every loaded package
+   */
+  const size_t GetLuaMemoryUsed();
+  const size_t GetLuaStateCount();
 
   static sol::object PrintInvalidAccessMessage(sol::table table, const std::string typeName, const std::string key );
   static sol::object PrintInvalidAssignMessage(sol::table table, const std::string typeName, const std::string key );
 
 private:
-  std::map<sol::state*, ScriptPackage*> state2package; /*!< lua state pointer to script package */
+  /**
+   * @brief Names the battle usertypes add to the globals and to the Battle and Engine tables
+   */
+  struct BattleTypeNames {
+    std::set<std::string> globals, battle, engine;
+  };
+
+  std::set<ScriptPackage*> packages; /*!< Every loaded package */
+  std::set<LuaVM*> vms; /*!< Every open Lua state */
   std::map<PackageAddress, ScriptPackage*> address2package; /*!< PackageAddress to script package */
+  std::recursive_mutex packageMutex; /*!< Guards the sets and map above. Packages load on several threads at boot. Never held while a script runs */
+  size_t sharedStateCount{ 0 };
   CardPackagePartitioner* cardPartition{ nullptr };
+  LuaBytecodeCache bytecodeCache{ LuaBytecodeCache::DEFAULT_FOLDER };
+  std::once_flag battleTypeNamesFlag;
+  BattleTypeNames battleTypeNames; /*!< Found once by defining the battle types in a scratch state */
+
+  stx::result_t<ScriptPackage*> LoadScript(const std::string& namespaceId, const std::filesystem::path& path, ScriptPackageType type, LuaVM* parent);
 
-  void ConfigureEnvironment(ScriptPackage& scriptPackage);
+  /**
+   * @brief Picks the state a new package runs in
+   * @param parent state of the package defining this one. Shared states keep subpackages with their parent
+   */
+  LuaVM* AcquireVM(const std::string& namespaceId, const std::string& path, LuaVM* parent);
+  void ReleasePackage(ScriptPackage* package);
+
+  void ConfigureEnvironment(LuaVM& vm);
+  void ConfigurePackage(ScriptPackage& scriptPackage, const std::filesystem::path& modDirectory);
+  void DefineBattleTypes(LuaVM& vm);
+  void DeferBattleTypes(LuaVM& vm);
+  void BindBattleTypes(LuaVM& vm);
+  const BattleTypeNames& GetBattleTypeNames();
   void DefineSubpackage(ScriptPackage& parentPackage, ScriptPackageType type, const std::string& fqn, const std::string& path); /* throws */
-  void SetSystemFunctions(ScriptPackage& scriptPackage);
-  void SetModPathVariable(sol::state& state, const std::filesystem::path& modDirectory);
+  void SetSystemFunctions(LuaVM& vm);
+  void SetModPathVariable(sol::environment& environment, const std::filesystem::path& modDirectory);
 
   static std::string GetCurrentLine( lua_State* L );
+
+  /**
+   * @brief Runs a script file from a mounted package or from disk, compiled through the bytecode cache
+   */
+  sol::protected_function_result RunFile(sol::state& state, const std::string& path);
+  sol::protected_function_result RunFile(sol::state& state, const std::string& path, const sol::environment& env);
+  sol::protected_function_result RunFile(sol::state& state, const std::string& path, const sol::environment* env);
+
   static stx::result_t<std::string> GetCurrentFile(lua_State* L);
   static stx::result_t<std::string> GetCurrentFolder(lua_State* L);
 };
@@ -7,6 +7,7 @@
 #include "Android/bnTouchArea.h"
 #include "../../bnBlockPackageManager.h"
 #include "../../bnPlayerCustScene.h"
+#include "bnBattlePreloader.h"
 constexpr float PIXEL_MAX = 50.0f;
 constexpr float PIXEL_SPEED = 180.0f;
 
@@ -388,6 +389,14 @@ void SelectMobScene::onUpdate(double elapsed) {
       auto newFolder = selectedFolder->Clone();
       newFolder->Shuffle();
 
+      // Decode the battle assets while the transition and intro play
+      BattlePreloader preloader;
+      preloader.AddPackage(meta.GetFilePath());
+      preloader.AddPackage(packageManager.FindPackageByID(mobSelectionId).GetFilePath());
+      preloader.AddFolder(*newFolder, getController().CardPackagePartitioner());
+      preloader.AddBlocks(localNaviBlocksAddr, getController().BlockPackagePartitioner());
+      preloader.Start();
+
       if (!mob->GetBackground()) {
         mob->SetBackground(defaultBackground);
       }
@@ -1,11 +1,38 @@
 #include "bnShaderResourceManager.h"
 #include "bnShaderType.h"
+#include "bnVirtualFileSystem.h"
 #include <stdlib.h>
 #include <sstream>
 #include <fstream>
+#include <vector>
 using std::ifstream;
 using std::stringstream;
 
+namespace {
+  /**
+   * @brief Reads shader source from a mounted package or from disk
+   */
+  bool ReadShaderSource(const std::string& path, std::string& source) {
+    std::vector<char> data;
+
+    if (VirtualFileSystem::Instance().Read(path, data)) {
+      source.assign(data.begin(), data.end());
+      return true;
+    }
+
+    ifstream fin(path, std::ios::binary);
+
+    if (!fin.is_open()) {
+      return false;
+    }
+
+    stringstream buffer;
+    buffer << fin.rdbuf();
+    source = buffer.str();
+    return true;
+  }
+}
+
 void ShaderResourceManager::LoadAllShaders(std::atomic<int> &status) {
   ShaderType shaderType = static_cast<ShaderType>(0);
   while (shaderType != ShaderType::SHADER_TYPE_SIZE)
@@ -32,15 +59,18 @@ sf::Shader* ShaderResourceManager::LoadShaderFromFile(string _path)
 
 #ifdef __ANDROID__
   sf::Shader* shader = new sf::Shader();
+  std::string vertex, fragment;
   bool result = false;
 
-  if (shader->loadFromFile(_path + ".vert", _path + ".frag"))
-  {
-    result = true;
-  }
-  else // default vert shader
-  {
-    result = shader->loadFromFile(paths[static_cast<int>(ShaderType::DEFAULT)] + ".vert", _path + ".frag");
+  if (ReadShaderSource(_path + ".frag", fragment)) {
+    if (ReadShaderSource(_path + ".vert", vertex) && shader->loadFromMemory(vertex, fragment))
+    {
+      result = true;
+    }
+    else // default vert shader
+    {
+      result = ReadShaderSource(paths[static_cast<int>(ShaderType::DEFAULT)] + ".vert", vertex) && shader->loadFromMemory(vertex, fragment);
+    }
   }
 
   if (!result)
@@ -51,7 +81,10 @@ sf::Shader* ShaderResourceManager::LoadShaderFromFile(string _path)
   }
 #else 
   sf::Shader* shader = new sf::Shader();
-  if (!shader->loadFromFile(_path + ".frag", sf::Shader::Fragment)) {
+  std::string fragment;
+
+  // packages can be mounted from zips that were never extracted
+  if (!ReadShaderSource(_path + ".frag", fragment) || !shader->loadFromMemory(fragment, sf::Shader::Fragment)) {
     Logger::Log(LogLevel::critical, "Error loading shader: " + _path + ".frag");
     return nullptr;
   }
@@ -15,6 +15,15 @@ SharedHitbox::SharedHitbox(std::weak_ptr<Entity> owner, float duration) :
   keepAlive = (duration == 0.0f);
 }
 
+void SharedHitbox::OnPoolReset(std::weak_ptr<Entity> owner, float duration) {
+  this->owner = owner;
+  SetTeam(owner.lock()->GetTeam());
+  SetLayer(1);
+  cooldown = duration;
+  SetHitboxProperties(owner.lock()->GetHitboxProperties());
+  keepAlive = (duration == 0.0f);
+}
+
 void SharedHitbox::OnUpdate(double _elapsed) {
   cooldown -= _elapsed;
 
@@ -26,6 +26,11 @@ public:
    */
   SharedHitbox(std::weak_ptr<Entity> owner, float duration = 0.0f);
 
+  /**
+   * @brief Points a recycled hitbox at a new owner
+   */
+  void OnPoolReset(std::weak_ptr<Entity> owner, float duration = 0.0f);
+
   /**
    * @brief Removes itself if time is up or the original source is deleted
    * @param _elapsed in seconds
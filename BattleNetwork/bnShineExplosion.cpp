@@ -16,13 +16,27 @@ ShineExplosion::ShineExplosion() : Artifact()
 void ShineExplosion::Init() {
   Artifact::Init();
 
-  animationComponent = CreateComponent<AnimationComponent>(weak_from_this());
-  animationComponent->SetPath("resources/scenes/battle/boss_shine.animation");
-  animationComponent->Load();
+  // recycled shines keep the animation they already loaded
+  if (animationComponent) {
+    ReattachComponent(animationComponent);
+  }
+  else {
+    animationComponent = CreateComponent<AnimationComponent>(weak_from_this());
+    animationComponent->SetPath("resources/scenes/battle/boss_shine.animation");
+    animationComponent->Load();
+  }
+
   animationComponent->SetAnimation("SHINE", Animator::Mode::Loop);
   animationComponent->Refresh();
 }
 
+void ShineExplosion::OnPoolReset()
+{
+  SetLayer(0);
+  setTexture(Textures().LoadFromFile(TexturePaths::MOB_BOSS_SHINE));
+  setScale(2.f, 2.f);
+}
+
 void ShineExplosion::OnUpdate(double _elapsed) {
   Entity::drawOffset.y= -this->GetHeight();
 }
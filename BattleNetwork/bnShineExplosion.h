@@ -18,6 +18,11 @@ public:
 
   void Init() override;
 
+  /**
+  * @brief Restores the layer, texture and scale of recycled shines
+  */
+  void OnPoolReset() override;
+
   /**
    * @brief Loops animations
    * @param _elapsed in seconds
@@ -1,20 +1,94 @@
 #include "bnSmartShader.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+  struct UniformRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, SmartShader::UniformID> ids; /*!< node-stable so the names can be pointed to */
+  };
+
+  UniformRegistry& GetUniformRegistry() {
+    static UniformRegistry registry;
+    return registry;
+  }
+
+  std::unordered_map<std::string, SmartShader::UniformID>::const_iterator FindUniform(UniformRegistry& registry, const std::string& name) {
+    auto iter = registry.ids.find(name);
+
+    if (iter == registry.ids.end()) {
+      iter = registry.ids.emplace(name, static_cast<SmartShader::UniformID>(registry.ids.size())).first;
+    }
+
+    return iter;
+  }
+}
+
+/**
+ * @brief The values last sent to one sf::Shader indexed by uniform id
+ */
+struct SmartShader::UploadedState {
+  struct Pending {
+    UniformID id{};
+    const std::string* name{ nullptr };
+    UniformValue value;
+  };
+
+  std::vector<UniformValue> values; /*!< texture values keep no reference, see textures */
+  std::vector<std::weak_ptr<sf::Texture>> textures; /*!< textures last bound, weak so the resource cache can still free them */
+  std::vector<bool> known;
+  std::vector<Pending> pending; /*!< defaults waiting for the next draw with this shader */
+};
+
+  bool SmartShader::UniformValue::operator==(const UniformValue& other) const {
+    if (type != other.type) return false;
+
+    switch (type) {
+    case Type::integer:
+      return i == other.i;
+    case Type::floating:
+      return f[0] == other.f[0];
+    case Type::vec2:
+      return f[0] == other.f[0] && f[1] == other.f[1];
+    case Type::vec4:
+      return f == other.f;
+    case Type::float_array:
+      return arr == other.arr;
+    case Type::texture:
+      return tex == other.tex;
+    case Type::current_texture:
+      return true;
+    }
+
+    return false;
+  }
+
+  SmartShader::UniformID SmartShader::GetUniformID(const std::string& name) {
+    UniformRegistry& registry = GetUniformRegistry();
+    std::scoped_lock lock(registry.mutex);
+    return FindUniform(registry, name)->second;
+  }
 
   SmartShader::SmartShader() {
     ref = nullptr;
   }
 
   SmartShader::SmartShader(const SmartShader& copy) {
-    funiforms = copy.funiforms;
-    iuniforms = copy.iuniforms;
-    vfuniforms = copy.vfuniforms;
-    duniforms = copy.duniforms;
-    farruniforms = copy.farruniforms;
-    coluniforms = copy.coluniforms;
-    texuniforms = copy.texuniforms;
-    textypeuniforms = copy.textypeuniforms;
+    *this = copy;
+  }
+
+  SmartShader& SmartShader::operator=(const SmartShader& copy) {
+    if (this == &copy) return *this;
+
+    uniformIds = copy.uniformIds;
+    uniformNames = copy.uniformNames;
+    uniformValues = copy.uniformValues;
+    uploaded = copy.uploaded;
+    uploadedFor = copy.uploadedFor;
 
     ref = copy.ref;
+    return *this;
   }
 
   SmartShader::~SmartShader() {
@@ -44,153 +118,235 @@
    return ref != nullptr;
  }
 
-  void SmartShader::ApplyUniforms() {
-    if (!ref) return;
+ const bool SmartShader::HasUniforms() const {
+   return !uniformIds.empty();
+ }
 
-    iiter iIter = iuniforms.begin();
-    fiter fIter = funiforms.begin();
-    diter dIter = duniforms.begin();
-    farriter farrIter = farruniforms.begin();
-    vfiter vfIter = vfuniforms.begin();
-    coliter colIter = coluniforms.begin();
-    texiter texIter = texuniforms.begin();
-    textypeiter texTypeIter = textypeuniforms.begin();
-
-    for (; iIter != iuniforms.end(); iIter++) {
-      ref->setUniform(iIter->first, iIter->second);
+  SmartShader::UploadedState* SmartShader::GetUploadedState() {
+    if (uploadedFor == ref && uploaded) {
+      return uploaded;
     }
 
-    for (; fIter != funiforms.end(); fIter++) {
-      ref->setUniform(fIter->first, fIter->second);
-    }
+    // shaders are owned by the ShaderResourceManager and live as long as the app
+    // so their state is never freed either. It holds no texture references
+    static std::unordered_map<const sf::Shader*, std::unique_ptr<UploadedState>> states;
 
-    for (; dIter != duniforms.end(); dIter++) {
-      ref->setUniform(dIter->first, static_cast<float>(dIter->second));
-    }
+    std::unique_ptr<UploadedState>& state = states[ref];
 
-    for (; farrIter != farruniforms.end(); farrIter++) {
-      ref->setUniformArray(farrIter->first, farrIter->second.data(), farrIter->second.size());
+    if (!state) {
+      state = std::make_unique<UploadedState>();
     }
 
-    for (; vfIter != vfuniforms.end(); vfIter++) {
-      ref->setUniform(vfIter->first, vfIter->second);
-    }
+    uploaded = state.get();
+    uploadedFor = ref;
+    return uploaded;
+  }
 
-    for (; colIter != coluniforms.end(); colIter++) {
-      sf::Color col = colIter->second;
-      ref->setUniform(colIter->first, 
-        sf::Glsl::Vec4{ 
-          col.r/255.f,
-          col.g/255.f, 
-          col.b/255.f, 
-          col.a/255.f 
-        }
-      );
+  void SmartShader::Upload(UploadedState& state, UniformID id, const std::string& name, const UniformValue& value) {
+    using Type = UniformValue::Type;
+
+    if (id >= state.values.size()) {
+      state.values.resize(static_cast<size_t>(id) + 1u);
+      state.textures.resize(static_cast<size_t>(id) + 1u);
+      state.known.resize(static_cast<size_t>(id) + 1u, false);
     }
 
-    for (; texIter != texuniforms.end(); texIter++) {
-      ref->setUniform(texIter->first, *texIter->second);
+    if (state.known[id]) {
+      const UniformValue& last = state.values[id];
+
+      // an expired texture never matches, even if a new one was allocated at the same address
+      bool same = value.type == Type::texture
+        ? last.type == Type::texture && state.textures[id].lock() == value.tex
+        : last == value;
+
+      if (same) return;
     }
 
-    for (; texTypeIter != textypeuniforms.end(); texTypeIter++) {
-      ref->setUniform(texTypeIter->first, texTypeIter->second);
+    switch (value.type) {
+    case Type::integer:
+      ref->setUniform(name, value.i);
+      break;
+    case Type::floating:
+      ref->setUniform(name, value.f[0]);
+      break;
+    case Type::vec2:
+      ref->setUniform(name, sf::Glsl::Vec2{ value.f[0], value.f[1] });
+      break;
+    case Type::vec4:
+      ref->setUniform(name, sf::Glsl::Vec4{ value.f[0], value.f[1], value.f[2], value.f[3] });
+      break;
+    case Type::float_array:
+      ref->setUniformArray(name, value.arr.data(), value.arr.size());
+      break;
+    case Type::texture:
+      ref->setUniform(name, *value.tex);
+      break;
+    case Type::current_texture:
+      ref->setUniform(name, sf::Shader::CurrentTexture);
+      break;
     }
 
+    state.values[id] = value;
+    state.values[id].tex.reset();
+    state.textures[id] = value.tex;
+    state.known[id] = true;
   }
 
-  void SmartShader::ResetUniforms() {
-    if (!ref) {
-      return;
-    }
+  void SmartShader::ApplyUniforms() {
+    if (!ref) return;
 
-    iiter iIter = iuniforms.begin();
-    fiter fIter = funiforms.begin();
-    diter dIter = duniforms.begin();
-    farriter farrIter = farruniforms.begin();
-    vfiter vfIter = vfuniforms.begin();
-    coliter colIter = coluniforms.begin();
-    texiter texIter = texuniforms.begin();
-    textypeiter texTypeIter = textypeuniforms.begin();
-
-    for (; iIter != iuniforms.end(); iIter++) {
-      ref->setUniform(iIter->first, 0);
-    }
+    UploadedState& state = *GetUploadedState();
 
-    for (; fIter != funiforms.end(); fIter++) {
-      ref->setUniform(fIter->first, 0.f);
+    for (size_t i = 0; i < uniformIds.size(); i++) {
+      Upload(state, uniformIds[i], *uniformNames[i], uniformValues[i]);
     }
 
-    for (; dIter != duniforms.end(); dIter++) {
-      ref->setUniform(dIter->first, 0.f);
-    }
+    // restore the defaults of the last draw that this draw does not overwrite
+    for (const UploadedState::Pending& pending : state.pending) {
+      if (std::find(uniformIds.begin(), uniformIds.end(), pending.id) != uniformIds.end()) continue;
 
-    for (; farrIter != farruniforms.end(); farrIter++) {
-      std::vector<float> dummyVec;
-      dummyVec.reserve(farrIter->second.size());
-      ref->setUniformArray(farrIter->first, dummyVec.data(), farrIter->second.size());
+      Upload(state, pending.id, *pending.name, pending.value);
     }
 
-    for (; vfIter != vfuniforms.end(); vfIter++) {
-      ref->setUniform(vfIter->first, 0.f);
-    }
+    state.pending.clear();
+  }
 
-    for (; colIter != coluniforms.end(); colIter++) {
-      ref->setUniform(colIter->first, 0.f);
+  void SmartShader::ResetUniforms() {
+    if (ref) {
+      UploadedState& state = *GetUploadedState();
+      using Type = UniformValue::Type;
+
+      // The defaults are not uploaded until the next draw with this shader.
+      // If that draw sets the same uniforms again then nothing is sent twice.
+      for (size_t i = 0; i < uniformIds.size(); i++) {
+        const UniformValue& value = uniformValues[i];
+        UniformValue zero;
+
+        switch (value.type) {
+        case Type::integer:
+        case Type::floating:
+          zero.type = value.type;
+          break;
+        case Type::float_array:
+          zero.type = value.type;
+          zero.arr.resize(value.arr.size(), 0.f);
+          break;
+        case Type::vec2:
+        case Type::vec4:
+          // vectors were never cleared
+          continue;
+        case Type::texture:
+        case Type::current_texture:
+          zero.type = Type::current_texture;
+          break;
+        }
+
+        auto iter = std::find_if(state.pending.begin(), state.pending.end(), [id = uniformIds[i]](const UploadedState::Pending& p) {
+          return p.id == id;
+        });
+
+        if (iter != state.pending.end()) {
+          iter->value = std::move(zero);
+        }
+        else {
+          state.pending.push_back(UploadedState::Pending{ uniformIds[i], uniformNames[i], std::move(zero) });
+        }
+      }
     }
 
-    for (; texIter != texuniforms.end(); texIter++) {
-      ref->setUniform(texIter->first, sf::Shader::CurrentTexture);
+    uniformIds.clear();
+    uniformNames.clear();
+    uniformValues.clear();
+  }
+
+  void SmartShader::SetValue(const std::string& uniform, UniformValue&& value) {
+    UniformID id{};
+    const std::string* name{ nullptr };
+
+    {
+      UniformRegistry& registry = GetUniformRegistry();
+      std::scoped_lock lock(registry.mutex);
+      auto iter = FindUniform(registry, uniform);
+      id = iter->second;
+      name = &iter->first;
     }
 
-    for (; texTypeIter != textypeuniforms.end(); texTypeIter++) {
-      ref->setUniform(texTypeIter->first, sf::Shader::CurrentTexture);
+    for (size_t i = 0; i < uniformIds.size(); i++) {
+      if (uniformIds[i] == id) {
+        uniformValues[i] = std::move(value);
+        return;
+      }
     }
 
-    iuniforms.clear();
-    funiforms.clear();
-    duniforms.clear();
-    farruniforms.clear();
-    vfuniforms.clear();
-    coluniforms.clear();
-    texuniforms.clear();
-    textypeuniforms.clear();
+    uniformIds.push_back(id);
+    uniformNames.push_back(name);
+    uniformValues.push_back(std::move(value));
   }
 
-  void SmartShader::SetUniform(std::string uniform, float fvalue) {
-    funiforms[uniform] = fvalue;
+  void SmartShader::SetUniform(const std::string& uniform, float fvalue) {
+    UniformValue value;
+    value.type = UniformValue::Type::floating;
+    value.f[0] = fvalue;
+    SetValue(uniform, std::move(value));
   }
 
-  void SmartShader::SetUniform(std::string uniform, double dvalue)
+  void SmartShader::SetUniform(const std::string& uniform, double dvalue)
   {
-    duniforms[uniform] = dvalue;
+    SetUniform(uniform, static_cast<float>(dvalue));
   }
 
-  void SmartShader::SetUniform(std::string uniform, const std::vector<float>& farr)
+  void SmartShader::SetUniform(const std::string& uniform, const std::vector<float>& farr)
   {
-    farruniforms[uniform] = farr;
+    UniformValue value;
+    value.type = UniformValue::Type::float_array;
+    value.arr = farr;
+    SetValue(uniform, std::move(value));
   }
 
-  void SmartShader::SetUniform(std::string uniform, int ivalue) {
-    iuniforms[uniform] = ivalue;
+  void SmartShader::SetUniform(const std::string& uniform, int ivalue) {
+    UniformValue value;
+    value.type = UniformValue::Type::integer;
+    value.i = ivalue;
+    SetValue(uniform, std::move(value));
   }
 
-  void SmartShader::SetUniform(std::string uniform, const sf::Vector2f& vfvalue) {
-    vfuniforms[uniform] = vfvalue;
+  void SmartShader::SetUniform(const std::string& uniform, const sf::Vector2f& vfvalue) {
+    UniformValue value;
+    value.type = UniformValue::Type::vec2;
+    value.f[0] = vfvalue.x;
+    value.f[1] = vfvalue.y;
+    SetValue(uniform, std::move(value));
   }
 
-  void SmartShader::SetUniform(std::string uniform, const sf::Color& colvalue)
+  void SmartShader::SetUniform(const std::string& uniform, const sf::Color& colvalue)
   {
-    coluniforms[uniform] = colvalue;
+    UniformValue value;
+    value.type = UniformValue::Type::vec4;
+    value.f = { colvalue.r / 255.f, colvalue.g / 255.f, colvalue.b / 255.f, colvalue.a / 255.f };
+    SetValue(uniform, std::move(value));
   }
 
-  void SmartShader::SetUniform(std::string uniform, const std::shared_ptr<sf::Texture>& texvalue)
+  void SmartShader::SetUniform(const std::string& uniform, const std::shared_ptr<sf::Texture>& texvalue)
   {
-    texuniforms[uniform] = texvalue;
+    UniformValue value;
+
+    if (texvalue) {
+      value.type = UniformValue::Type::texture;
+      value.tex = texvalue;
+    }
+    else {
+      // there is no texture to bind, sample the sprite's own texture instead
+      value.type = UniformValue::Type::current_texture;
+    }
+
+    SetValue(uniform, std::move(value));
   }
 
-  void SmartShader::SetUniform(std::string uniform, const sf::Shader::CurrentTextureType& value)
+  void SmartShader::SetUniform(const std::string& uniform, const sf::Shader::CurrentTextureType& value)
   {
-    textypeuniforms[uniform] = value;
+    UniformValue textype;
+    textype.type = UniformValue::Type::current_texture;
+    SetValue(uniform, std::move(textype));
   }
 
   void SmartShader::Reset() {
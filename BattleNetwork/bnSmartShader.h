@@ -3,36 +3,81 @@
  * Currently supports int, float, double, vector2f uniforms
  * 
  * Additional uniforms must be added
+ *
+ * Uniform names are resolved to small integer ids once. Values are kept in flat arrays
+ * and are only sent to the sf::Shader when they differ from the values last sent to it.
+ * Sprites that share a shader and the same parameters do not upload anything.
+ *
+ * @warning Uniforms set through a SmartShader should not also be set directly on the sf::Shader
  */
 
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <memory>
-#include <map>
+#include <vector>
+#include <array>
+#include <string>
+#include <cstdint>
 
 class SmartShader
 {
   friend class DrawWindow;
 
+public:
+  using UniformID = uint16_t;
+
+  /**
+   * @brief A uniform value of any of the supported types
+   */
+  struct UniformValue {
+    enum class Type : uint8_t {
+      integer = 0,
+      floating,
+      float_array,
+      vec2,
+      vec4,
+      texture,
+      current_texture
+    } type{};
+
+    std::array<float, 4> f{}; /*!< floating, vec2, vec4 */
+    int i{};
+    std::vector<float> arr;
+    std::shared_ptr<sf::Texture> tex;
+
+    bool operator==(const UniformValue& other) const;
+    bool operator!=(const UniformValue& other) const { return !(*this == other); }
+  };
+
+  /**
+   * @brief Resolves a uniform name to an id shared by every shader
+   */
+  static UniformID GetUniformID(const std::string& name);
+
 private:
-  sf::Shader* ref; /*!< Pointer to shader object */
-  std::map<std::string, int>    iuniforms; /*!< lookup of integer uniforms */
-  std::map<std::string, float>  funiforms; /*!< lookup of float uniforms */
-  std::map<std::string, double> duniforms; /*!< lookup of double uniforms */
-  std::map<std::string, std::vector<float>> farruniforms; /*! lookup of float arrays */
-  std::map<std::string, sf::Vector2f> vfuniforms; /*!< lookup of vector2f uniforms */
-  std::map<std::string, sf::Color> coluniforms; /*!< lookup of sf::Color uniforms */
-  std::map<std::string, std::shared_ptr<sf::Texture>> texuniforms; /*! lookups of texture uniforms */
-  std::map<std::string, sf::Shader::CurrentTextureType> textypeuniforms;
-
-  typedef std::map<std::string, int>::iterator iiter; 
-  typedef std::map<std::string, float>::iterator fiter;
-  typedef std::map<std::string, double>::iterator diter;
-  typedef std::map<std::string, std::vector<float>>::iterator farriter;
-  typedef std::map<std::string, sf::Vector2f>::iterator vfiter;
-  typedef std::map<std::string, sf::Color>::iterator coliter;
-  typedef std::map<std::string, std::shared_ptr<sf::Texture>>::iterator texiter;
-  typedef std::map<std::string, sf::Shader::CurrentTextureType>::iterator textypeiter;
+  struct UploadedState;
+
+  sf::Shader* ref{ nullptr }; /*!< Pointer to shader object */
+  std::vector<UniformID> uniformIds; /*!< ids of the uniforms set on this shader */
+  std::vector<const std::string*> uniformNames; /*!< interned names parallel to uniformIds */
+  std::vector<UniformValue> uniformValues; /*!< values parallel to uniformIds */
+  UploadedState* uploaded{ nullptr }; /*!< values last sent to ref, shared by every SmartShader using ref */
+  const sf::Shader* uploadedFor{ nullptr };
+
+  /**
+   * @brief Finds or creates the uploaded values for ref
+   */
+  UploadedState* GetUploadedState();
+
+  /**
+   * @brief Stores the value to be sent on the next draw
+   */
+  void SetValue(const std::string& uniform, UniformValue&& value);
+
+  /**
+   * @brief Sends value to ref unless it is already the value ref has
+   */
+  void Upload(UploadedState& state, UniformID id, const std::string& name, const UniformValue& value);
 
   /**
    * @brief Applies all registered uniform values before drawing
@@ -41,6 +86,9 @@ private:
   
   /**
    * @brief Clears the shader object of all uniform values
+   *
+   * The zeroed values are sent with the next draw that uses the same shader
+   * unless that draw sets them again
    */
   void ResetUniforms();
 
@@ -54,9 +102,11 @@ public:
    * @brief Constructs a smart shader from another smart shader
    */
   SmartShader(const SmartShader&);
+
+  SmartShader& operator=(const SmartShader&);
   
   /**
-   * @brief Frees the reference to the shader object and empties the uniform dictionaries
+   * @brief Frees the reference to the shader object and empties the uniform values
    */
   ~SmartShader();
   
@@ -83,56 +133,56 @@ public:
    * @param uniform the name of the uniform
    * @param fvalue
    */
-  void SetUniform(std::string uniform, float fvalue);
+  void SetUniform(const std::string& uniform, float fvalue);
 
   /**
    * @brief Set a double uniform value
    * @param uniform the name of the uniform
    * @param dvalue
    */
-  void SetUniform(std::string uniform, double dvalue);
+  void SetUniform(const std::string& uniform, double dvalue);
 
   /**
    * @brief Set a float array uniform value
    * @param uniform the name of the uniform
    * @param farrvalue
    */
-  void SetUniform(std::string uniform, const std::vector<float>& farr);
+  void SetUniform(const std::string& uniform, const std::vector<float>& farr);
   
   /**
    * @brief Set an integer uniform value
    * @param uniform the name of the uniform
    * @param ivalue
    */
-  void SetUniform(std::string uniform, int ivalue);
+  void SetUniform(const std::string& uniform, int ivalue);
   
   /**
    * @brief Set a vector2f uniform value
    * @param uniform the name of the uniform
    * @param vfvalue
    */
-  void SetUniform(std::string uniform, const sf::Vector2f& vfvalue);
+  void SetUniform(const std::string& uniform, const sf::Vector2f& vfvalue);
   
   /**
    * @brief Set a color uniform value
    * @param uniform the name of the uniform
    * @param colvalue
    */
-  void SetUniform(std::string uniform, const sf::Color& colvalue);
+  void SetUniform(const std::string& uniform, const sf::Color& colvalue);
 
   /**
    * @brief Set a texture uniform value
    * @param uniform the name of the uniform
    * @param texvalue
    */
-  void SetUniform(std::string uniform, const std::shared_ptr<sf::Texture>& texvalue);
+  void SetUniform(const std::string& uniform, const std::shared_ptr<sf::Texture>& texvalue);
 
   /**
   * @brief Set a texture type uniform value
   * @param uniform the name of the uniform
   * @param value
   */
-  void SetUniform(std::string uniform, const sf::Shader::CurrentTextureType& value);
+  void SetUniform(const std::string& uniform, const sf::Shader::CurrentTextureType& value);
 
   /**
    * @brief Sets all pre-existing uniforms to 0, empties the lookups, and frees ref
@@ -145,6 +195,11 @@ public:
    */
   sf::Shader* Get();
 
+  /**
+   * @brief Query if any uniform values will be applied by the next Get()
+   */
+  const bool HasUniforms() const;
+
   /**
    * @brief Lighter than checking if Get() returns nullptr
    * @return true if ref is not nullptr
@@ -145,8 +145,8 @@ inline void ExpectLuaFunction(sol::object object) {
   }
 }
 
-inline stx::result_t<sol::object> EvalLua(sol::state& lua, const std::string& dataString) {
-  sol::protected_function_result result = lua.safe_script(dataString, sol::script_pass_on_error);
+inline stx::result_t<sol::object> EvalLua(sol::state& lua, const sol::environment& env, const std::string& dataString) {
+  sol::protected_function_result result = lua.safe_script(dataString, env, sol::script_pass_on_error);
 
   if (!result.valid()) {
     sol::error error = result;
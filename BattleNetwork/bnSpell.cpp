@@ -8,6 +8,14 @@ Spell::Spell(Team team) : Entity()
   ShareTileSpace(true);
 }
 
+void Spell::ResetPooledState()
+{
+  Entity::ResetPooledState();
+  SetFloatShoe(true);
+  SetLayer(1);
+  ShareTileSpace(true);
+}
+
 void Spell::OnUpdate(double _elapsed) {
   //if (IsTimeFrozen()) return;
 
@@ -12,6 +12,13 @@
 using sf::Texture;
 
 class Spell : public Entity {
+  friend class EntityPool;
+
+  /**
+   * @brief Restores the constructor defaults. The team is passed to OnPoolReset()
+   */
+  void ResetPooledState() override;
+
 public:
   /**
    * @brief Sets the layer to 1 (underneath characters, layer = 0) and enables FloatShoe
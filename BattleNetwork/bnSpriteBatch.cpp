@@ -0,0 +1,141 @@
+#include "bnSpriteBatch.h"
+#include "bnSpriteProxyNode.h"
+#include <typeinfo>
+
+void SpriteBatch::Begin(sf::RenderTarget& target)
+{
+  Flush();
+
+  this->target = &target;
+  drawCalls = 0;
+  sprites = 0;
+}
+
+void SpriteBatch::DrawSprite(const sf::Sprite& sprite, const sf::RenderStates& states)
+{
+  if (!target) return;
+
+  const sf::Texture* spriteTexture = sprite.getTexture();
+
+  if (!vertices.empty() && (spriteTexture != texture || states.shader != shader || !(states.blendMode == blendMode))) {
+    Flush();
+  }
+
+  texture = spriteTexture;
+  shader = states.shader;
+  blendMode = states.blendMode;
+
+  const sf::IntRect rect = sprite.getTextureRect();
+  const sf::FloatRect bounds = sprite.getLocalBounds();
+  const sf::Transform transform = states.transform * sprite.getTransform();
+  const sf::Color color = sprite.getColor();
+
+  const float left = static_cast<float>(rect.left);
+  const float right = left + static_cast<float>(rect.width);
+  const float top = static_cast<float>(rect.top);
+  const float bottom = top + static_cast<float>(rect.height);
+
+  // same corners as sf::Sprite's triangle strip
+  const sf::Vertex topLeft(transform.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top));
+  const sf::Vertex bottomLeft(transform.transformPoint(0.f, bounds.height), color, sf::Vector2f(left, bottom));
+  const sf::Vertex topRight(transform.transformPoint(bounds.width, 0.f), color, sf::Vector2f(right, top));
+  const sf::Vertex bottomRight(transform.transformPoint(bounds.width, bounds.height), color, sf::Vector2f(right, bottom));
+
+  vertices.push_back(topLeft);
+  vertices.push_back(bottomLeft);
+  vertices.push_back(topRight);
+  vertices.push_back(topRight);
+  vertices.push_back(bottomLeft);
+  vertices.push_back(bottomRight);
+
+  sprites++;
+}
+
+void SpriteBatch::DrawNode(const SpriteProxyNode& node, const sf::RenderStates& states)
+{
+  DrawNode(node, states, node.getTransform());
+}
+
+void SpriteBatch::DrawNode(const SpriteProxyNode& node, sf::RenderStates states, const sf::Transform& transform)
+{
+  if (!target || node.IsHidden()) return;
+
+  states.transform *= transform;
+
+  SmartShader& smartShader = node.GetShader();
+
+  // Get() sends this node's uniforms right away. They must not reach sprites that are already queued.
+  const bool hasUniforms = smartShader.HasUniforms();
+
+  if (hasUniforms) {
+    Flush();
+  }
+
+  if (sf::Shader* s = smartShader.Get()) {
+    states.shader = s;
+  }
+  else if (!node.IsUsingParentShader()) {
+    states.shader = nullptr;
+  }
+
+  // children are kept in draw order. The node itself goes before the first child on a lower layer
+  const std::vector<std::shared_ptr<SceneNode>>& children = node.GetChildNodes();
+  bool drewSelf = false;
+
+  for (const std::shared_ptr<SceneNode>& child : children) {
+    if (!drewSelf && child->GetLayer() < node.GetLayer()) {
+      DrawSprite(node.getSpriteConst(), states);
+      drewSelf = true;
+    }
+
+    if (typeid(*child) == typeid(SpriteProxyNode)) {
+      DrawNode(static_cast<const SpriteProxyNode&>(*child), states);
+    }
+    else {
+      Draw(*child, states);
+    }
+  }
+
+  if (!drewSelf) {
+    DrawSprite(node.getSpriteConst(), states);
+  }
+
+  if (hasUniforms) {
+    Flush();
+  }
+}
+
+void SpriteBatch::Draw(const sf::Drawable& drawable, const sf::RenderStates& states)
+{
+  if (!target) return;
+
+  Flush();
+  target->draw(drawable, states);
+}
+
+void SpriteBatch::Flush()
+{
+  if (!target || vertices.empty()) return;
+
+  sf::RenderStates states(blendMode, sf::Transform::Identity, texture, shader);
+  target->draw(vertices.data(), vertices.size(), sf::Triangles, states);
+
+  vertices.clear();
+  drawCalls++;
+}
+
+void SpriteBatch::End()
+{
+  Flush();
+  target = nullptr;
+}
+
+const size_t SpriteBatch::DrawCalls() const
+{
+  return drawCalls;
+}
+
+const size_t SpriteBatch::SpriteCount() const
+{
+  return sprites;
+}
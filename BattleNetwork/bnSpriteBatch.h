@@ -0,0 +1,77 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+class SpriteProxyNode;
+
+/**
+ * @class SpriteBatch
+ * @brief Merges consecutive sprites that share a texture, shader and blend mode into one draw call
+ *
+ * Sprites are transformed on the CPU and appended to a triangle list. The list is sent to the
+ * target when the next sprite needs different render states, when something that cannot be
+ * batched is drawn, or at End(). Draw order is kept exactly as submitted.
+ *
+ * Positions are given through the render states so nodes do not have to be moved before
+ * drawing and moved back afterwards.
+ *
+ * @warning Sprites batched together with the same shader are drawn with the uniforms the shader
+ *          has when the batch is flushed. Nodes with their own uniform values are drawn on their own.
+ */
+class SpriteBatch {
+public:
+  SpriteBatch() = default;
+  SpriteBatch(const SpriteBatch&) = delete;
+  SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+  /**
+   * @brief Starts collecting sprites for target. Resets the counters.
+   */
+  void Begin(sf::RenderTarget& target);
+
+  /**
+   * @brief Queues one sprite
+   */
+  void DrawSprite(const sf::Sprite& sprite, const sf::RenderStates& states);
+
+  /**
+   * @brief Queues a node and its children the same way SpriteProxyNode::draw() draws them
+   * @warning Only use for nodes that do not override draw(). Children that are
+   *          not plain SpriteProxyNodes are drawn normally.
+   */
+  void DrawNode(const SpriteProxyNode& node, const sf::RenderStates& states);
+
+  /**
+   * @brief Same as above but with `transform` used in place of the node's own transform
+   */
+  void DrawNode(const SpriteProxyNode& node, sf::RenderStates states, const sf::Transform& transform);
+
+  /**
+   * @brief Draws anything else after sending what has been queued so far
+   */
+  void Draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default);
+
+  /**
+   * @brief Sends the queued sprites to the target in one draw call
+   */
+  void Flush();
+
+  /**
+   * @brief Flushes and stops using the target
+   */
+  void End();
+
+  /**
+   * @brief Draw calls made and sprites queued since Begin()
+   */
+  const size_t DrawCalls() const;
+  const size_t SpriteCount() const;
+
+private:
+  sf::RenderTarget* target{ nullptr };
+  std::vector<sf::Vertex> vertices; /*!< sf::Triangles, 6 per sprite. Keeps its capacity between frames */
+  const sf::Texture* texture{ nullptr };
+  const sf::Shader* shader{ nullptr };
+  sf::BlendMode blendMode;
+  size_t drawCalls{}, sprites{};
+};
@@ -20,6 +20,8 @@ SpriteProxyNode::SpriteProxyNode(SpriteProxyNode&& rhs) noexcept
 {
   std::swap(allocatedSprite, rhs.allocatedSprite);
   std::swap(childNodes, rhs.childNodes);
+  std::swap(childrenDirty, rhs.childrenDirty);
+  std::swap(sortedAtLayerChange, rhs.sortedAtLayerChange);
   std::swap(layer, rhs.layer);
   std::swap(parent, rhs.parent);
   std::swap(shader, rhs.shader);
@@ -102,6 +104,11 @@ void SpriteProxyNode::setTexture(const std::shared_ptr<sf::Texture> texture, boo
   sprite->setTexture(*texture, resetRect);
 }
 
+void SpriteProxyNode::ClearTexture() {
+  textureRef = nullptr;
+  *sprite = sf::Sprite();
+}
+
 void SpriteProxyNode::SetShader(sf::Shader* _shader) {
   if (shader.Get() == _shader && _shader != nullptr) return;
 
@@ -147,24 +154,23 @@ void SpriteProxyNode::draw(sf::RenderTarget& target, sf::RenderStates states) co
     states.shader = nullptr;
   }
 
-  std::vector<SceneNode*> copies;
-  copies.reserve(childNodes.size() + 1);
-
-  for (auto& child : childNodes) {
-    copies.push_back(child.get());
-  }
-
-  copies.push_back((SceneNode*)this);
-
-  std::sort(copies.begin(), copies.end(), [](SceneNode* a, SceneNode* b) { return (a->GetLayer() > b->GetLayer()); });
+  SortChildren();
 
   // draw its children
-  for (std::size_t i = 0; i < copies.size(); i++) {
-    // If it's time to draw our scene node, we draw the proxy sprite
-    if(copies[i] == this) {
+  // If it's time to draw our scene node, we draw the proxy sprite
+  // before the first child on a lower layer
+  bool drewSelf = false;
+
+  for (std::size_t i = 0; i < childNodes.size(); i++) {
+    if (!drewSelf && childNodes[i]->GetLayer() < GetLayer()) {
       target.draw(*sprite, states);
-    } else {
-      copies[i]->draw(target, states);
+      drewSelf = true;
     }
+
+    childNodes[i]->draw(target, states);
+  }
+
+  if (!drewSelf) {
+    target.draw(*sprite, states);
   }
 }
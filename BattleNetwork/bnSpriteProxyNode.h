@@ -137,6 +137,11 @@ public:
    */
   void setTexture(const std::shared_ptr<sf::Texture> texture, bool resetRect = true);
 
+  /**
+   * @brief Drops the texture and resets the proxied sprite
+   */
+  void ClearTexture();
+
   /**
    * @brief Converts sf::Shader to SmartShader and attaches it.
    * @param _shader
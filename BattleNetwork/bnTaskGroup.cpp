@@ -15,10 +15,10 @@ const bool TaskGroup::HasMore() const
   return tasks.size();
 }
 
-void TaskGroup::DoNextTask()
+void TaskGroup::DoNextTask(const ProgressFunc& report)
 {
   if (tasks.size()) {
-    tasks.begin()->second();
+    tasks.begin()->second(report);
     tasks.erase(tasks.begin());
     currentTask++;
   }
@@ -40,6 +40,13 @@ const unsigned TaskGroup::GetTotalTasks() const
 }
 
 void TaskGroup::AddTask(const std::string & name, Callback<void()>&& task)
+{
+  Callback<void(const ProgressFunc&)> wrapper;
+  wrapper.Slot([task = std::move(task)](const ProgressFunc&) mutable { task(); });
+  AddTask(name, std::move(wrapper));
+}
+
+void TaskGroup::AddTask(const std::string& name, Callback<void(const ProgressFunc&)>&& task)
 {
   tasks.insert(tasks.end(), std::make_pair(name, std::move(task)));
   maxTasks++;
@@ -3,7 +3,12 @@
 #include "bnCallback.h"
 
 class TaskGroup {
-  std::list<std::pair<std::string, Callback<void()>>> tasks;
+public:
+  /*! \brief Reports how far the running task is, from 0 to 1 */
+  using ProgressFunc = std::function<void(float)>;
+
+private:
+  std::list<std::pair<std::string, Callback<void(const ProgressFunc&)>>> tasks;
   unsigned currentTask{}, maxTasks{};
 public:
   TaskGroup() = default;
@@ -11,9 +16,12 @@ public:
   ~TaskGroup() = default;
 
   const bool HasMore() const;
-  void DoNextTask();
+  void DoNextTask(const ProgressFunc& report = {});
   const std::string& GetTaskName() const;
   const unsigned GetTaskNumber() const;
   const unsigned GetTotalTasks() const;
   void AddTask(const std::string& name, Callback<void()>&& task);
+
+  /*! \brief Adds a task that reports its own progress while it runs */
+  void AddTask(const std::string& name, Callback<void(const ProgressFunc&)>&& task);
 };
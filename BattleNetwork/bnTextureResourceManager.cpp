@@ -1,7 +1,11 @@
 #include "bnTextureResourceManager.h"
+#include "bnWorkerPool.h"
+#include "bnVirtualFileSystem.h"
 
 #include <stdlib.h>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <sstream>
 #include <fstream>
 #include <mutex>
@@ -16,57 +20,192 @@ void TextureResourceManager::LoadAllTextures(std::atomic<int>& status)
   */
 }
 
+namespace {
+  size_t TextureBytes(const Texture& texture) {
+    sf::Vector2u size = texture.getSize();
+    return static_cast<size_t>(size.x) * size.y * 4u;
+  }
+}
+
 void TextureResourceManager::HandleExpiredTextureCache()
 {
-  // std::scoped_lock lock(mutex);
-
-  auto iter = texturesFromPath.begin();
-  while (iter != texturesFromPath.end()) {
-    if (iter->second.GetSecondsSinceLastRequest() > 60.0f) {
-      if (iter->second.IsInUse()) {
-        iter++; continue;
-      }
-
-      // 1 minute is long enough
-      Logger::Logf(LogLevel::debug, "Texture data %s expired", iter->first.c_str());
-      iter = texturesFromPath.erase(iter);
-      continue;
-    }
+  size_t released = texturesFromPath.Trim();
 
-    iter++;
+  if (released > 0) {
+    Logger::Logf(LogLevel::debug, "Texture cache released %u bytes", (unsigned)released);
   }
 }
 
-std::shared_ptr<Texture> TextureResourceManager::LoadFromFile(string _path) {
-  //std::scoped_lock lock(mutex);
+void TextureResourceManager::SetCacheBudget(size_t bytes)
+{
+  texturesFromPath.SetBudget(bytes);
+}
 
-  auto iter = texturesFromPath.find(_path);
+const ResourceCache<Texture>::Stats TextureResourceManager::GetCacheStats() const
+{
+  return texturesFromPath.GetStats();
+}
 
+std::shared_ptr<Texture> TextureResourceManager::LoadFromFile(string _path, bool evictable) {
   // check cache first
-  if (iter != texturesFromPath.end()) {
-    return iter->second.GetResource();
+  if (std::shared_ptr<Texture> cached = texturesFromPath.Find(_path)) {
+    if (!evictable) {
+      // the entry may have been cached by a preload or a script
+      texturesFromPath.SetPermanent(_path, true);
+    }
+
+    return cached;
+  }
+
+  std::shared_ptr<PendingTexture> inFlight;
+
+  {
+    std::scoped_lock lock(mutex);
+    inFlight = TakePending(_path);
   }
 
-  auto pathsIter = std::find(paths.begin(), paths.end(), _path);
+  // already being decoded in the background, waiting is faster than decoding again
+  if (inFlight) {
+    inFlight->done.wait();
+    std::shared_ptr<Texture> texture = Upload(*inFlight);
 
-  bool skipCaching = false;
+    if (!evictable) {
+      texturesFromPath.SetPermanent(_path, true);
+    }
 
-  if (pathsIter != paths.end()) {
-    skipCaching = true;
+    return texture;
   }
 
   std::shared_ptr<Texture> texture = std::make_shared<Texture>();
-  
-  if (!texture->loadFromFile(_path)) {
+
+  std::vector<char> data;
+  bool mounted = VirtualFileSystem::Instance().Read(_path, data);
+
+  if (!(mounted ? texture->loadFromMemory(data.data(), data.size()) : texture->loadFromFile(_path))) {
     Logger::Logf(LogLevel::critical, "Failed loading texture: %s", _path.c_str());
   } else {
     Logger::Logf(LogLevel::info, "Loaded texture: %s", _path.c_str());
   }
 
-  if (!skipCaching) {
-    texturesFromPath.insert(std::make_pair(_path, texture));
+  // another thread may have finished the same file first
+  texture = texturesFromPath.Insert(_path, texture, TextureBytes(*texture), !evictable);
+
+  if (!evictable) {
+    // Insert() keeps the flag of an entry that was already cached
+    texturesFromPath.SetPermanent(_path, true);
+  }
+
+  return texture;
+}
+
+ResourceFuture<Texture> TextureResourceManager::LoadAsync(const string& path)
+{
+  if (std::shared_ptr<Texture> cached = texturesFromPath.Find(path)) {
+    return ResourceFuture<Texture>::Ready(cached);
+  }
+
+  std::scoped_lock lock(mutex);
+
+  auto pendingIter = std::find_if(pending.begin(), pending.end(), [&path](const std::shared_ptr<PendingTexture>& load) {
+    return load->path == path;
+  });
+
+  if (pendingIter != pending.end()) {
+    return ResourceFuture<Texture>((*pendingIter)->state);
+  }
+
+  auto load = std::make_shared<PendingTexture>();
+  load->path = path;
+  load->state = std::make_shared<ResourceFuture<Texture>::State>();
+
+  // the job only owns the load so it is safe to outlive this manager
+  load->done = WorkerPool::Instance().Submit([load] {
+    std::vector<char> data;
+
+    if (VirtualFileSystem::Instance().Read(load->path, data)) {
+      load->decoded = load->image.loadFromMemory(data.data(), data.size());
+    }
+    else {
+      load->decoded = load->image.loadFromFile(load->path);
+    }
+  });
+
+  pending.push_back(load);
+
+  return ResourceFuture<Texture>(load->state);
+}
+
+size_t TextureResourceManager::UploadPending(double budget)
+{
+  auto start = std::chrono::steady_clock::now();
+  size_t uploaded = 0;
+
+  while (true) {
+    std::shared_ptr<PendingTexture> next;
+
+    {
+      std::scoped_lock lock(mutex);
+
+      auto iter = std::find_if(pending.begin(), pending.end(), [](const std::shared_ptr<PendingTexture>& load) {
+        return load->done.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+      });
+
+      if (iter == pending.end()) break;
+
+      next = *iter;
+      pending.erase(iter);
+    }
+
+    Upload(*next);
+    uploaded++;
+
+    std::chrono::duration<double> spent = std::chrono::steady_clock::now() - start;
+
+    if (spent.count() >= budget) break;
+  }
+
+  return uploaded;
+}
+
+const size_t TextureResourceManager::PendingCount() const
+{
+  std::scoped_lock lock(mutex);
+  return pending.size();
+}
+
+std::shared_ptr<TextureResourceManager::PendingTexture> TextureResourceManager::TakePending(const string& path)
+{
+  auto iter = std::find_if(pending.begin(), pending.end(), [&path](const std::shared_ptr<PendingTexture>& load) {
+    return load->path == path;
+  });
+
+  if (iter == pending.end()) {
+    return nullptr;
+  }
+
+  std::shared_ptr<PendingTexture> load = *iter;
+  pending.erase(iter);
+  return load;
+}
+
+std::shared_ptr<Texture> TextureResourceManager::Upload(PendingTexture& load)
+{
+  std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+  bool failed = !load.decoded || !texture->loadFromImage(load.image);
+
+  if (failed) {
+    Logger::Logf(LogLevel::critical, "Failed loading texture: %s", load.path.c_str());
+  } else {
+    Logger::Logf(LogLevel::info, "Loaded texture: %s", load.path.c_str());
   }
 
+  // the pixels are on the GPU now
+  load.image = sf::Image();
+
+  // a LoadFromFile() that did not see this load may have cached the same file first
+  texture = texturesFromPath.Insert(load.path, texture, TextureBytes(*texture));
+
+  load.state->Fulfill(texture, failed);
   return texture;
 }
 
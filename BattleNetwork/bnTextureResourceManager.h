@@ -9,13 +9,16 @@
 #pragma once
 #include "bnTextureType.h"
 #include "bnLogger.h"
-#include "bnCachedResource.h"
+#include "bnResourceCache.h"
+#include "bnResourceFuture.h"
 
 #include <SFML/Graphics.hpp>
 #include <map>
 #include <vector>
 #include <iostream>
 #include <atomic>
+#include <future>
+#include <mutex>
 
 using std::cerr;
 using std::endl;
@@ -27,6 +30,9 @@ using std::string;
 
 class TextureResourceManager {
 public:
+  static constexpr double DEFAULT_UPLOAD_BUDGET = 0.002; /*!< Seconds per frame spent sending decoded textures to the GPU */
+  static constexpr size_t DEFAULT_CACHE_BUDGET = 256u * 1024u * 1024u; /*!< Bytes of VRAM kept for textures nobody is using */
+
   TextureResourceManager();
   ~TextureResourceManager();
 
@@ -40,19 +46,76 @@ public:
   void LoadAllTextures(std::atomic<int> &status);
 
   /**
-  * @brief will clean expired textures from the cache and free image data
+  * @brief will evict the least recently used evictable textures nobody holds until the cache fits its budget
   */
   void HandleExpiredTextureCache();
+
+  /**
+   * @brief Bytes of VRAM the cache may hold
+   *
+   * Textures still in use count against it but are never evicted, so the cache
+   * can stay over budget until they are released
+   */
+  void SetCacheBudget(size_t bytes);
+
+  const ResourceCache<Texture>::Stats GetCacheStats() const;
   
   /**
    * @brief Given a file path, returns a pointer to the loaded texture
    * @param _path Relative path to the application
+   * @param evictable if false the texture stays cached for the rest of the run.
+   *        Only pass true if every user keeps the returned pointer for as long as it draws with the texture.
    * @return Texture. The texture is cached.
+   *
+   * Most of the engine builds sf::Sprites straight from the returned texture and drops the pointer.
+   * sf::Sprite only keeps a raw reference, so those textures must never be evicted.
+   * A non-evictable load also pins a texture that an earlier evictable load cached.
+   */
+  std::shared_ptr<Texture> LoadFromFile(string _path, bool evictable = false);
+
+  /**
+   * @brief Decodes the image on a worker thread instead of blocking the caller
+   * @param path Relative path to the application
+   * @return Handle that becomes ready after UploadPending() sends the texture to the GPU.
+   *         Already ready if the texture is cached. Loading the same path again shares the handle.
+   *         The texture can be evicted once the handle is released, until LoadFromFile() pins it.
+   *
+   * LoadFromFile() on a path that is still loading waits for the decode instead of starting over.
+   */
+  ResourceFuture<Texture> LoadAsync(const string& path);
+
+  /**
+   * @brief Sends decoded textures to the GPU. Must be called on the render thread.
+   * @param budget seconds to spend. At least one waiting texture is uploaded per call.
+   * @return number of textures uploaded
    */
-  std::shared_ptr<Texture> LoadFromFile(string _path);
+  size_t UploadPending(double budget = DEFAULT_UPLOAD_BUDGET);
+
+  /**
+   * @brief Number of textures requested with LoadAsync() that are not ready yet
+   */
+  const size_t PendingCount() const;
 
 private:
-  std::mutex mutex;
-  vector<string> paths; /**< Paths to all textures. Must be in order of TextureType @see TextureType */
-  map<std::string, CachedResource<Texture>> texturesFromPath; /**< Cache for textures loaded at run-time */
+  struct PendingTexture {
+    string path;
+    sf::Image image; /*!< Written by the worker thread */
+    bool decoded{}; /*!< Written by the worker thread */
+    std::shared_future<void> done; /*!< Ready once the worker is finished with image and decoded */
+    std::shared_ptr<ResourceFuture<Texture>::State> state;
+  };
+
+  mutable std::mutex mutex; /*!< Guards pending. The cache has its own locks */
+  ResourceCache<Texture> texturesFromPath{ DEFAULT_CACHE_BUDGET }; /**< Cache for textures loaded at run-time */
+  vector<std::shared_ptr<PendingTexture>> pending; /**< Async loads in the order they were requested */
+
+  /**
+   * @brief Removes the pending load for path. Must be called with the mutex locked.
+   */
+  std::shared_ptr<PendingTexture> TakePending(const string& path);
+
+  /**
+   * @brief Creates the GPU texture for a decoded load, caches it and fulfills its handle
+   */
+  std::shared_ptr<Texture> Upload(PendingTexture& load);
 };
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include "bnAudioResourceManager.h"
 #include "bnTextureResourceManager.h"
 #include "bnField.h"
+#include "bnFrameArena.h"
 
 #define TILE_WIDTH 40.0f
 #define TILE_HEIGHT 30.0f
@@ -215,6 +216,18 @@ namespace Battle {
     animation.Refresh(getSprite());
   }
 
+  const std::shared_ptr<sf::Texture> Tile::GetPerspectiveTexture(bool flipped) const
+  {
+    std::shared_ptr<sf::Texture> texture = getTexture();
+
+    if (!flipped) return texture;
+
+    if (texture == red_team_perm) return blue_team_perm;
+    if (texture == blue_team_perm) return red_team_perm;
+
+    return texture;
+  }
+
   void Tile::SetTeam(Team _team, bool useFlicker) {
     if (ogTeam == Team::unset) {
       ogTeam = _team;
@@ -498,6 +511,14 @@ namespace Battle {
       return;
     if (std::find_if(queuedAttackers.begin(), queuedAttackers.end(), [&attacker](int ID) { return ID == attacker.GetID(); }) != queuedAttackers.end())
       return;
+
+    // first attacker since this tile last resolved combat
+    if (queuedAttackers.empty()) {
+      if (std::shared_ptr<Field> field = fieldWeak.lock()) {
+        field->QueueCombatEvaluation(*this);
+      }
+    }
+
     queuedAttackers.push_back(attacker.GetID());
   }
 
@@ -571,7 +592,7 @@ namespace Battle {
     highlightMode = TileHighlight::none;
 
     // Process tile behaviors
-    vector<std::shared_ptr<Character>> characters_copy = characters;
+    FrameVector<std::shared_ptr<Character>> characters_copy(characters.begin(), characters.end());
     for (std::shared_ptr<Character>& character : characters_copy) {
       if (!character->IsTimeFrozen()) {
         HandleTileBehaviors(field, *character);
@@ -686,7 +707,7 @@ namespace Battle {
 
         if (GetState() == TileState::lava) {
           if (character.Hit(Hit::Properties({ 50, Hit::flash, Element::none, 0, Direction::none }))) {
-            field.AddEntity(std::make_shared<Explosion>(), GetX(), GetY());
+            field.SpawnPooled<Explosion>(*this);
             SetState(TileState::normal);
           }
         }
@@ -957,7 +978,7 @@ namespace Battle {
     if (isBattleOver) return;
 
     // Now that spells and characters have updated and moved, they are due to check for attack outcomes
-    std::vector<std::shared_ptr<Character>> characters_copy = characters; // may be modified after hitboxes are resolved
+    FrameVector<std::shared_ptr<Character>> characters_copy(characters.begin(), characters.end()); // may be modified after hitboxes are resolved
 
     for (std::shared_ptr<Character>& character : characters_copy) {
       // the entity is a character (can be hit) and the team isn't the same
@@ -1064,7 +1085,7 @@ namespace Battle {
 
   void Tile::UpdateSpells(Field& field, const double elapsed)
   {
-    vector<Entity*> spells_copy = spells;
+    FrameVector<Entity*> spells_copy(spells.begin(), spells.end());
     for (Entity* spell : spells_copy) {
       int request = (int)spell->GetTileHighlightMode();
 
@@ -1085,7 +1106,7 @@ namespace Battle {
 
   void Tile::UpdateArtifacts(Field& field, const double elapsed)
   {
-    vector<Artifact*> artifacts_copy = artifacts;
+    FrameVector<Artifact*> artifacts_copy(artifacts.begin(), artifacts.end());
     for (Artifact* artifact : artifacts_copy) {
       // artifacts are special effects and do not stop for TimeFreeze events
       field.UpdateEntityOnce(*artifact, elapsed);
@@ -1094,7 +1115,7 @@ namespace Battle {
 
   void Tile::UpdateCharacters(Field& field, const double elapsed)
   {
-    vector<std::shared_ptr<Character>> characters_copy = characters;
+    FrameVector<std::shared_ptr<Character>> characters_copy(characters.begin(), characters.end());
     for (std::shared_ptr<Character>& character : characters_copy) {
       if (!character->IsTimeFrozen()) {
         // Allow user input to move them out of tiles if they are frame perfect
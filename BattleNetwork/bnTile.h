@@ -104,6 +104,11 @@ namespace Battle {
 
     void PerspectiveFlip(bool state);
 
+    /**
+     * @brief The texture this tile would have after PerspectiveFlip(flipped), without changing the tile
+     */
+    const std::shared_ptr<sf::Texture> GetPerspectiveTexture(bool flipped) const;
+
     /**
      * @brief Change the tile's team if unoccupied
      * This will also change the color of the tile. 
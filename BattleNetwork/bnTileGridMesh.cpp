@@ -0,0 +1,200 @@
+#include "bnTileGridMesh.h"
+#include "bnTile.h"
+#include <algorithm>
+#include <cstring>
+
+void TileGridMesh::Submit(const Battle::Tile& tile, const sf::Vector2f& offset, const sf::Color& color, const sf::Shader* shader, bool perspectiveFlip, bool block)
+{
+  const size_t x = static_cast<size_t>(tile.GetX());
+  const size_t y = static_cast<size_t>(tile.GetY());
+
+  if (rows.size() <= y) {
+    rows.resize(y + 1u);
+  }
+
+  Row& row = rows[y];
+
+  if (row.slots.size() <= x) {
+    row.slots.resize(x + 1u);
+    row.dirty = true;
+  }
+
+  Slot& slot = row.slots[x];
+  slot.submitted = true;
+
+  const sf::Sprite& sprite = tile.getSpriteConst();
+  const sf::Texture* texture = tile.GetPerspectiveTexture(perspectiveFlip).get();
+  const bool visible = tile.IsVisible();
+
+  sf::Transform transform;
+  transform.translate(offset);
+  transform *= tile.getTransform();
+  transform *= sprite.getTransform();
+
+  std::array<float, 16> matrix;
+  std::memcpy(matrix.data(), transform.getMatrix(), sizeof(float) * matrix.size());
+
+  const sf::IntRect& rect = sprite.getTextureRect();
+
+  const bool changed = slot.tile != &tile
+    || slot.texture != texture
+    || slot.shader != shader
+    || slot.rect != rect
+    || slot.color != color
+    || slot.matrix != matrix
+    || slot.block != block
+    || slot.visible != visible;
+
+  if (!changed) return;
+
+  slot.tile = &tile;
+  slot.texture = texture;
+  slot.shader = shader;
+  slot.rect = rect;
+  slot.color = color;
+  slot.matrix = matrix;
+  slot.block = block;
+  slot.visible = visible;
+  slot.offset = offset;
+  slot.quad = MakeQuad(transform, sprite.getLocalBounds(), rect, color);
+
+  if (block) {
+    // same as a 40x30 rectangle scaled 2x centered on the tile
+    sf::Transform blockTransform;
+    blockTransform.translate(offset + tile.getPosition());
+    blockTransform.scale(2.f, 2.f);
+    blockTransform.translate(-20.f, -15.f);
+    slot.blockQuad = MakeQuad(blockTransform, sf::FloatRect(0.f, 0.f, 40.f, 30.f), sf::IntRect(), sf::Color::Yellow);
+  }
+
+  row.dirty = true;
+  rebakes++;
+}
+
+void TileGridMesh::Draw(sf::RenderTarget& target, sf::RenderStates states)
+{
+  drawCalls = 0;
+
+  for (Row& row : rows) {
+    for (Slot& slot : row.slots) {
+      if (slot.submitted != slot.wasSubmitted) {
+        row.dirty = true;
+      }
+
+      slot.wasSubmitted = slot.submitted;
+      slot.submitted = false;
+    }
+
+    if (row.dirty) {
+      Rebuild(row);
+    }
+
+    for (const Group& group : row.groups) {
+      if (group.vertices.empty()) continue;
+
+      sf::RenderStates groupStates = states;
+      groupStates.texture = group.texture;
+      groupStates.shader = group.shader;
+
+      target.draw(group.vertices.data(), group.vertices.size(), sf::Triangles, groupStates);
+      drawCalls++;
+    }
+
+    // child nodes are drawn the way SpriteProxyNode::draw() would draw them
+    for (const Slot& slot : row.slots) {
+      if (!slot.wasSubmitted || !slot.visible) continue;
+
+      const std::vector<std::shared_ptr<SceneNode>>& children = slot.tile->GetChildNodes();
+
+      if (children.empty()) continue;
+
+      sf::RenderStates childStates = states;
+      childStates.transform.translate(slot.offset);
+      childStates.transform *= slot.tile->getTransform();
+      childStates.shader = slot.shader;
+
+      for (const std::shared_ptr<SceneNode>& child : children) {
+        target.draw(*child, childStates);
+        drawCalls++;
+      }
+    }
+  }
+}
+
+void TileGridMesh::Clear()
+{
+  rows.clear();
+}
+
+const size_t TileGridMesh::DrawCalls() const
+{
+  return drawCalls;
+}
+
+const size_t TileGridMesh::Rebakes() const
+{
+  return rebakes;
+}
+
+TileGridMesh::Quad TileGridMesh::MakeQuad(const sf::Transform& transform, const sf::FloatRect& bounds, const sf::IntRect& rect, const sf::Color& color)
+{
+  const float left = static_cast<float>(rect.left);
+  const float right = left + static_cast<float>(rect.width);
+  const float top = static_cast<float>(rect.top);
+  const float bottom = top + static_cast<float>(rect.height);
+
+  const sf::Vertex topLeft(transform.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top));
+  const sf::Vertex bottomLeft(transform.transformPoint(0.f, bounds.height), color, sf::Vector2f(left, bottom));
+  const sf::Vertex topRight(transform.transformPoint(bounds.width, 0.f), color, sf::Vector2f(right, top));
+  const sf::Vertex bottomRight(transform.transformPoint(bounds.width, bounds.height), color, sf::Vector2f(right, bottom));
+
+  return Quad{ topLeft, bottomLeft, topRight, topRight, bottomLeft, bottomRight };
+}
+
+TileGridMesh::Group& TileGridMesh::FindGroup(std::vector<Group>& groups, const sf::Texture* texture, const sf::Shader* shader)
+{
+  auto iter = std::find_if(groups.begin(), groups.end(), [texture, shader](const Group& group) {
+    return group.texture == texture && group.shader == shader;
+  });
+
+  if (iter != groups.end()) {
+    return *iter;
+  }
+
+  groups.push_back(Group{ texture, shader, {} });
+  return groups.back();
+}
+
+void TileGridMesh::Rebuild(Row& row)
+{
+  // keep the groups and their capacity, only the vertices change
+  for (Group& group : row.groups) {
+    group.vertices.clear();
+  }
+
+  for (const Slot& slot : row.slots) {
+    if (!slot.wasSubmitted || !slot.visible) continue;
+
+    Group& group = FindGroup(row.groups, slot.texture, slot.shader);
+    group.vertices.insert(group.vertices.end(), slot.quad.begin(), slot.quad.end());
+  }
+
+  // blocks go on top of every tile in the row
+  std::vector<sf::Vertex> blocks;
+
+  for (const Slot& slot : row.slots) {
+    if (!slot.wasSubmitted || !slot.visible || !slot.block) continue;
+
+    blocks.insert(blocks.end(), slot.blockQuad.begin(), slot.blockQuad.end());
+  }
+
+  row.groups.erase(std::remove_if(row.groups.begin(), row.groups.end(), [](const Group& group) {
+    return group.vertices.empty();
+  }), row.groups.end());
+
+  if (!blocks.empty()) {
+    row.groups.push_back(Group{ nullptr, nullptr, std::move(blocks) });
+  }
+
+  row.dirty = false;
+}
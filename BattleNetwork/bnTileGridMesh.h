@@ -0,0 +1,91 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+
+namespace Battle {
+  class Tile;
+}
+
+/**
+ * @class TileGridMesh
+ * @brief Keeps the vertices of the battle grid baked between frames
+ *
+ * Each tile's quad is only rebuilt when what it looks like changes: texture, animation frame,
+ * colour, highlight or position. Tiles are grouped per row by texture and shader and every
+ * group is drawn with one call. Rows are drawn top to bottom because the front face of a tile
+ * overlaps the row behind it. Tiles in one row never overlap so their order inside the row does not matter.
+ *
+ * Tiles are submitted every frame and the camera offset is passed to Draw() as a render state,
+ * so nothing about the tiles is changed to draw them. Child nodes such as the volcano are drawn
+ * normally after the row their tile is in.
+ */
+class TileGridMesh {
+public:
+  /**
+   * @brief Queue a tile for the next Draw()
+   * @param tile the tile to draw
+   * @param offset added to the tile's position, e.g. the perspective flip offset
+   * @param color tint used instead of the tile's own color
+   * @param shader shader to draw this tile with, nullptr for none
+   * @param perspectiveFlip if true, draw the tile with the other team's colors
+   * @param block if true, cover the tile with a solid yellow block
+   */
+  void Submit(const Battle::Tile& tile, const sf::Vector2f& offset, const sf::Color& color, const sf::Shader* shader, bool perspectiveFlip, bool block);
+
+  /**
+   * @brief Draws every tile submitted since the last Draw()
+   */
+  void Draw(sf::RenderTarget& target, sf::RenderStates states);
+
+  /**
+   * @brief Forget all baked geometry, e.g. when the field is replaced
+   */
+  void Clear();
+
+  /**
+   * @brief Draw calls made by the last Draw()
+   */
+  const size_t DrawCalls() const;
+
+  /**
+   * @brief Number of times a tile quad had to be rebuilt since the mesh was created
+   */
+  const size_t Rebakes() const;
+
+private:
+  using Quad = std::array<sf::Vertex, 6>;
+
+  struct Slot {
+    const Battle::Tile* tile{ nullptr };
+    const sf::Texture* texture{ nullptr };
+    const sf::Shader* shader{ nullptr };
+    sf::IntRect rect;
+    sf::Color color;
+    std::array<float, 16> matrix{};
+    bool block{};
+    bool visible{};
+    bool submitted{}, wasSubmitted{};
+    sf::Vector2f offset;
+    Quad quad, blockQuad;
+  };
+
+  struct Group {
+    const sf::Texture* texture{ nullptr };
+    const sf::Shader* shader{ nullptr };
+    std::vector<sf::Vertex> vertices;
+  };
+
+  struct Row {
+    std::vector<Slot> slots;
+    std::vector<Group> groups; /*!< Tiles first, then yellow blocks */
+    bool dirty{ true };
+  };
+
+  std::vector<Row> rows;
+  size_t drawCalls{}, rebakes{};
+
+  static Quad MakeQuad(const sf::Transform& transform, const sf::FloatRect& bounds, const sf::IntRect& rect, const sf::Color& color);
+  static Group& FindGroup(std::vector<Group>& groups, const sf::Texture* texture, const sf::Shader* shader);
+  void Rebuild(Row& row);
+};
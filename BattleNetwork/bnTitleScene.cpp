@@ -232,4 +232,9 @@ void TitleScene::onTaskComplete(const std::string & taskName, float progress)
   taskStr = taskName;
 
   Logger::Logf(LogLevel::info, "[%.2f] Completed task %s", progress, taskName.c_str());
+}
+
+void TitleScene::onTaskProgress(const std::string& taskName, float progress)
+{
+  total = unsigned(progress * 100);
 }
\ No newline at end of file
@@ -46,4 +46,5 @@ public:
   void onEnd() override;
   void onTaskBegin(const std::string& taskName, float progress) override;
   void onTaskComplete(const std::string& taskName, float progress) override;
+  void onTaskProgress(const std::string& taskName, float progress) override;
 };
\ No newline at end of file
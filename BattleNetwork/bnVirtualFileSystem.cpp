@@ -0,0 +1,437 @@
+#include "bnVirtualFileSystem.h"
+#include "bnLogger.h"
+#include "bnPackageFingerprintIndex.h"
+#include "stx/crypto_utils.h"
+#include "zip/zip.h"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef __APPLE__
+  // TODO: mac os < 10.15 file system support
+  #include <filesystem>
+#endif
+
+class VirtualFileSystem::Source {
+public:
+  virtual ~Source() = default;
+
+  /**
+   * @param relative normalized path relative to the mount point
+   */
+  virtual bool Read(const std::string& relative, std::vector<char>& data) = 0;
+  virtual const bool Exists(const std::string& relative) = 0;
+
+  /**
+   * @brief Normalized relative paths of every file
+   */
+  virtual std::vector<std::string> List() = 0;
+
+  virtual stx::result_t<std::string> Fingerprint() = 0;
+
+  /**
+   * @brief The archive itself. Folders have none
+   */
+  virtual bool ReadArchive(std::vector<char>& data) = 0;
+
+  /**
+   * @brief True if nothing backs the files on disk
+   */
+  virtual const bool InMemory() const = 0;
+};
+
+namespace {
+  /**
+   * @brief Serves the entries of a zip file or of a zip held in memory
+   *
+   * The entry index is built once when mounted. A miniz reader can only extract one
+   * entry at a time, so reads share the archive handle under a lock. Entries are
+   * extracted straight into the caller's buffer, and stored entries are copied
+   * without going through the inflater.
+   */
+  class ZipSource : public VirtualFileSystem::Source {
+    struct Entry {
+      int index{};
+      size_t size{};
+    };
+
+    std::mutex mutex;
+    struct zip_t* zip{ nullptr };
+    std::string zipPath; /*!< Empty if the zip is held in memory */
+    std::vector<char> zipData;
+    std::unordered_map<std::string, Entry> entries;
+
+  public:
+    ZipSource(const std::string& path) : zipPath(path) {
+      zip = zip_open(path.c_str(), 0, 'r');
+      Index();
+    }
+
+    ZipSource(std::vector<char>&& data) : zipData(std::move(data)) {
+      zip = zip_stream_open(zipData.data(), zipData.size(), 0, 'r');
+      Index();
+    }
+
+    ~ZipSource() {
+      if (!zip) return;
+
+      if (zipPath.empty()) {
+        zip_stream_close(zip);
+      }
+      else {
+        zip_close(zip);
+      }
+    }
+
+    const bool IsOpen() const {
+      return zip != nullptr;
+    }
+
+    bool Read(const std::string& relative, std::vector<char>& data) override {
+      auto iter = entries.find(relative);
+
+      if (iter == entries.end()) {
+        return false;
+      }
+
+      data.resize(iter->second.size);
+
+      std::scoped_lock lock(mutex);
+
+      if (zip_entry_openbyindex(zip, iter->second.index) != 0) {
+        return false;
+      }
+
+      ssize_t read = data.empty() ? 0 : zip_entry_noallocread(zip, data.data(), data.size());
+      zip_entry_close(zip);
+
+      return read == static_cast<ssize_t>(data.size());
+    }
+
+    const bool Exists(const std::string& relative) override {
+      return entries.find(relative) != entries.end();
+    }
+
+    std::vector<std::string> List() override {
+      std::vector<std::string> names;
+      names.reserve(entries.size());
+
+      for (auto& [name, entry] : entries) {
+        names.push_back(name);
+      }
+
+      std::sort(names.begin(), names.end());
+      return names;
+    }
+
+    stx::result_t<std::string> Fingerprint() override {
+      if (zipPath.empty()) {
+        return stx::generate_md5_from_buffer(zipData.data(), zipData.size());
+      }
+
+      return stx::generate_md5_from_file(zipPath);
+    }
+
+    bool ReadArchive(std::vector<char>& data) override {
+      if (zipPath.empty()) {
+        data = zipData;
+        return true;
+      }
+
+      std::ifstream fs(zipPath, std::ios::binary | std::ios::ate);
+
+      if (!fs.good()) {
+        return false;
+      }
+
+      data.resize(static_cast<size_t>(fs.tellg()));
+      fs.seekg(0, std::ios::beg);
+      fs.read(data.data(), data.size());
+      return !fs.bad();
+    }
+
+    const bool InMemory() const override {
+      return zipPath.empty();
+    }
+
+  private:
+    // entries never change after this so reads can look them up without the lock
+    void Index() {
+      if (!zip) return;
+
+      int n = static_cast<int>(zip_entries_total(zip));
+
+      for (int i = 0; i < n; ++i) {
+        if (zip_entry_openbyindex(zip, i) != 0) continue;
+
+        const char* name = zip_entry_name(zip);
+
+        if (name && zip_entry_isdir(zip) != 1) {
+          entries[VirtualFileSystem::Normalize(name)] = Entry{ i, static_cast<size_t>(zip_entry_size(zip)) };
+        }
+
+        zip_entry_close(zip);
+      }
+    }
+  };
+
+  class DirectorySource : public VirtualFileSystem::Source {
+    std::string directory;
+
+  public:
+    DirectorySource(const std::string& directory) : directory(directory) {}
+
+    bool Read(const std::string& relative, std::vector<char>& data) override {
+      std::ifstream fs(directory + "/" + relative, std::ios::binary | std::ios::ate);
+
+      if (!fs.good()) {
+        return false;
+      }
+
+      data.resize(static_cast<size_t>(fs.tellg()));
+      fs.seekg(0, std::ios::beg);
+      fs.read(data.data(), data.size());
+      return !fs.bad();
+    }
+
+    const bool Exists(const std::string& relative) override {
+#ifndef __APPLE__
+      std::error_code ec;
+      return std::filesystem::is_regular_file(directory + "/" + relative, ec);
+#else
+      return std::ifstream(directory + "/" + relative).good();
+#endif
+    }
+
+    std::vector<std::string> List() override {
+      std::vector<std::string> names;
+
+#ifndef __APPLE__
+      std::error_code ec;
+      std::filesystem::recursive_directory_iterator iter(directory, ec), end;
+
+      for (; !ec && iter != end; iter.increment(ec)) {
+        if (!iter->is_regular_file(ec)) continue;
+
+        names.push_back(iter->path().lexically_relative(directory).generic_string());
+      }
+
+      std::sort(names.begin(), names.end());
+#endif
+
+      return names;
+    }
+
+    stx::result_t<std::string> Fingerprint() override {
+      return PackageFingerprintIndex::Instance().Fingerprint(directory);
+    }
+
+    bool ReadArchive(std::vector<char>& data) override {
+      return false;
+    }
+
+    const bool InMemory() const override {
+      return false;
+    }
+  };
+}
+
+VirtualFileSystem& VirtualFileSystem::Instance()
+{
+  static VirtualFileSystem vfs;
+  return vfs;
+}
+
+stx::result_t<bool> VirtualFileSystem::MountZip(const std::string& mountPoint, const std::string& zipPath)
+{
+  auto source = std::make_shared<ZipSource>(zipPath);
+
+  if (!source->IsOpen()) {
+    return stx::error<bool>("Unable to open " + zipPath);
+  }
+
+  return Mount(mountPoint, source);
+}
+
+stx::result_t<bool> VirtualFileSystem::MountZip(const std::string& mountPoint, std::vector<char>&& zipData)
+{
+  auto source = std::make_shared<ZipSource>(std::move(zipData));
+
+  if (!source->IsOpen()) {
+    return stx::error<bool>("Unable to read zip mounted at " + mountPoint);
+  }
+
+  return Mount(mountPoint, source);
+}
+
+stx::result_t<bool> VirtualFileSystem::MountDirectory(const std::string& mountPoint, const std::string& directory)
+{
+  return Mount(mountPoint, std::make_shared<DirectorySource>(Normalize(directory)));
+}
+
+stx::result_t<bool> VirtualFileSystem::Mount(const std::string& mountPoint, std::shared_ptr<Source> source)
+{
+  std::string key = Normalize(mountPoint);
+
+  std::unique_lock lock(mutex);
+
+  if (!mounts.emplace(key, std::move(source)).second) {
+    return stx::error<bool>("Something is already mounted at " + key);
+  }
+
+  mountCount = mounts.size();
+  generation++;
+  Logger::Logf(LogLevel::debug, "Mounted %s", key.c_str());
+  return stx::ok();
+}
+
+bool VirtualFileSystem::Unmount(const std::string& mountPoint)
+{
+  std::unique_lock lock(mutex);
+
+  // sources are shared so a read in progress keeps its source alive
+  bool removed = mounts.erase(Normalize(mountPoint)) > 0;
+  mountCount = mounts.size();
+
+  if (removed) {
+    generation++;
+  }
+
+  return removed;
+}
+
+const size_t VirtualFileSystem::Generation() const
+{
+  return generation;
+}
+
+const bool VirtualFileSystem::IsMounted(const std::string& mountPoint)
+{
+  if (mountCount == 0) return false;
+
+  std::shared_lock lock(mutex);
+  return mounts.find(Normalize(mountPoint)) != mounts.end();
+}
+
+const bool VirtualFileSystem::Exists(const std::string& path)
+{
+  std::string relative;
+  std::shared_ptr<Source> source = Resolve(path, relative);
+  return source && source->Exists(relative);
+}
+
+bool VirtualFileSystem::Read(const std::string& path, std::vector<char>& data)
+{
+  std::string relative;
+  std::shared_ptr<Source> source = Resolve(path, relative);
+  return source && source->Read(relative, data);
+}
+
+std::vector<std::string> VirtualFileSystem::List(const std::string& mountPoint)
+{
+  std::string key = Normalize(mountPoint);
+  std::shared_ptr<Source> source;
+
+  {
+    std::shared_lock lock(mutex);
+    auto iter = mounts.find(key);
+
+    if (iter == mounts.end()) {
+      return {};
+    }
+
+    source = iter->second;
+  }
+
+  std::vector<std::string> paths = source->List();
+
+  for (std::string& path : paths) {
+    path = key + "/" + path;
+  }
+
+  return paths;
+}
+
+stx::result_t<std::string> VirtualFileSystem::Fingerprint(const std::string& mountPoint)
+{
+  std::shared_ptr<Source> source;
+
+  {
+    std::shared_lock lock(mutex);
+    auto iter = mounts.find(Normalize(mountPoint));
+
+    if (iter == mounts.end()) {
+      return stx::error<std::string>("Nothing is mounted at " + mountPoint);
+    }
+
+    source = iter->second;
+  }
+
+  return source->Fingerprint();
+}
+
+const bool VirtualFileSystem::IsInMemory(const std::string& path)
+{
+  std::string relative;
+  std::shared_ptr<Source> source = Resolve(path, relative);
+  return source && source->InMemory();
+}
+
+bool VirtualFileSystem::ReadArchive(const std::string& mountPoint, std::vector<char>& data)
+{
+  std::shared_ptr<Source> source;
+
+  {
+    std::shared_lock lock(mutex);
+    auto iter = mounts.find(Normalize(mountPoint));
+
+    if (iter == mounts.end()) {
+      return false;
+    }
+
+    source = iter->second;
+  }
+
+  return source->ReadArchive(data);
+}
+
+std::string VirtualFileSystem::Normalize(const std::string& path)
+{
+#ifndef __APPLE__
+  std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+#else
+  std::string normalized = path;
+  std::replace(normalized.begin(), normalized.end(), '\\', '/');
+#endif
+
+  // "a/b/" and "a/b" name the same mount
+  while (normalized.size() > 1 && normalized.back() == '/') {
+    normalized.pop_back();
+  }
+
+  return normalized;
+}
+
+std::shared_ptr<VirtualFileSystem::Source> VirtualFileSystem::Resolve(const std::string& path, std::string& relative)
+{
+  // keeps plain disk reads free while nothing is mounted
+  if (mountCount == 0) return nullptr;
+
+  std::string normalized = Normalize(path);
+
+  std::shared_lock lock(mutex);
+
+  // walk up the parent folders, the first one that is mounted is the deepest mount
+  for (size_t end = normalized.rfind('/'); end != std::string::npos && end > 0; end = normalized.rfind('/', end - 1)) {
+    auto iter = mounts.find(normalized.substr(0, end));
+
+    if (iter != mounts.end()) {
+      relative = normalized.substr(end + 1);
+      return iter->second;
+    }
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "stx/result.h"
+
+/**
+ * @class VirtualFileSystem
+ * @brief Serves files from zip archives and folders mounted over a path
+ *
+ * A mount makes every file of an archive appear under the mount point, e.g. a package
+ * zip mounted at "resources/mods/cards/sword" serves "resources/mods/cards/sword/entry.lua"
+ * without extracting anything to disk. Loaders for text, textures, audio and Lua scripts
+ * ask the file system first and fall back to the disk for paths outside of every mount.
+ *
+ * Lookups are thread safe. While nothing is mounted they return immediately.
+ */
+class VirtualFileSystem {
+public:
+  class Source;
+
+  static VirtualFileSystem& Instance();
+
+  /**
+   * @brief Mounts a zip file. Entries are read from the file when requested.
+   */
+  stx::result_t<bool> MountZip(const std::string& mountPoint, const std::string& zipPath);
+
+  /**
+   * @brief Mounts a zip held in memory. No file is needed on disk.
+   */
+  stx::result_t<bool> MountZip(const std::string& mountPoint, std::vector<char>&& zipData);
+
+  /**
+   * @brief Mounts a folder under another path
+   */
+  stx::result_t<bool> MountDirectory(const std::string& mountPoint, const std::string& directory);
+
+  /**
+   * @return false if nothing was mounted at mountPoint
+   */
+  bool Unmount(const std::string& mountPoint);
+
+  const bool IsMounted(const std::string& mountPoint);
+
+  /**
+   * @return true if path is inside a mount that has the file
+   */
+  const bool Exists(const std::string& path);
+
+  /**
+   * @return true if path is inside a zip mounted from memory
+   */
+  const bool IsInMemory(const std::string& path);
+
+  /**
+   * @brief Reads a whole file from a mount
+   * @return false if path is not inside a mount or the mount does not have the file
+   */
+  bool Read(const std::string& path, std::vector<char>& data);
+
+  /**
+   * @brief Paths of every file under the mount point, spelled as they would be requested
+   */
+  std::vector<std::string> List(const std::string& mountPoint);
+
+  /**
+   * @brief MD5 of the mounted zip, or the package fingerprint of a mounted folder
+   */
+  stx::result_t<std::string> Fingerprint(const std::string& mountPoint);
+
+  /**
+   * @brief Reads the whole zip mounted at mountPoint, as it was given to MountZip
+   * @return false if nothing is mounted there or the mount is a folder
+   */
+  bool ReadArchive(const std::string& mountPoint, std::vector<char>& data);
+
+  /**
+   * @brief Changes every time a mount is added or removed
+   *
+   * Caches of files read through the file system keep the generation they read them in.
+   * While it is unchanged, every path still resolves to the same file.
+   */
+  const size_t Generation() const;
+
+  /**
+   * @brief Spells a path the way mount points are stored: generic separators and no "." or ".."
+   */
+  static std::string Normalize(const std::string& path);
+
+private:
+  std::shared_mutex mutex;
+  std::map<std::string, std::shared_ptr<Source>> mounts; /*!< Normalized mount point to source */
+  std::atomic<size_t> mountCount{ 0 };
+  std::atomic<size_t> generation{ 0 };
+
+  stx::result_t<bool> Mount(const std::string& mountPoint, std::shared_ptr<Source> source);
+
+  /**
+   * @brief Finds the deepest mount that contains path
+   * @param relative set to path relative to the mount point
+   */
+  std::shared_ptr<Source> Resolve(const std::string& path, std::string& relative);
+};
@@ -0,0 +1,81 @@
+#include "bnWorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool() :
+  WorkerPool(std::clamp(std::thread::hardware_concurrency(), 2u, MAX_WORKERS + 1u) - 1u)
+{
+}
+
+WorkerPool::WorkerPool(unsigned workers)
+{
+  workers = std::max(workers, 1u);
+
+  for (unsigned i = 0; i < workers; i++) {
+    this->workers.emplace_back(&WorkerPool::Work, this);
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::scoped_lock lock(mutex);
+    stopping = true;
+  }
+
+  wake.notify_all();
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+std::shared_future<void> WorkerPool::Submit(std::function<void()> job)
+{
+  std::packaged_task<void()> task(std::move(job));
+  std::shared_future<void> result = task.get_future().share();
+
+  {
+    std::scoped_lock lock(mutex);
+    jobs.push_back(std::move(task));
+  }
+
+  wake.notify_one();
+  return result;
+}
+
+const size_t WorkerPool::Queued() const
+{
+  std::scoped_lock lock(mutex);
+  return jobs.size();
+}
+
+const size_t WorkerPool::WorkerCount() const
+{
+  return workers.size();
+}
+
+WorkerPool& WorkerPool::Instance()
+{
+  static WorkerPool pool;
+  return pool;
+}
+
+void WorkerPool::Work()
+{
+  while (true) {
+    std::packaged_task<void()> job;
+
+    {
+      std::unique_lock lock(mutex);
+      wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+
+      // queued jobs are dropped on shutdown. Their futures report a broken promise
+      if (stopping) return;
+
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+
+    job();
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkerPool
+ * @brief A few background threads for work that must not stall a frame, such as decoding files
+ *
+ * Jobs run in the order they were submitted. Jobs must not touch OpenGL:
+ * anything that needs the GPU has to be finished on the render thread.
+ */
+class WorkerPool {
+public:
+  static constexpr unsigned MAX_WORKERS = 4;
+
+  /**
+   * @brief Starts one worker per spare hardware thread, at least one and at most MAX_WORKERS
+   */
+  WorkerPool();
+  explicit WorkerPool(unsigned workers);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * @brief Queues a job
+   * @return becomes ready once the job has run. Exceptions thrown by the job are rethrown by get()
+   */
+  std::shared_future<void> Submit(std::function<void()> job);
+
+  /**
+   * @brief Number of jobs that have not started yet
+   */
+  const size_t Queued() const;
+
+  const size_t WorkerCount() const;
+
+  /**
+   * @brief Pool shared by the resource managers
+   */
+  static WorkerPool& Instance();
+
+private:
+  mutable std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<std::packaged_task<void()>> jobs;
+  std::vector<std::thread> workers;
+  bool stopping{ false };
+
+  void Work();
+};
@@ -54,6 +54,8 @@ int main(int argc, char** argv) {
     ("e,errorLevel", "Set the level to filter error messages [silent|info|warning|critical|debug] (default is `critical`)", cxxopts::value<std::string>()->default_value("warning|critical"))
     ("d,debug", "Enable debugging")
     ("s,singlethreaded", "run logic and draw routines in a single, main thread")
+    ("noluacache", "always compile package scripts from source instead of reusing cached bytecode")
+    ("sharedlua", "run the packages of each namespace in this many shared Lua states instead of one state each (0 is off)", cxxopts::value<int>()->default_value("0"))
     ("l,locale", "set flair and language to desired target", cxxopts::value<std::string>()->default_value("en"))
     ("p,port", "port for PVP", cxxopts::value<int>()->default_value("0"))
     ("r,remotePort", "remote port for main hub", cxxopts::value<int>()->default_value(std::to_string(NetPlayConfig::OBN_PORT)))
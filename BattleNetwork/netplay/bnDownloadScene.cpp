@@ -10,6 +10,8 @@
 #include "../bnCardPackageManager.h"
 #include "../bnBlockPackageManager.h"
 #include "../bnLuaLibraryPackageManager.h"
+#include "../bnPackageFingerprintIndex.h"
+#include "../bnVirtualFileSystem.h"
 #include "../bindings/bnScriptedCard.h"
 #include "../bindings/bnScriptedBlock.h"
 #include "../bnRandom.h"
@@ -534,23 +536,18 @@ void DownloadScene::DownloadPlayerData(const Poco::Buffer<char>& buffer)
   RemoveFromDownloadList(packageId);
 
   size_t file_len = reader.Read<uint32_t>(buffer);
-  std::string path = "cache/" + stx::rand_alphanum(12) + ".zip";
+  size_t offset = reader.GetOffset();
 
-  std::fstream file;
-  file.open(path, std::ios::out | std::ios::binary);
+  // the package is mounted from memory so downloads leave nothing behind in the cache folder
+  std::string path = std::string(CACHE_FOLDER) + "/" + stx::rand_alphanum(12);
 
-  stx::result_t<std::string> result(std::nullptr_t{}, "Unset");
+  stx::result_t<std::string> result(std::nullptr_t{}, "Package data is incomplete");
 
-  if (file.is_open()) {
-    while (file_len > 0) {
-      char byte = reader.Read<char>(buffer);
-      file << byte;
-      file_len--;
-    }
-
-    file.close();
+  if (offset + file_len <= buffer.size()) {
+    std::vector<char> zipData(buffer.begin() + offset, buffer.begin() + offset + file_len);
+    reader.Skip(file_len);
 
-    result = RemotePlayerPartition().LoadPackageFromZip<ScriptedPlayer>(path);
+    result = RemotePlayerPartition().LoadPackageFromMemory<ScriptedPlayer>(path, std::move(zipData));
   }
   
   if (result.is_error()) {
@@ -639,23 +636,18 @@ void DownloadScene::DownloadPackageData(const Poco::Buffer<char>& buffer, Packag
   RemoveFromDownloadList(packageId);
 
   size_t file_len = reader.Read<uint32_t>(buffer);
-  std::string path = "cache/" + stx::rand_alphanum(12) + ".zip";
+  size_t offset = reader.GetOffset();
 
-  std::fstream file;
-  file.open(path, std::ios::out | std::ios::binary);
+  // the package is mounted from memory so downloads leave nothing behind in the cache folder
+  std::string path = std::string(CACHE_FOLDER) + "/" + stx::rand_alphanum(12);
 
-  stx::result_t<std::string> result(std::nullptr_t{}, "Unset");
-
-  if (file.is_open()) {
-    while (file_len > 0) {
-      char byte = reader.Read<char>(buffer);
-      file << byte;
-      file_len--;
-    }
+  stx::result_t<std::string> result(std::nullptr_t{}, "Package data is incomplete");
 
-    file.close();
+  if (offset + file_len <= buffer.size()) {
+    std::vector<char> zipData(buffer.begin() + offset, buffer.begin() + offset + file_len);
+    reader.Skip(file_len);
 
-    result = pm.template LoadPackageFromZip<ScriptedDataType>(path);
+    result = pm.template LoadPackageFromMemory<ScriptedDataType>(path, std::move(zipData));
   }
 
   if (result.is_error()) {
@@ -684,16 +676,40 @@ Poco::Buffer<char> DownloadScene::SerializePackageData(const std::string& packag
   }
   else {
     std::string path = result.value();
-    
-    if (auto result = stx::zip(path, path + ".zip"); result.value()) {
+    VirtualFileSystem& vfs = VirtualFileSystem::Instance();
+
+    if (vfs.IsMounted(path)) {
+      // zipped and downloaded packages have no folder, send the archive they were mounted from
+      if (!vfs.ReadArchive(path, fileBuffer)) {
+        fileBuffer.clear();
+      }
+    }
+    // the zip made at install is reused unless the package folder changed since
+    else if (auto result = PackageFingerprintIndex::Instance().Fingerprint(path); !result.is_error()) {
+      // the folder may have been re-zipped, keep the new fingerprint even if the game does not exit cleanly
+      PackageFingerprintIndex::Instance().Save();
       path = path + ".zip";
 
       std::ifstream fs(path, std::ios::binary | std::ios::ate);
-      std::ifstream::pos_type pos = fs.tellg();
-      len = pos;
-      fileBuffer.resize(len);
-      fs.seekg(0, std::ios::beg);
-      fs.read(&fileBuffer[0], pos);
+
+      if (fs.good()) {
+        fileBuffer.resize(static_cast<size_t>(fs.tellg()));
+        fs.seekg(0, std::ios::beg);
+        fs.read(fileBuffer.data(), fileBuffer.size());
+
+        if (fs.bad()) {
+          fileBuffer.clear();
+        }
+      }
+    }
+
+    len = fileBuffer.size();
+
+    if (len == 0) {
+      Logger::Logf(LogLevel::critical, "Could not serialize package %s from %s", packageId.c_str(), path.c_str());
+
+      // Give the remote client a headsup abort
+      SendDownloadComplete(false);
     }
   }
 
@@ -3,6 +3,7 @@
 #include "bnOverworldTileType.h"
 #include "../bnTextureResourceManager.h"
 #include "../bnShaderResourceManager.h"
+#include "../bnRenderTargetPool.h"
 #include "../bnMath.h"
 #include "../stx/string.h"
 
@@ -37,8 +38,6 @@ void Overworld::Minimap::Update(const std::string& name, Map& map)
 {
   this->name = name;
 
-  // prepare a render texture to write to
-  sf::RenderTexture texture;
   sf::RenderStates states;
 
   const auto screenSize = sf::Vector2i{ 240, 160 };
@@ -66,7 +65,13 @@ void Overworld::Minimap::Update(const std::string& name, Map& map)
   // texture does not fit on screen, allow large map controls
   largeMapControls = textureSize.x > screenSize.x || textureSize.y > screenSize.y;
 
-  if (!texture.create(textureSize.x, textureSize.y)) return;
+  // prepare a render texture to write to
+  RenderTargetPool& pool = RenderTargetPool::Instance();
+  RenderTargetPool::Lease layers = pool.Acquire(sf::Vector2u(textureSize));
+
+  if (!layers) return;
+
+  sf::RenderTexture& texture = layers.Get();
 
   // fill with background color
   texture.clear(sf::Color(0,0,0,0));
@@ -134,23 +139,27 @@ void Overworld::Minimap::Update(const std::string& name, Map& map)
     states.transform.translate(0.f, -tileSize.y * 0.5f);
   }
 
-  // Grab image data to make a texture
-    // NOTE: gpu <-> cpu is a costly process. do this sparringly.
   texture.display();
-  sf::Texture tempTex = texture.getTexture();
-  sf::Sprite temp(tempTex);
 
-  // do a second pass for edge detection
+  RenderTargetPool::Lease edges = pool.Acquire(sf::Vector2u(textureSize));
+
+  if (!edges) return;
+
+  sf::Sprite temp(texture.getTexture());
+
+  // do a second pass for edge detection on top of the layers
+  edges->draw(temp);
+
   states.shader = handle.Shaders().GetShader(ShaderType::MINIMAP_EDGE);
   states.transform = sf::Transform::Identity;
   states.shader->setUniform("resolutionW", (float)textureSize.x);
   states.shader->setUniform("resolutionH", (float)textureSize.y);
-  texture.draw(temp, states);
+  edges->draw(temp, states);
 
-  texture.display();
+  edges->display();
 
-  // set the final texture
-  bakedMap.setTexture(std::make_shared<sf::Texture>(texture.getTexture()));
+  // set the final texture. The pooled targets are reused by the next map
+  bakedMap.setTexture(std::make_shared<sf::Texture>(edges->getTexture()));
 
   FindMapMarkers(map);
 }
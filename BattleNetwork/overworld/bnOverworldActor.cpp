@@ -454,8 +454,8 @@ const std::pair<bool, sf::Vector3f> Overworld::Actor::CanMoveTo(sf::Vector2f new
   * If we can move forward, check neighboring actors
   */
   if (solid) {
-    for (const auto& actor : spatialMap.GetNeighbors(*this)) {
-      if (actor.get() == this || !actor->solid) continue;
+    for (Actor* actor : spatialMap.GetNeighbors(*this)) {
+      if (actor == this || !actor->solid) continue;
 
       auto elevationDifference = std::fabs(actor->GetElevation() - newPos3D.z);
 
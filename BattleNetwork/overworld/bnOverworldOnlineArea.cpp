@@ -26,6 +26,7 @@
 #include "../bnMessageQuestion.h"
 #include "../bnPlayerCustScene.h"
 #include "../bnSelectNaviScene.h"
+#include "../bnBattlePreloader.h"
 #include "../battlescene/bnMobBattleScene.h"
 #include "../battlescene/bnFreedomMissionMobScene.h"
 #include "../netplay/bnBufferWriter.h"
@@ -2346,6 +2347,15 @@ void Overworld::OnlineArea::receivePVPSignal(BufferReader& reader, const Poco::B
     spawnOrder[1].x = 5;
     spawnOrder[1].y = 2;
 
+    // Decode the battle assets while the transition plays
+    BattlePreloader preloader;
+    preloader.AddPackage(meta.GetFilePath());
+    preloader.AddPackage(remoteMeta.GetFilePath());
+    preloader.AddFolder(*folder, getController().CardPackagePartitioner());
+    preloader.AddBlocks(localNaviBlocks, blockPartition);
+    preloader.AddBlocks(remoteNaviBlocks, blockPartition);
+    preloader.Start();
+
     NetworkBattleSceneProps props = {
       { player, GetProgramAdvance(), std::move(folder), std::make_shared<Field>(6, 3), GetBackground() },
       sf::Sprite(*mugshot),
@@ -2484,6 +2494,7 @@ void Overworld::OnlineArea::receiveMobSignal(BufferReader& reader, const Poco::B
   Logger::Logf(LogLevel::debug, "Battling server mob %s", packageId.c_str());
 
   MobMeta& mobMeta = mobPackages.FindPackageByID(packageId);
+  std::string mobPackagePath = mobMeta.GetFilePath();
 
   std::unique_ptr<MobFactory> mobFactory = std::unique_ptr<MobFactory>(mobMeta.GetData());
   Mob* mob = mobFactory->Build(std::make_shared<Field>(6, 3), GetText(data_path));
@@ -2536,6 +2547,14 @@ void Overworld::OnlineArea::receiveMobSignal(BufferReader& reader, const Poco::B
       localNaviBlocks.push_back(addr.packageId);
     }
 
+    // Decode the battle assets while the transition and intro play
+    BattlePreloader preloader;
+    preloader.AddPackage(playerMeta.GetFilePath());
+    preloader.AddPackage(mobPackagePath);
+    preloader.AddFolder(*folder, getController().CardPackagePartitioner());
+    preloader.AddBlocks(localNaviBlocksAddr, getController().BlockPackagePartitioner());
+    preloader.Start();
+
     BattleResultsFunc callback = [this](const BattleResults& results) {
       sendBattleResultsSignal(results);
     };
@@ -181,6 +181,8 @@ void Overworld::SceneBase::onUpdate(double elapsed) {
     return; // keep the screen looking the same when we come back
 #endif
 
+  particles.Update(elapsed);
+
   auto layerCount = map.GetLayerCount() + 1;
 
   if (spriteLayers.size() != layerCount) {
@@ -374,6 +376,11 @@ void Overworld::SceneBase::DrawWorld(sf::RenderTarget& target, sf::RenderStates
   auto tileSize = map.GetTileSize();
   auto mapLayerCount = map.GetLayerCount();
 
+  // particles are placed in map space before the layers shift the transform
+  sf::RenderStates particleStates = states;
+
+  worldBatch.Begin(target);
+
   // there should be mapLayerCount + 1 sprite layers
   for (auto i = 0; i < mapLayerCount + 1; i++) {
 
@@ -391,6 +398,10 @@ void Overworld::SceneBase::DrawWorld(sf::RenderTarget& target, sf::RenderStates
     // translate next layer
     states.transform.translate(0.f, -tileSize.y * 0.5f);
   }
+
+  worldBatch.End();
+
+  particles.Draw(target, particleStates);
 }
 
 void Overworld::SceneBase::DrawMapLayer(sf::RenderTarget& target, sf::RenderStates states, size_t index, size_t maxLayers) {
@@ -465,7 +476,7 @@ void Overworld::SceneBase::DrawMapLayer(sf::RenderTarget& target, sf::RenderStat
 
         tileSprite.setColor(sf::Color(r, g, b, originalColor.a));
       }
-      target.draw(tileSprite, states);
+      worldBatch.DrawSprite(tileSprite, states);
       tileSprite.setColor(originalColor);
 
       tileSprite.setOrigin(originalOrigin);
@@ -490,7 +501,13 @@ void Overworld::SceneBase::DrawSpriteLayer(sf::RenderTarget& target, sf::RenderS
     screenPos.x = std::floor(screenPos.x);
     screenPos.y = std::floor(screenPos.y);
 
-    sprite->setPosition(screenPos);
+    // draw at the screen position without moving the sprite
+    sf::RenderStates spriteStates = states;
+    spriteStates.transform *= sprite->GetPreTransform();
+
+    sf::Transform spriteTransform;
+    spriteTransform.translate(screenPos - worldPos);
+    spriteTransform *= sprite->getTransform();
 
     sf::Vector2i gridPos = sf::Vector2i(map.WorldToTileSpace(worldPos));
 
@@ -507,11 +524,9 @@ void Overworld::SceneBase::DrawSpriteLayer(sf::RenderTarget& target, sf::RenderS
         sprite->setColor(sf::Color(r, g, b, originalColor.a));
       }
 
-      target.draw(*sprite, states);
+      worldBatch.DrawNode(*sprite, spriteStates, spriteTransform);
       sprite->setColor(originalColor);
     }
-
-    sprite->setPosition(worldPos);
   }
 }
 
@@ -918,6 +933,11 @@ Overworld::Map& Overworld::SceneBase::GetMap()
   return map;
 }
 
+ParticleSystem& Overworld::SceneBase::GetParticles()
+{
+  return particles;
+}
+
 std::shared_ptr<Overworld::PlayerSession>& Overworld::SceneBase::GetPlayerSession()
 {
   return playerSession;
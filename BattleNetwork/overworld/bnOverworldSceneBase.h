@@ -20,6 +20,8 @@
 #include "../bnCardFolderCollection.h"
 #include "../bnKeyItemScene.h"
 #include "../bnInbox.h"
+#include "../bnSpriteBatch.h"
+#include "../bnParticleSystem.h"
 
 // overworld
 #include "bnOverworldPlayerSession.h"
@@ -73,6 +75,8 @@ namespace Overworld {
     Overworld::Map map; /*!< Overworld map */
     std::vector<std::shared_ptr<WorldSprite>> sprites;
     std::vector<std::vector<std::shared_ptr<WorldSprite>>> spriteLayers;
+    SpriteBatch worldBatch; /*!< Draws map tiles and world sprites in as few draw calls as possible */
+    ParticleSystem particles; /*!< Visual only effects drawn above every map layer */
     Overworld::MenuSystem menuSystem;
 
     /*!< Current player package selection */
@@ -247,6 +251,13 @@ namespace Overworld {
     Camera& GetCamera();
     sf::Transformable& GetWorldTransform();
     Map& GetMap();
+
+    /**
+     * @brief Visual only particles drawn above the map
+     *
+     * Emit positions are in the same space as Map::WorldToScreen() at elevation 0
+     */
+    ParticleSystem& GetParticles();
     std::shared_ptr<PlayerSession>& GetPlayerSession();
     std::shared_ptr<Actor> GetPlayer();
     PlayerController& GetPlayerController();
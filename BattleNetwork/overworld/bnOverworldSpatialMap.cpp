@@ -27,13 +27,13 @@ namespace Overworld {
     return (y << (sizeof(size_t) / 2)) + x;
   }
 
-  std::vector<std::shared_ptr<Actor>> SpatialMap::GetChunk(float x, float y) {
+  const std::vector<std::shared_ptr<Actor>>& SpatialMap::GetChunk(float x, float y) {
     auto chunkHash = GetHash((size_t)(x / chunkLength), (size_t)(y / chunkLength));
 
     auto it = chunks.find(chunkHash);
 
     if (it == chunks.end()) {
-      return {};
+      return emptyChunk;
     }
 
     return it->second;
@@ -63,8 +63,8 @@ namespace Overworld {
     }
   };
 
-  std::unordered_set<std::shared_ptr<Actor>> SpatialMap::GetNeighbors(Actor& actor) {
-    std::unordered_set<std::shared_ptr<Actor>> neighbors;
+  FrameVector<Actor*> SpatialMap::GetNeighbors(Actor& actor) {
+    FrameVector<Actor*> neighbors;
     auto actorPtr = &actor;
     auto endIt = chunks.end();
 
@@ -78,8 +78,9 @@ namespace Overworld {
       auto& chunk = it->second;
 
       for (auto& other : chunk) {
-        if (actorPtr != other.get()) {
-          neighbors.emplace(other);
+        // actors spanning several chunks must only be reported once
+        if (actorPtr != other.get() && std::find(neighbors.begin(), neighbors.end(), other.get()) == neighbors.end()) {
+          neighbors.push_back(other.get());
         }
       }
     });
@@ -88,7 +89,9 @@ namespace Overworld {
   }
 
   void SpatialMap::Update() {
-    chunks.clear();
+    for (auto& [hash, chunk] : chunks) {
+      chunk.clear();
+    }
 
     auto oldChunkLength = chunkLength;
 
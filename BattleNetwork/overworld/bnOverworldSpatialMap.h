@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bnOverworldActor.h"
+#include "../bnFrameArena.h"
 
 #include <memory>
 #include <vector>
@@ -17,14 +18,17 @@ namespace Overworld {
     // automatically handled by Overworld::SceneBase AddActor/RemoveActor
     void AddActor(const std::shared_ptr<Actor>& actor);
     void RemoveActor(const std::shared_ptr<Actor>& actor);
-    std::vector<std::shared_ptr<Actor>> GetChunk(float x, float y);
-    std::unordered_set<std::shared_ptr<Actor>> GetNeighbors(Actor& actor);
+    const std::vector<std::shared_ptr<Actor>>& GetChunk(float x, float y);
+
+    // result is backed by the frame arena and is only valid for this frame
+    FrameVector<Actor*> GetNeighbors(Actor& actor);
 
     void Update();
 
   private:
     std::unordered_set<std::shared_ptr<Actor>> actors;
     float chunkLength;
-    std::unordered_map<size_t, std::vector<std::shared_ptr<Actor>>> chunks;
+    std::unordered_map<size_t, std::vector<std::shared_ptr<Actor>>> chunks; /*!< chunks are emptied, not erased, so their capacity is reused every frame */
+    std::vector<std::shared_ptr<Actor>> emptyChunk;
   };
 }
@@ -77,6 +77,15 @@ static std::string URIDecode(std::string encodedName) {
   return decodedName.str();
 }
 
+static size_t TextureBytes(const sf::Texture& texture) {
+  sf::Vector2u size = texture.getSize();
+  return static_cast<size_t>(size.x) * size.y * 4u;
+}
+
+static size_t SoundBufferBytes(const sf::SoundBuffer& buffer) {
+  return static_cast<size_t>(buffer.getSampleCount()) * sizeof(sf::Int16);
+}
+
 static std::string encodeName(const std::string& name, uint64_t lastModified) {
   return std::to_string(lastModified) + "-" + Overworld::URIEncode(name);
 }
@@ -163,14 +172,15 @@ const std::unordered_map<std::string, Overworld::ServerAssetManager::CacheMeta>&
 }
 
 std::vector<char> Overworld::ServerAssetManager::LoadFromCache(const std::string& name) {
-  auto meta = cachedAssets[name];
-
   std::vector<char> data;
+  auto iter = cachedAssets.find(name);
 
-  if (meta.size == 0) {
+  if (iter == cachedAssets.end() || iter->second.size == 0) {
     return data;
   }
 
+  const CacheMeta& meta = iter->second;
+
   try {
     std::ifstream fin(meta.path, std::ios::binary);
     // prevents newlines from being skipped
@@ -208,56 +218,59 @@ void Overworld::ServerAssetManager::Preload(const std::string& name) {
 }
 
 void Overworld::ServerAssetManager::PreloadText(const std::string& name) {
-  if (textAssets.find(name) == textAssets.end()) {
-    auto data = LoadFromCache(name);
-    std::string text(data.data(), data.size());
-    textAssets[name] = text;
-  }
+  GetText(name);
 }
 
 void Overworld::ServerAssetManager::PreloadTexture(const std::string& name) {
-  if (textureAssets.find(name) == textureAssets.end()) {
-    auto data = LoadFromCache(name);
-    auto texture = std::make_shared<sf::Texture>();
-    texture->loadFromMemory(data.data(), data.size());
-    textureAssets[name] = texture;
-  }
+  GetTexture(name);
 }
 
 void Overworld::ServerAssetManager::PreloadAudio(const std::string& name) {
-  if (audioAssets.find(name) == audioAssets.end()) {
-    auto data = LoadFromCache(name);
-    auto audio = std::make_shared<sf::SoundBuffer>();
-    audio->loadFromMemory(data.data(), data.size());
-    audioAssets[name] = audio;
-  }
+  GetAudio(name);
 }
 
 std::string Overworld::ServerAssetManager::GetText(const std::string& name) {
-  PreloadText(name);
-  return textAssets[name];
+  if (auto text = textAssets.Find(name)) {
+    return *text;
+  }
+
+  auto data = LoadFromCache(name);
+  auto text = std::make_shared<std::string>(data.data(), data.size());
+  return *textAssets.Insert(name, text, text->size());
 }
 
 std::shared_ptr<sf::Texture> Overworld::ServerAssetManager::GetTexture(const std::string& name) {
-  PreloadTexture(name);
-  return textureAssets[name];
+  if (auto texture = textureAssets.Find(name)) {
+    return texture;
+  }
+
+  auto data = LoadFromCache(name);
+  auto texture = std::make_shared<sf::Texture>();
+  texture->loadFromMemory(data.data(), data.size());
+  return textureAssets.Insert(name, texture, TextureBytes(*texture));
 }
 
 std::shared_ptr<sf::SoundBuffer> Overworld::ServerAssetManager::GetAudio(const std::string& name) {
-  PreloadAudio(name);
-  return audioAssets[name];
+  if (auto audio = audioAssets.Find(name)) {
+    return audio;
+  }
+
+  auto data = LoadFromCache(name);
+  auto audio = std::make_shared<sf::SoundBuffer>();
+  audio->loadFromMemory(data.data(), data.size());
+  return audioAssets.Insert(name, audio, SoundBufferBytes(*audio));
 }
 
 std::vector<char> Overworld::ServerAssetManager::GetData(const std::string& name) {
-  if (textAssets.find(name) == textAssets.end()) {
-    // load from storage but don't cache in memory
-    return LoadFromCache(name);
+  if (auto data = dataAssets.Find(name)) {
+    return *data;
   }
 
-  return dataAssets[name];
+  // load from storage but don't cache in memory
+  return LoadFromCache(name);
 }
 
-void Overworld::ServerAssetManager::CacheAsset(const std::string& name, uint64_t lastModified, const char* data, size_t size) {
+bool Overworld::ServerAssetManager::CacheAsset(const std::string& name, uint64_t lastModified, const char* data, size_t size) {
   auto path = cachePrefix + encodeName(name, lastModified);
 
   std::ofstream fout;
@@ -265,7 +278,7 @@ void Overworld::ServerAssetManager::CacheAsset(const std::string& name, uint64_t
 
   if (!fout.is_open()) {
     Logger::Logf(LogLevel::critical, "Failed to cache server asset to file: %s", path.c_str());
-    return;
+    return false;
   }
 
   fout.write(data, size);
@@ -278,49 +291,39 @@ void Overworld::ServerAssetManager::CacheAsset(const std::string& name, uint64_t
   };
 
   cachedAssets[name] = meta;
+  return true;
 }
 
 void Overworld::ServerAssetManager::SetText(const std::string& name, uint64_t lastModified, const std::string& data, bool cache) {
-  if (cache) {
-    CacheAsset(name, lastModified, data.c_str(), data.size());
-  }
+  bool onDisk = cache && CacheAsset(name, lastModified, data.c_str(), data.size());
 
-  textAssets.erase(name);
-  textAssets.emplace(name, data);
+  textAssets.Replace(name, std::make_shared<std::string>(data), data.size(), !onDisk);
 }
 
 void Overworld::ServerAssetManager::SetTexture(const std::string& name, uint64_t lastModified, const char* data, size_t length, bool cache) {
-  if (cache) {
-    CacheAsset(name, lastModified, data, length);
-  }
+  bool onDisk = cache && CacheAsset(name, lastModified, data, length);
 
   auto texture = std::make_shared<sf::Texture>();
   texture->loadFromMemory(data, length);
 
-  textureAssets.erase(name);
-  textureAssets.emplace(name, texture);
+  textureAssets.Replace(name, texture, TextureBytes(*texture), !onDisk);
 }
 
 void Overworld::ServerAssetManager::SetAudio(const std::string& name, uint64_t lastModified, const char* data, size_t length, bool cache) {
-  if (cache) {
-    CacheAsset(name, lastModified, data, length);
-  }
+  bool onDisk = cache && CacheAsset(name, lastModified, data, length);
 
   auto audio = std::make_shared<sf::SoundBuffer>();
   audio->loadFromMemory(data, length);
 
-  audioAssets.erase(name);
-  audioAssets.emplace(name, audio);
+  audioAssets.Replace(name, audio, SoundBufferBytes(*audio), !onDisk);
 }
 
 void Overworld::ServerAssetManager::SetData(const std::string& name, uint64_t lastModified, const char* data, size_t length, bool cache) {
-  dataAssets.erase(name);
+  dataAssets.Erase(name);
 
-  if (cache) {
-    CacheAsset(name, lastModified, data, length);
-  } else {
-    // only store in memory if it's not saved to disk
-    dataAssets.emplace(name, std::vector(data, data + length));
+  // only store in memory if it's not saved to disk
+  if (!(cache && CacheAsset(name, lastModified, data, length))) {
+    dataAssets.Replace(name, std::make_shared<std::vector<char>>(data, data + length), length, true);
   }
 }
 
@@ -337,4 +340,17 @@ void Overworld::ServerAssetManager::RemoveAsset(const std::string& name) {
   #endif
   
   cachedAssets.erase(name);
+
+  // the disk copy was the only way to reload these after eviction
+  textAssets.SetPermanent(name, true);
+  textureAssets.SetPermanent(name, true);
+  audioAssets.SetPermanent(name, true);
+}
+
+const ResourceCacheStats Overworld::ServerAssetManager::GetCacheStats() const {
+  ResourceCacheStats stats = textAssets.GetStats();
+  stats += textureAssets.GetStats();
+  stats += audioAssets.GetStats();
+  stats += dataAssets.GetStats();
+  return stats;
 }
@@ -4,6 +4,9 @@
 #include <SFML/Audio/SoundBuffer.hpp>
 #include <Poco/Buffer.h>
 #include <memory>
+#include <vector>
+
+#include "../bnResourceCache.h"
 #include <unordered_map>
 
 namespace Overworld {
@@ -17,17 +20,27 @@ namespace Overworld {
       size_t size{};
     };
 
-    std::unordered_map<std::string, std::string> textAssets;
-    std::unordered_map<std::string, std::shared_ptr<sf::Texture>> textureAssets;
-    std::unordered_map<std::string, std::shared_ptr<sf::SoundBuffer>> audioAssets;
-    std::unordered_map<std::string, std::vector<char>> dataAssets;
+    // eviction only drops the in-memory copy, the disk cache and cachedAssets are left alone
+    // assets that only exist in memory are kept permanently, the rest can be read from the disk cache again
+    ResourceCache<std::string> textAssets{ TEXT_CACHE_BUDGET };
+    ResourceCache<sf::Texture> textureAssets{ TEXTURE_CACHE_BUDGET };
+    ResourceCache<sf::SoundBuffer> audioAssets{ AUDIO_CACHE_BUDGET };
+    ResourceCache<std::vector<char>> dataAssets{ DATA_CACHE_BUDGET };
     std::string cachePath;
     std::string cachePrefix;
     std::unordered_map<std::string, CacheMeta> cachedAssets;
 
-    void CacheAsset(const std::string& name, uint64_t lastModified, const char* data, size_t size);
+    /**
+     * @return false if the asset could not be written to disk
+     */
+    bool CacheAsset(const std::string& name, uint64_t lastModified, const char* data, size_t size);
     std::vector<char> LoadFromCache(const std::string& name);
   public:
+    static constexpr size_t TEXT_CACHE_BUDGET = 8u * 1024u * 1024u;
+    static constexpr size_t TEXTURE_CACHE_BUDGET = 128u * 1024u * 1024u;
+    static constexpr size_t AUDIO_CACHE_BUDGET = 64u * 1024u * 1024u;
+    static constexpr size_t DATA_CACHE_BUDGET = 16u * 1024u * 1024u;
+
     ServerAssetManager(const std::string& host, uint16_t port);
 
     std::string GetPath(const std::string& name);
@@ -47,6 +60,17 @@ namespace Overworld {
     void SetTexture(const std::string& name, uint64_t lastModified, const char* data, size_t length, bool cache);
     void SetAudio(const std::string& name, uint64_t lastModified, const char* data, size_t length, bool cache);
     void SetData(const std::string& name, uint64_t lastModified, const char* data, size_t length, bool cache);
+
+    /**
+     * @brief Deletes the disk copy of an asset
+     *
+     * The copy already in memory is kept for this session and can no longer be evicted
+     */
     void RemoveAsset(const std::string& name);
+
+    /**
+     * @brief Hit, miss and eviction counts of every in-memory asset cache combined
+     */
+    const ResourceCacheStats GetCacheStats() const;
   };
 }
@@ -14,25 +14,48 @@ namespace stx {
     }
   }
 
+  static result_t<std::string> generate_md5_from_buffer(const char* data, size_t len) {
+    char md5Buffer[16];
+    xMD5Context context;
+    xMD5Init(&context);
+    xMD5Update(&context, reinterpret_cast<const byte*>(data), len);
+    xMD5Final(reinterpret_cast<byte*>(md5Buffer), &context);
+
+    return ok(stx::as_hex(std::string(md5Buffer, sizeof(md5Buffer)), 0));
+  }
+
+  /**
+  * @brief hashes a file in fixed-size chunks so large files are never held in memory
+  */
   static result_t<std::string> generate_md5_from_file(const std::string& path) {
-    std::vector<char> fileBuffer, md5Buffer;
-    md5Buffer.resize(16);
-    size_t len{};
+    constexpr size_t CHUNK_SIZE = 64 * 1024;
 
-    std::ifstream fs(path, std::ios::binary | std::ios::ate);
+    std::ifstream fs(path, std::ios::binary);
 
     if (!fs.good()) {
       return error<std::string>("Unabled to read file " + path);
     }
 
-    std::ifstream::pos_type pos = fs.tellg();
-    len = pos;
-    fileBuffer.resize(len);
-    fs.seekg(0, std::ios::beg);
-    fs.read(&fileBuffer[0], pos);
+    std::vector<char> chunk(CHUNK_SIZE);
+    char md5Buffer[16];
+    xMD5Context context;
+    xMD5Init(&context);
+
+    while (fs) {
+      fs.read(chunk.data(), chunk.size());
+      std::streamsize read = fs.gcount();
+
+      if (read > 0) {
+        xMD5Update(&context, reinterpret_cast<byte*>(chunk.data()), static_cast<size_t>(read));
+      }
+    }
+
+    if (fs.bad()) {
+      return error<std::string>("Unabled to read file " + path);
+    }
 
-    MD5(&md5Buffer[0], &fileBuffer[0], len);
+    xMD5Final(reinterpret_cast<byte*>(md5Buffer), &context);
 
-    return ok(stx::as_hex(std::string(md5Buffer.data(), md5Buffer.size()), 0));
+    return ok(stx::as_hex(std::string(md5Buffer, sizeof(md5Buffer)), 0));
   }
 }
\ No newline at end of file
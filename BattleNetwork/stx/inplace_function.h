@@ -0,0 +1,208 @@
+#pragma once
+/*
+* std::function replacement that keeps its target inside the object
+*
+* Targets up to Capacity bytes are stored in place and never allocate.
+* Larger targets still work but are moved to the heap. Those are counted by
+* inplace_function_spills() so oversized captures on hot paths can be found.
+*/
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace stx {
+  constexpr size_t inplace_function_default_capacity = 64;
+
+  namespace detail {
+    inline std::atomic<size_t>& inplace_function_spill_counter() {
+      static std::atomic<size_t> counter{ 0 };
+      return counter;
+    }
+  }
+
+  /**
+   * @brief Number of inplace_function targets that were too large to be stored in place
+   */
+  inline size_t inplace_function_spills() {
+    return detail::inplace_function_spill_counter().load(std::memory_order_relaxed);
+  }
+
+  template<typename Signature, size_t Capacity = inplace_function_default_capacity>
+  class inplace_function;
+
+  template<typename R, typename... Args, size_t Capacity>
+  class inplace_function<R(Args...), Capacity> {
+    struct vtable_t {
+      R(*invoke)(void* storage, Args&&... args);
+      void(*copy)(void* dst, const void* src);
+      void(*move)(void* dst, void* src) noexcept;
+      void(*destroy)(void* storage) noexcept;
+    };
+
+    template<typename F>
+    static constexpr bool fits_inline =
+      sizeof(F) <= Capacity &&
+      alignof(std::max_align_t) % alignof(F) == 0 &&
+      std::is_nothrow_move_constructible_v<F>;
+
+    template<typename F>
+    static const vtable_t* inline_vtable() {
+      static const vtable_t vtable{
+        [](void* storage, Args&&... args) -> R {
+          return std::invoke(*static_cast<F*>(storage), std::forward<Args>(args)...);
+        },
+        [](void* dst, const void* src) {
+          ::new (dst) F(*static_cast<const F*>(src));
+        },
+        [](void* dst, void* src) noexcept {
+          ::new (dst) F(std::move(*static_cast<F*>(src)));
+          static_cast<F*>(src)->~F();
+        },
+        [](void* storage) noexcept {
+          static_cast<F*>(storage)->~F();
+        }
+      };
+
+      return &vtable;
+    }
+
+    template<typename F>
+    static const vtable_t* heap_vtable() {
+      static const vtable_t vtable{
+        [](void* storage, Args&&... args) -> R {
+          return std::invoke(**static_cast<F**>(storage), std::forward<Args>(args)...);
+        },
+        [](void* dst, const void* src) {
+          detail::inplace_function_spill_counter().fetch_add(1, std::memory_order_relaxed);
+          ::new (dst) F*(new F(**static_cast<F* const*>(src)));
+        },
+        [](void* dst, void* src) noexcept {
+          ::new (dst) F*(*static_cast<F**>(src));
+        },
+        [](void* storage) noexcept {
+          delete *static_cast<F**>(storage);
+        }
+      };
+
+      return &vtable;
+    }
+
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    const vtable_t* vtable{ nullptr };
+
+  public:
+    inplace_function() noexcept = default;
+    inplace_function(std::nullptr_t) noexcept {}
+
+    template<typename F, typename = std::enable_if_t<
+      !std::is_same_v<std::decay_t<F>, inplace_function> &&
+      !std::is_same_v<std::decay_t<F>, std::nullptr_t> &&
+      std::is_invocable_r_v<R, std::decay_t<F>&, Args...>
+    >>
+    inplace_function(F&& f) {
+      using T = std::decay_t<F>;
+
+      // empty function pointers and std::functions stay empty like they would in a std::function
+      if constexpr (std::is_pointer_v<T> || std::is_member_pointer_v<T>) {
+        if (!f) return;
+      }
+      else if constexpr (std::is_same_v<T, std::function<R(Args...)>>) {
+        if (!f) return;
+      }
+
+      if constexpr (fits_inline<T>) {
+        ::new (static_cast<void*>(storage)) T(std::forward<F>(f));
+        vtable = inline_vtable<T>();
+      }
+      else {
+        detail::inplace_function_spill_counter().fetch_add(1, std::memory_order_relaxed);
+        ::new (static_cast<void*>(storage)) T*(new T(std::forward<F>(f)));
+        vtable = heap_vtable<T>();
+      }
+    }
+
+    inplace_function(const inplace_function& other) {
+      if (other.vtable) {
+        other.vtable->copy(storage, other.storage);
+        vtable = other.vtable;
+      }
+    }
+
+    inplace_function(inplace_function&& other) noexcept {
+      if (other.vtable) {
+        other.vtable->move(storage, other.storage);
+        vtable = other.vtable;
+        other.vtable = nullptr;
+      }
+    }
+
+    ~inplace_function() {
+      reset();
+    }
+
+    inplace_function& operator=(const inplace_function& other) {
+      if (this != &other) {
+        inplace_function copy(other);
+        *this = std::move(copy);
+      }
+
+      return *this;
+    }
+
+    inplace_function& operator=(inplace_function&& other) noexcept {
+      if (this != &other) {
+        reset();
+
+        if (other.vtable) {
+          other.vtable->move(storage, other.storage);
+          vtable = other.vtable;
+          other.vtable = nullptr;
+        }
+      }
+
+      return *this;
+    }
+
+    inplace_function& operator=(std::nullptr_t) noexcept {
+      reset();
+      return *this;
+    }
+
+    template<typename F, typename = std::enable_if_t<
+      !std::is_same_v<std::decay_t<F>, inplace_function> &&
+      !std::is_same_v<std::decay_t<F>, std::nullptr_t> &&
+      std::is_invocable_r_v<R, std::decay_t<F>&, Args...>
+    >>
+    inplace_function& operator=(F&& f) {
+      return *this = inplace_function(std::forward<F>(f));
+    }
+
+    R operator()(Args... args) const {
+      if (!vtable) {
+        throw std::bad_function_call();
+      }
+
+      return vtable->invoke(const_cast<unsigned char*>(storage), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept {
+      return vtable != nullptr;
+    }
+
+    friend bool operator==(const inplace_function& f, std::nullptr_t) noexcept { return !f; }
+    friend bool operator==(std::nullptr_t, const inplace_function& f) noexcept { return !f; }
+    friend bool operator!=(const inplace_function& f, std::nullptr_t) noexcept { return static_cast<bool>(f); }
+    friend bool operator!=(std::nullptr_t, const inplace_function& f) noexcept { return static_cast<bool>(f); }
+
+  private:
+    void reset() noexcept {
+      if (vtable) {
+        vtable->destroy(storage);
+        vtable = nullptr;
+      }
+    }
+  };
+}
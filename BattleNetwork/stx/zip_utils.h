@@ -1,81 +1,228 @@
 #pragma once
 #include <string>
 #include <fstream>
+#include <vector>
+#include <set>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 #include "result.h"
 #include "../zip/zip.h"
 
 // TODO: mac os < 10.5 file system support...
 #ifndef __APPLE__
 #include <filesystem>
-#endif 
+#endif
 
 /* STD LIBRARY extensions */
 namespace stx {
 
   namespace detail {
-    static void zip_walk(struct zip_t* zip, const char* target_path, const char* parent_dir = "") {
-      for(const auto& entry : std::filesystem::directory_iterator(target_path)) {
-        std::string entry_path_string = entry.path().generic_string();
-        const char* entry_path = entry_path_string.c_str();
-        std::string filename = entry.path().filename().string();
+    constexpr size_t ZIP_CHUNK_SIZE = 64 * 1024;
+    constexpr unsigned UNZIP_MAX_THREADS = 4;
+    constexpr size_t UNZIP_FILES_PER_THREAD = 16;
+
+#ifndef __APPLE__
+    /**
+    * @brief streams one file into a new zip entry, one chunk at a time
+    */
+    static bool zip_write_file(struct zip_t* zip, const std::string& name, const std::filesystem::path& file) {
+      std::ifstream fs(file, std::ios::binary);
+
+      if (!fs.good() || zip_entry_open(zip, name.c_str()) != 0) {
+        return false;
+      }
+
+      // no timestamps or permissions so the archive only depends on the file contents
+      zip_entry_set_mtime(zip, 0);
+
+      std::vector<char> chunk(ZIP_CHUNK_SIZE);
+      bool written = true;
+
+      while (written && fs) {
+        fs.read(chunk.data(), chunk.size());
+        std::streamsize read = fs.gcount();
+
+        if (read > 0) {
+          written = zip_entry_write(zip, chunk.data(), static_cast<size_t>(read)) == 0;
+        }
+      }
+
+      written = written && !fs.bad();
+      return zip_entry_close(zip) == 0 && written;
+    }
+
+    /**
+    * @brief zips every file under target_path, sorted by path so the same files always produce the same archive
+    */
+    static result_t<bool> zip_walk(struct zip_t* zip, const char* target_path) {
+      std::vector<std::pair<std::string, std::filesystem::path>> files;
+      std::error_code ec;
+      std::filesystem::recursive_directory_iterator iter(target_path, ec), end;
+
+      for (; !ec && iter != end; iter.increment(ec)) {
+        if (!iter->is_regular_file(ec)) continue;
+
+        files.emplace_back(iter->path().lexically_relative(target_path).generic_string(), iter->path());
+      }
+
+      if (ec) {
+        return error<bool>(std::string("Unable to read ") + target_path + ": " + ec.message());
+      }
+
+      std::sort(files.begin(), files.end());
+
+      for (auto& [name, file] : files) {
+        if (!zip_write_file(zip, name, file)) {
+          return error<bool>("Unable to zip " + file.generic_string());
+        }
+      }
+
+      return ok();
+    }
+
+    /**
+    * @brief resolves an entry name inside destination_path
+    * @return empty path if the entry would be written outside of destination_path
+    */
+    static std::filesystem::path unzip_entry_path(const std::filesystem::path& destination_path, const std::string& name) {
+      std::filesystem::path relative = std::filesystem::path(name).lexically_normal();
+
+      if (relative.empty() || relative.has_root_path() || *relative.begin() == "..") {
+        return {};
+      }
+
+      return destination_path / relative;
+    }
+
+    /**
+    * @brief extracts every entry of the zip at target_path
+    *
+    * Folders are created once up front. Files are then spread over a few threads,
+    * each reading the archive through its own handle.
+    */
+    static result_t<bool> unzip_walk(const char* target_path, const std::filesystem::path& destination_path) {
+      std::vector<std::pair<int, std::filesystem::path>> files;
+      std::set<std::filesystem::path> folders;
+
+      struct zip_t* zip = zip_open(target_path, 0, 'r');
+
+      if (!zip) {
+        return error<bool>(std::string("Unable to open ") + target_path);
+      }
+
+      int n = static_cast<int>(zip_entries_total(zip));
 
-        std::string parent = std::string(parent_dir);
+      for (int i = 0; i < n; ++i) {
+        if (zip_entry_openbyindex(zip, i) != 0) continue;
 
-        if (parent.size()) {
-          filename = parent + "/" + filename;
+        const char* entry_name = zip_entry_name(zip);
+        std::string name = entry_name ? entry_name : "";
+        bool isdir = zip_entry_isdir(zip) == 1;
+        std::filesystem::path path = unzip_entry_path(destination_path, name);
+
+        zip_entry_close(zip);
+
+        if (path.empty()) {
+          zip_close(zip);
+          return error<bool>("Unsafe entry " + name + " in " + target_path);
         }
 
-        if (entry.is_directory()) {
-          zip_walk(zip, entry_path, filename.c_str());
+        if (isdir) {
+          folders.insert(path);
         }
         else {
-          zip_entry_open(zip, filename.c_str());
-          zip_entry_fwrite(zip, entry_path);
-          zip_entry_close(zip);
+          folders.insert(path.parent_path());
+          files.emplace_back(i, path);
         }
       }
-    }
 
-    static void unzip_walk(struct zip_t* zip, const char* target_path) {
-      int i, n = static_cast<int>(zip_entries_total(zip));
-      for (i = 0; i < n; ++i) {
-        zip_entry_openbyindex(zip, i);
-        {
-          const char* name = zip_entry_name(zip);
-          int isdir = zip_entry_isdir(zip);
-
-          if (isdir) {
-            std::string next_path = std::string(target_path) + name + "\\";
-            std::filesystem::create_directory(std::filesystem::path(next_path));
-            unzip_walk(zip, target_path);
-          }
-          else {
-            std::string filename = std::string(target_path) + "\\" + name;
-            zip_entry_fread(zip, filename.c_str());
+      zip_close(zip);
+
+      std::error_code ec;
+      folders.insert(destination_path);
+
+      for (const std::filesystem::path& folder : folders) {
+        std::filesystem::create_directories(folder, ec);
+
+        if (ec) {
+          return error<bool>("Unable to create " + folder.generic_string() + ": " + ec.message());
+        }
+      }
+
+      unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+      threads = static_cast<unsigned>(std::min<size_t>({ threads, UNZIP_MAX_THREADS, files.size() / UNZIP_FILES_PER_THREAD + 1 }));
+
+      std::atomic<size_t> next{ 0 };
+      std::atomic<bool> failed{ false };
+
+      auto extract = [&] {
+        struct zip_t* reader = zip_open(target_path, 0, 'r');
+
+        if (!reader) {
+          failed = true;
+          return;
+        }
+
+        for (size_t i = next++; i < files.size() && !failed; i = next++) {
+          auto& [index, path] = files[i];
+
+          if (zip_entry_openbyindex(reader, index) != 0 || zip_entry_fread(reader, path.string().c_str()) != 0) {
+            failed = true;
           }
+
+          zip_entry_close(reader);
         }
-        zip_entry_close(zip);
+
+        zip_close(reader);
+      };
+
+      std::vector<std::thread> workers;
+
+      for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(extract);
+      }
+
+      extract();
+
+      for (std::thread& worker : workers) {
+        worker.join();
+      }
+
+      if (failed) {
+        return error<bool>(std::string("Unable to unzip ") + target_path);
       }
+
+      return ok();
     }
+#endif
   }
 
   static result_t<bool> zip(const std::string& target_path, const std::string& destination_path) {
 #ifndef __APPLE__
     struct zip_t* zip = zip_open(destination_path.c_str(), 9, 'w');
-    detail::zip_walk(zip, target_path.c_str());
-    zip_close(zip);
 
-    return ok();
+    if (!zip) {
+      return error<bool>(std::string("Unable to create ") + destination_path);
+    }
 
-#elif
+    result_t<bool> result = detail::zip_walk(zip, target_path.c_str());
+    zip_close(zip);
+
+    return result;
+#else
     return error<bool>("System filedirectory utils not supported on APPLE");
 #endif
   }
 
   static result_t<bool> unzip(const std::string& target_path, const std::string& destination_path) {
+#ifndef __APPLE__
+    return detail::unzip_walk(target_path.c_str(), std::filesystem::path(destination_path));
+#else
     if(zip_extract(target_path.c_str(), destination_path.c_str(), nullptr, nullptr) == 0)
       return ok();
 
     return error<bool>(std::string("Unable to unzip ") + target_path);
+#endif
   }
-}
\ No newline at end of file
+}
@@ -1126,7 +1126,12 @@ int zip_entry_close(struct zip_t *zip) {
   }
 
 #ifndef MINIZ_NO_TIME
-  mz_zip_time_t_to_dos_time(zip->entry.m_time, &dos_time, &dos_date);
+  if (zip->entry.m_time) {
+    mz_zip_time_t_to_dos_time(zip->entry.m_time, &dos_time, &dos_date);
+  } else {
+    // 1980-01-01 00:00, see zip_entry_set_mtime
+    dos_date = (mz_uint16)((1 << 5) + 1);
+  }
 #endif
 
   if (!mz_zip_writer_create_local_dir_header(
@@ -1246,6 +1251,16 @@ int zip_entry_write(struct zip_t *zip, const void *buf, size_t bufsize) {
   return 0;
 }
 
+int zip_entry_set_mtime(struct zip_t *zip, time_t mtime) {
+  if (!zip) {
+    // zip_t handler is not initialized
+    return ZIP_ENOINIT;
+  }
+
+  zip->entry.m_time = mtime;
+  return 0;
+}
+
 int zip_entry_fwrite(struct zip_t *zip, const char *filename) {
   int err = 0;
   size_t n = 0;
@@ -15,6 +15,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <sys/types.h>
+#include <time.h>
 
 #ifndef ZIP_SHARED
 #define ZIP_EXPORT
@@ -255,6 +256,20 @@ extern ZIP_EXPORT int zip_entry_write(struct zip_t *zip, const void *buf,
  */
 extern ZIP_EXPORT int zip_entry_fwrite(struct zip_t *zip, const char *filename);
 
+/**
+ * Sets the modification time recorded for the current zip entry.
+ *
+ * Entries opened for writing record the time they were opened. Passing 0
+ * records 1980-01-01 00:00 instead, which does not depend on the clock or
+ * the time zone, so the same files always produce the same archive.
+ *
+ * @param zip zip archive handler.
+ * @param mtime modification time, or 0.
+ *
+ * @return the return code - 0 on success, negative number (< 0) on error.
+ */
+extern ZIP_EXPORT int zip_entry_set_mtime(struct zip_t *zip, time_t mtime);
+
 /**
  * Extracts the current zip entry into output buffer.
  *
@@ -0,0 +1,158 @@
+/*! \brief Checks that a recycled pooled entity matches a newly built one
+ *
+ * Links the engine without bnResourceHandle.cpp so the resource handles can point at
+ * managers made here. No shaders are loaded, so entities are built without them.
+ */
+
+#include "bnEntityPool.h"
+#include "bnDefenseRule.h"
+#include "bnHitListener.h"
+#include "bnCounterHitListener.h"
+#include "bnResourceHandle.h"
+#include "bnTextureResourceManager.h"
+#include "bnShaderResourceManager.h"
+#include "bnTile.h"
+#include "bindings/bnScriptedSpell.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#define CHECK(expr) \
+  if (!(expr)) { \
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+    return EXIT_FAILURE; \
+  }
+
+namespace {
+  TextureResourceManager& TestTextures() {
+    static TextureResourceManager textures;
+    return textures;
+  }
+
+  ShaderResourceManager& TestShaders() {
+    static ShaderResourceManager shaders;
+    return shaders;
+  }
+
+  class TestDefenseRule : public DefenseRule {
+  public:
+    TestDefenseRule() : DefenseRule(Priority(1), DefenseOrder::always) {}
+    void CanBlock(DefenseFrameStateJudge&, std::shared_ptr<Entity>, std::shared_ptr<Entity>) override {}
+  };
+
+  class TestHitListener : public HitListener {
+  public:
+    int hits{};
+    void OnHit(Entity&, const Hit::Properties&) override { hits++; }
+  };
+
+  class TestCounterListener : public CounterHitListener {
+  public:
+    int counters{};
+    void OnCounter(Entity&, Entity&) override { counters++; }
+  };
+
+  bool SameProperties(const Hit::Properties& a, const Hit::Properties& b) {
+    return a.damage == b.damage && a.flags == b.flags && a.element == b.element && a.aggressor == b.aggressor;
+  }
+}
+
+// the handles are normally bound by Game
+TextureResourceManager* ResourceHandle::textures{ &TestTextures() };
+AudioResourceManager* ResourceHandle::audio{ nullptr };
+ShaderResourceManager* ResourceHandle::shaders{ &TestShaders() };
+
+#ifdef BN_MOD_SUPPORT
+ScriptResourceManager* ResourceHandle::scripts{ nullptr };
+#endif
+
+int main() {
+  EntityPool pool;
+  TestHitListener hitListener;
+  TestCounterListener counterListener;
+  auto defense = std::make_shared<TestDefenseRule>();
+  bool statusCalled = false;
+
+  std::shared_ptr<ScriptedSpell> spell = pool.Acquire<ScriptedSpell>(Team::blue);
+  const Entity* firstLife = spell.get();
+  Entity::ID_t firstID = spell->GetID();
+
+  // change everything a script or card can change
+  Hit::Properties props = Hit::DefaultProperties;
+  props.damage = 99;
+  props.flags |= Hit::flinch;
+  props.element = Element::fire;
+
+  spell->SetElement(Element::aqua);
+  spell->SetName("previous life");
+  spell->SetMaxHealth(50);
+  spell->SetHealth(40);
+  spell->SetHeight(12.f);
+  spell->SetElevation(3.f);
+  spell->SetHitboxProperties(props);
+  spell->EnableHitbox(false);
+  spell->SetPassthrough(true);
+  spell->SetFloatShoe(false);
+  spell->SetAirShoe(true);
+  spell->SlidesOnTiles(false);
+  spell->ShareTileSpace(false);
+  spell->EnableTilePush(true);
+  spell->ToggleCounter(true);
+  spell->IgnoreCommonAggressor(true);
+  spell->HighlightTile(Battle::TileHighlight::solid);
+  spell->SetLayer(7);
+  spell->AddDefenseRule(defense);
+  spell->RegisterStatusCallback(Hit::flinch, [&statusCalled] { statusCalled = true; });
+  hitListener.Subscribe(*spell);
+  counterListener.Subscribe(*spell);
+
+  spell.reset();
+  CHECK(pool.GetStats<ScriptedSpell>().available == 1);
+
+  std::shared_ptr<ScriptedSpell> recycled = pool.Acquire<ScriptedSpell>(Team::red);
+  std::shared_ptr<ScriptedSpell> fresh = std::make_shared<ScriptedSpell>(Team::red);
+
+  CHECK(recycled.get() == firstLife);
+  CHECK(pool.GetStats<ScriptedSpell>().reused == 1);
+  CHECK(recycled->GetID() != firstID);
+
+  CHECK(recycled->GetTeam() == fresh->GetTeam());
+  CHECK(recycled->GetElement() == fresh->GetElement());
+  CHECK(recycled->GetName() == fresh->GetName());
+  CHECK(recycled->GetHealth() == fresh->GetHealth());
+  CHECK(recycled->GetMaxHealth() == fresh->GetMaxHealth());
+  CHECK(recycled->GetHeight() == fresh->GetHeight());
+  CHECK(recycled->GetElevation() == fresh->GetElevation());
+  CHECK(SameProperties(recycled->GetHitboxProperties(), fresh->GetHitboxProperties()));
+  CHECK(recycled->IsHitboxAvailable() == fresh->IsHitboxAvailable());
+  CHECK(recycled->IsPassthrough() == fresh->IsPassthrough());
+  CHECK(recycled->HasFloatShoe() == fresh->HasFloatShoe());
+  CHECK(recycled->HasAirShoe() == fresh->HasAirShoe());
+  CHECK(recycled->WillSlideOnTiles() == fresh->WillSlideOnTiles());
+  CHECK(recycled->CanShareTileSpace() == fresh->CanShareTileSpace());
+  CHECK(recycled->CanTilePush() == fresh->CanTilePush());
+  CHECK(recycled->WillIgnoreCommonAggressor() == fresh->WillIgnoreCommonAggressor());
+  CHECK(recycled->GetTileHighlightMode() == fresh->GetTileHighlightMode());
+  CHECK(recycled->GetLayer() == fresh->GetLayer());
+  CHECK(recycled->getScale() == fresh->getScale());
+  CHECK(recycled->HasInit() == fresh->HasInit());
+  CHECK(recycled->HasSpawned() == fresh->HasSpawned());
+  CHECK(recycled->IsDeleted() == fresh->IsDeleted());
+
+  // a rule left from the previous life would be replaced by one with the same priority
+  recycled->AddDefenseRule(std::make_shared<TestDefenseRule>());
+  CHECK(!defense->IsReplaced());
+
+  // listeners of the previous life must not hear about the next one
+  static_cast<HitPublisher&>(*recycled).Broadcast(*recycled, props);
+  static_cast<CounterHitPublisher&>(*recycled).Broadcast(*recycled, *fresh);
+  CHECK(hitListener.hits == 0);
+  CHECK(counterListener.counters == 0);
+
+  // status callbacks only fire while resolving damage on a field, which this test does not build,
+  // and the counterable flag has no public query. Entity::ResetPooledState() clears both.
+  CHECK(!statusCalled);
+
+  std::printf("recycled entities match newly built ones\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+/*! \brief Checks that the texture cache never evicts a texture that a sprite still draws with
+ *
+ * Run from the BattleNetwork folder so the built-in resources can be found.
+ * Returns 77 (skipped) if textures cannot be created, e.g. without a display.
+ */
+
+#include "bnTextureResourceManager.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#define CHECK(expr) \
+  if (!(expr)) { \
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+    return EXIT_FAILURE; \
+  }
+
+namespace {
+  constexpr const char* SPRITE_PATH = "resources/ui/textbox_cursor.png";
+  constexpr const char* OTHER_PATH = "resources/scenes/cust/bg.png";
+  constexpr const char* EVICTABLE_PATH = "resources/scenes/cust/grid.png";
+  constexpr int SKIPPED = 77;
+}
+
+int main() {
+  TextureResourceManager textures;
+
+  // every new texture puts the cache over budget
+  textures.SetCacheBudget(1);
+
+  std::shared_ptr<sf::Texture> texture = textures.LoadFromFile(SPRITE_PATH);
+
+  if (texture->getSize().x == 0) {
+    std::fprintf(stderr, "could not create %s, skipping\n", SPRITE_PATH);
+    return SKIPPED;
+  }
+
+  // sf::Sprite only keeps a raw reference, like most of the engine's UI
+  sf::Sprite sprite(*texture);
+  const sf::Texture* raw = texture.get();
+  texture.reset();
+
+  textures.LoadFromFile(OTHER_PATH);
+  textures.HandleExpiredTextureCache();
+
+  CHECK(textures.GetCacheStats().evictions == 0);
+  CHECK(sprite.getTexture() == raw);
+  CHECK(textures.LoadFromFile(SPRITE_PATH).get() == raw);
+
+  // textures whose users keep the pointer can still be evicted once they are released
+  textures.LoadFromFile(EVICTABLE_PATH, true);
+  textures.HandleExpiredTextureCache();
+
+  CHECK(textures.GetCacheStats().evictions == 1);
+  CHECK(textures.LoadFromFile(SPRITE_PATH).get() == raw);
+
+  // a later non-evictable load pins the texture
+  std::shared_ptr<sf::Texture> pinned = textures.LoadFromFile(EVICTABLE_PATH, true);
+  textures.LoadFromFile(EVICTABLE_PATH);
+  const sf::Texture* pinnedRaw = pinned.get();
+  pinned.reset();
+  textures.HandleExpiredTextureCache();
+
+  CHECK(textures.GetCacheStats().evictions == 1);
+  CHECK(textures.LoadFromFile(EVICTABLE_PATH).get() == pinnedRaw);
+
+  std::printf("texture cache keeps textures drawn by sprites\n");
+  return EXIT_SUCCESS;
+}
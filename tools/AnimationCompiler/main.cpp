@@ -0,0 +1,113 @@
+// Converts text .animation files into the binary format read by AnimationCache
+// Usage: AnimationCompiler [--force] <file or folder>...
+
+#include "bnAnimation.h"
+#include "bnAnimationCache.h"
+#include "bnFileUtil.h"
+#include "cxxopts/cxxopts.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool IsAnimationFile(const fs::path& path) {
+  return path.extension() == ANIMATION_EXTENSION;
+}
+
+static bool IsUpToDate(const fs::path& source, const fs::path& output) {
+  std::error_code ec;
+
+  if (!fs::exists(output, ec)) return false;
+
+  return fs::last_write_time(output, ec) >= fs::last_write_time(source, ec);
+}
+
+static bool Compile(const fs::path& source, bool force, size_t& skipped) {
+  fs::path output = source;
+  output += ANIMATION_BINARY_SUFFIX;
+
+  if (!force && IsUpToDate(source, output)) {
+    skipped++;
+    return true;
+  }
+
+  const std::string sourceStr = source.generic_string();
+  std::shared_ptr<AnimationDocument> document = AnimationDocument::Parse(FileUtil::Read(sourceStr), sourceStr);
+  const std::string bytes = document->WriteBinary();
+
+  // make sure the engine can read back what we wrote before replacing anything
+  std::shared_ptr<AnimationDocument> check = AnimationDocument::ReadBinary(bytes, sourceStr);
+
+  if (!check || check->Size() != document->Size()) {
+    std::cerr << "failed to verify " << sourceStr << std::endl;
+    return false;
+  }
+
+  std::ofstream out(output, std::ios::binary | std::ios::trunc);
+
+  if (!out.write(bytes.data(), bytes.size())) {
+    std::cerr << "failed to write " << output.generic_string() << std::endl;
+    return false;
+  }
+
+  std::cout << sourceStr << " -> " << output.generic_string() << " (" << document->Size() << " states)" << std::endl;
+  return true;
+}
+
+int main(int argc, char** argv) {
+  cxxopts::Options options("AnimationCompiler", "Compiles .animation files into the binary animation format");
+
+  options.add_options()
+    ("f,force", "Recompile files that are already up to date")
+    ("h,help", "Print usage")
+    ("input", "Animation files or folders to search", cxxopts::value<std::vector<std::string>>());
+
+  options.parse_positional({ "input" });
+  options.positional_help("<file or folder>...");
+
+  cxxopts::ParseResult parsedOptions = options.parse(argc, argv);
+
+  if (parsedOptions.count("help") || !parsedOptions.count("input")) {
+    std::cout << options.help() << std::endl;
+    return parsedOptions.count("help") ? 0 : 1;
+  }
+
+  bool force = parsedOptions.count("force") > 0;
+  size_t compiled = 0, skipped = 0, failed = 0;
+
+  auto compileOne = [&](const fs::path& path) {
+    size_t before = skipped;
+
+    if (!Compile(path, force, skipped)) {
+      failed++;
+    }
+    else if (before == skipped) {
+      compiled++;
+    }
+  };
+
+  for (const std::string& input : parsedOptions["input"].as<std::vector<std::string>>()) {
+    std::error_code ec;
+
+    if (fs::is_directory(input, ec)) {
+      for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input, ec)) {
+        if (entry.is_regular_file(ec) && IsAnimationFile(entry.path())) {
+          compileOne(entry.path());
+        }
+      }
+    }
+    else if (fs::is_regular_file(input, ec)) {
+      compileOne(input);
+    }
+    else {
+      std::cerr << "cannot find " << input << std::endl;
+      failed++;
+    }
+  }
+
+  std::cout << compiled << " compiled, " << skipped << " up to date, " << failed << " failed" << std::endl;
+  return failed > 0 ? 1 : 0;
+}